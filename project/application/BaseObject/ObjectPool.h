@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+
+/// <summary>
+/// 弾や罠など、出したり消したりを繰り返すオブジェクトの使い回し
+/// 最初に上限の数だけ初期化しておき、消えたものは判定を切って空きに戻す
+/// Tには Initialize / Finalize / Activate / Deactivate が必要
+/// </summary>
+template <class T>
+class ObjectPool
+{
+public:
+
+	/// <summary>
+	/// 初期化(上限の数だけ作って初期化し、すべて空きにする)
+	/// </summary>
+	/// <param name="capacity">上限の数</param>
+	void Initialize(size_t capacity)
+	{
+		objects_.reserve(capacity);
+		activeObjects_.reserve(capacity);
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			auto object = std::make_unique<T>();
+			object->Initialize();
+			object->Deactivate();
+			freeObjects_.push_back(object.get());
+			objects_.push_back(std::move(object));
+		}
+	}
+
+	/// <summary>
+	/// 終了(すべてのオブジェクトを終了して捨てる)
+	/// </summary>
+	void Finalize()
+	{
+		for (auto& object : objects_)
+		{
+			object->Finalize();
+		}
+		activeObjects_.clear();
+		freeObjects_.clear();
+		objects_.clear();
+	}
+
+	/// <summary>
+	/// 空きから1つ取り出して使用中にする
+	/// 消えたばかりのものをすぐ使わないよう、空きに戻した順に取り出す
+	/// </summary>
+	/// <returns>取り出したオブジェクト(上限に達していればnullptr)</returns>
+	T* Acquire()
+	{
+		if (freeObjects_.empty())
+		{
+			return nullptr;
+		}
+		T* object = freeObjects_.front();
+		freeObjects_.pop_front();
+		object->Activate();
+		activeObjects_.push_back(object);
+		return object;
+	}
+
+	/// <summary>
+	/// 条件に合う使用中のオブジェクトを空きに戻す(残りの並び順は変えない)
+	/// </summary>
+	/// <param name="_pred">戻すかどうか(空きに戻す前に呼ばれる)</param>
+	template <class Pred>
+	void ReleaseIf(Pred _pred)
+	{
+		size_t count = 0;
+		for (T* object : activeObjects_)
+		{
+			if (_pred(*object))
+			{
+				object->Deactivate();
+				freeObjects_.push_back(object);
+			}
+			else
+			{
+				activeObjects_[count++] = object;
+			}
+		}
+		activeObjects_.resize(count);
+	}
+
+	/// <summary>
+	/// 指定した使用中のオブジェクトを空きに戻す
+	/// </summary>
+	/// <param name="_object">戻すオブジェクト</param>
+	void Release(T* _object)
+	{
+		ReleaseIf([_object](T& object) { return &object == _object; });
+	}
+
+	/// <summary>
+	/// 使用中のオブジェクトをすべて空きに戻す
+	/// </summary>
+	void ReleaseAll()
+	{
+		ReleaseIf([](T&) { return true; });
+	}
+
+public: // ゲッター
+
+	// 使用中のオブジェクト(取り出した順)
+	const std::vector<T*>& GetActiveObjects() const { return activeObjects_; }
+
+	// 上限の数
+	size_t GetCapacity() const { return objects_.size(); }
+
+private:
+
+	// 作ったすべてのオブジェクト
+	std::vector<std::unique_ptr<T>> objects_;
+	// 使用中のオブジェクト
+	std::vector<T*> activeObjects_;
+	// 空きのオブジェクト(空きに戻した順)
+	std::deque<T*> freeObjects_;
+};
@@ -38,6 +38,23 @@ void EnemyBullet::Finalize()
 	colliderManager_->DeleteCollider(&collider_);
 }
 
+void EnemyBullet::Activate()
+{
+	rotation_ = {};
+	scale_ = { 0.7f,0.7f,0.7f };
+	velocity_ = {};
+	aabb_ = {};
+	isDead_ = false;
+	deathRemainingSeconds_ = kLifeTime / kDefaultFrameRate;
+
+	collider_.SetEnable(true);
+}
+
+void EnemyBullet::Deactivate()
+{
+	collider_.SetEnable(false);
+}
+
 void EnemyBullet::Update()
 {
 	const float dt = TimeManager::Instance().GetDeltaTime();
@@ -66,7 +83,7 @@ void EnemyBullet::Update()
 
 void EnemyBullet::Draw()
 {
-	object_->Draw();
+	object_->DrawInstanced();
 }
 
 void EnemyBullet::Draw2D()
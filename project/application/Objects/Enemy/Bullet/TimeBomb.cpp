@@ -64,6 +64,35 @@ void TimeBomb::Finalize()
 	colliderManager_->DeleteCollider(&explosionCollider_);
 }
 
+void TimeBomb::Activate()
+{
+	rotation_ = {};
+	scale_ = { 0.7f, 0.7f, 0.7f };
+	velocity_ = {};
+	setAABB_ = {};
+	explosionAABB_ = {};
+	isDead_ = false;
+	isActive_ = false;
+	isExploded_ = false;
+	elapsedTime = 0.0f;
+	isWallCollision_ = false;
+	wallCollisionCooldown_ = 0;
+	isLaunchingTrap_ = false;
+
+	// 消滅時の動作初期化
+	deathMotion_.isActive = false;
+	deathMotion_.timer = 0.0f;
+
+	setCollider_.SetEnable(true);
+	explosionCollider_.SetEnable(true);
+}
+
+void TimeBomb::Deactivate()
+{
+	setCollider_.SetEnable(false);
+	explosionCollider_.SetEnable(false);
+}
+
 void TimeBomb::Update()
 {
 	// デルタタイム取得
@@ -21,6 +21,16 @@ public:
 
 	// 終了
 	void Finalize() override;
+	
+	/// <summary>
+	/// 使用開始(プールから取り出した時に状態を戻して判定を付ける)
+	/// </summary>
+	void Activate();
+
+	/// <summary>
+	/// 使用終了(プールに戻す時に判定を切る)
+	/// </summary>
+	void Deactivate();
 
 	// 更新
 	void Update() override;
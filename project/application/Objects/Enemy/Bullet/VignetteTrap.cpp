@@ -47,6 +47,30 @@ void VignetteTrap::Finalize()
 	colliderManager_->DeleteCollider(&collider_);
 }
 
+void VignetteTrap::Activate()
+{
+	rotation_ = {};
+	scale_ = { 0.7f,0.7f,0.7f };
+	velocity_ = {};
+	aabb_ = {};
+	isDead_ = false;
+	isActive_ = false;
+	isWallCollision_ = false;
+	wallCollisionCooldown_ = 0;
+	isLaunchingTrap_ = false;
+
+	// 消滅時の動作初期化
+	deathMotion_.isActive = false;
+	deathMotion_.timer = 0.0f;
+
+	collider_.SetEnable(true);
+}
+
+void VignetteTrap::Deactivate()
+{
+	collider_.SetEnable(false);
+}
+
 void VignetteTrap::Update()
 {
 	// デルタイム取得
@@ -32,6 +32,11 @@ void EnemyManager::Finalize()
 	{
 		corruptor->Finalize();
 	}
+
+	// 弾と罠(罠は上でトラップ敵が全て戻している)
+	bulletPool_.Finalize();
+	timeBombPool_.Finalize();
+	vignetteTrapPool_.Finalize();
 }
 
 void EnemyManager::Update()
@@ -131,6 +136,9 @@ void EnemyManager::Update()
 		pCorruptors_.end()
 	);
 
+	// 弾と罠の更新
+	UpdateProjectiles();
+
 	// ウェーブステートの更新
 	pState_->Update();
 	
@@ -168,6 +176,7 @@ void EnemyManager::Draw()
 		corruptor->Draw();
 	}
 
+	DrawProjectiles();
 }
 
 void EnemyManager::ImGuiDraw()
@@ -184,6 +193,11 @@ void EnemyManager::ImGuiDraw()
 		enemy->ImGuiDraw();
 	}
 
+	for (EnemyBullet* bullet : bulletPool_.GetActiveObjects())
+	{
+		bullet->ImGuiDraw();
+	}
+
 #endif // USE_IMGUI
 }
 
@@ -252,6 +266,9 @@ void EnemyManager::TitleEnemyUpdate()
 		pTrapEnemies_.end()
 	);
 
+	// 弾と罠の更新
+	UpdateProjectiles();
+
 	// 敵が全て倒されたらもう一度出現
 	if (enemyCount_ == 0)
 	{
@@ -295,6 +312,9 @@ void EnemyManager::GameOverEnemyUpdate()
 		pNormalEnemies_.end()
 	);
 
+	// 弾の更新
+	UpdateProjectiles();
+
 	// 敵が全て倒されたらもう一度出現
 	if (enemyCount_ == 0)
 	{
@@ -304,9 +324,12 @@ void EnemyManager::GameOverEnemyUpdate()
 
 void EnemyManager::NormalEnemyInit(const Vector3& pos)
 {
+	InitializePools();
+
 	// ノーマルエネミー
 	std::unique_ptr<NormalEnemy> enemy = std::make_unique<NormalEnemy>();
 	enemy->SetPosition(pos);
+	enemy->SetBulletPool(&bulletPool_);
 	enemy->Initialize();
 	enemy->SetPlayerPosition(playerPosition_);
 	enemy->Update();
@@ -320,9 +343,12 @@ void EnemyManager::NormalEnemyInit(const Vector3& pos)
 
 void EnemyManager::TrapEnemyInit(const Vector3& pos)
 {
+	InitializePools();
+
 	// トラップエネミー
 	std::unique_ptr<TrapEnemy> trapEnemy = std::make_unique<TrapEnemy>();
 	trapEnemy->SetPosition(pos);
+	trapEnemy->SetTrapPools(&timeBombPool_, &vignetteTrapPool_);
 	trapEnemy->Initialize();
 	trapEnemy->SetPlayerPosition(playerPosition_);
 	trapEnemy->Update();
@@ -355,3 +381,54 @@ void EnemyManager::ChangeState(std::unique_ptr<EnemyWaveState> _pState)
 	pState_ = std::move(_pState);
 	pState_->Initialize();
 }
+
+void EnemyManager::InitializePools()
+{
+	// 弾や罠を出すたびに作らないよう、最初の敵を出す時に上限の数だけ作っておく
+	if (bulletPool_.GetCapacity() > 0)
+	{
+		return;
+	}
+	bulletPool_.Initialize(kMaxBulletCount_);
+	timeBombPool_.Initialize(kMaxTrapCount_);
+	vignetteTrapPool_.Initialize(kMaxTrapCount_);
+}
+
+void EnemyManager::UpdateProjectiles()
+{
+	// 消えた弾をプールに戻す(撃った敵が倒れていても寿命までは飛ぶ)
+	bulletPool_.ReleaseIf([](EnemyBullet& bullet) { return bullet.IsDead(); });
+
+	for (EnemyBullet* bullet : bulletPool_.GetActiveObjects())
+	{
+		bullet->Update();
+	}
+
+	for (TimeBomb* trap : timeBombPool_.GetActiveObjects())
+	{
+		trap->Update();
+	}
+
+	for (VignetteTrap* trap : vignetteTrapPool_.GetActiveObjects())
+	{
+		trap->Update();
+	}
+}
+
+void EnemyManager::DrawProjectiles()
+{
+	for (EnemyBullet* bullet : bulletPool_.GetActiveObjects())
+	{
+		bullet->Draw();
+	}
+
+	for (TimeBomb* trap : timeBombPool_.GetActiveObjects())
+	{
+		trap->Draw();
+	}
+
+	for (VignetteTrap* trap : vignetteTrapPool_.GetActiveObjects())
+	{
+		trap->Draw();
+	}
+}
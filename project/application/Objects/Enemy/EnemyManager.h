@@ -103,6 +103,17 @@ public: // セッター
 	/// <param name="_levelData">レベルデータローダー</param>
 	void SetLevelData(std::shared_ptr<LevelData> _levelData) { levelData_ = _levelData; }
 
+private:
+
+	// 弾と罠のプールを作る(作成済みなら何もしない)
+	void InitializePools();
+
+	// 弾と罠の更新(消えた弾はプールに戻す。罠は置いた敵が戻す)
+	void UpdateProjectiles();
+
+	// 弾と罠の描画
+	void DrawProjectiles();
+
 private:
 
 	// エネミー
@@ -112,6 +123,17 @@ private:
 	// コラプター
 	std::vector<std::unique_ptr<Corruptor>> pCorruptors_;
 
+	// 敵の弾(全ての通常敵で共有する)
+	ObjectPool<EnemyBullet> bulletPool_;
+	// 同時に出せる弾の数(24発の攻撃が寿命3秒の間に4回分)
+	static constexpr size_t kMaxBulletCount_ = 96;
+
+	// 罠(全てのトラップ敵で共有する)
+	ObjectPool<TimeBomb> timeBombPool_;
+	ObjectPool<VignetteTrap> vignetteTrapPool_;
+	// 同時に置ける罠の数(種類ごと。罠は寿命が無いので、上限に達したら消えるまで置かない)
+	static constexpr size_t kMaxTrapCount_ = 24;
+
 	// 敵の数
 	uint32_t enemyCount_ = 0;
 
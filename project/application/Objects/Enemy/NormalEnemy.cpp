@@ -63,25 +63,6 @@ void NormalEnemy::Initialize()
 
 void NormalEnemy::Finalize()
 {
-	for (auto& bullet : pBullets_)
-	{
-		bullet->SetIsDead(true);
-		bullet->Finalize();
-	}
-
-    pBullets_.erase(
-        std::remove_if(pBullets_.begin(), pBullets_.end(), [](std::unique_ptr<EnemyBullet>& bullet)
-            {
-                if (bullet->IsDead())
-                {
-                    bullet->Finalize();
-                    return true;
-                }
-                return false;
-            }),
-        pBullets_.end()
-    );
-
     colliderManager_->DeleteCollider(&collider_);
 }
 
@@ -104,26 +85,6 @@ void NormalEnemy::Update()
 		isFarFromPlayer_ = false;
 	}
 
-	// 敵の弾の削除
-    pBullets_.erase(
-        std::remove_if(pBullets_.begin(), pBullets_.end(), [](std::unique_ptr<EnemyBullet>& bullet)
-            {
-                if (bullet->IsDead())
-                {
-                    bullet->Finalize();
-                    return true;
-                }
-                return false;
-            }),
-        pBullets_.end()
-    );
-
-    // 弾の更新
-    for (auto& bullet : pBullets_)
-    {
-        bullet->Update();
-    }
-
 	// aabbの更新
     aabb_.min = position_ - object_->GetScale();
     aabb_.max = position_ + object_->GetScale();
@@ -136,13 +97,7 @@ void NormalEnemy::Update()
 
 void NormalEnemy::Draw()
 {
-    object_->Draw();
-
-	// 弾描画
-	for (auto& bullet : pBullets_)
-	{
-		bullet->Draw();
-	}
+    object_->DrawInstanced();
 }
 
 void NormalEnemy::Draw2D()
@@ -176,11 +131,6 @@ void NormalEnemy::ImGuiDraw()
 
     ImGui::End();
 
-	for (auto& bullet : pBullets_)
-	{
-		bullet->ImGuiDraw();
-	}
-
 #endif // USE_IMGUI
 }
 
@@ -246,15 +196,15 @@ void NormalEnemy::Attack()
             std::sin(angle)  // Z成分
         };
 
-        // 弾を生成
-        auto bullet = std::make_unique<EnemyBullet>();
-        bullet->Initialize();
+        // プールから弾を取り出す(上限に達していれば残りは撃たない)
+        EnemyBullet* bullet = bulletPool_->Acquire();
+        if (!bullet)
+        {
+            break;
+        }
         bullet->SetPosition({ position_.x,position_.y + 0.5f,position_.z }); // 敵の位置より少し上を初期位置に設定
         bullet->SetVelocity(bulletDirection * 0.2f);
         bullet->UpdateModel();
-
-        // 弾をリストに追加
-        pBullets_.push_back(std::move(bullet));
     }
 }
     
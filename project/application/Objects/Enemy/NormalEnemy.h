@@ -2,6 +2,7 @@
 
 #include "../../baseObject/GameObject.h"
 #include "bullet/EnemyBullet.h"
+#include "../../baseObject/ObjectPool.h"
 #include "behaviorState/normalEnemyState/EnemyBehaviorState.h"
 #include"../../../gameEngine/collider/ColliderManager.h"
 #include "../../../gameEngine/particle/ParticleEmitter.h"
@@ -90,6 +91,12 @@ public: // セッター
 	// 無敵フラグをセット
 	void SetIsInvincible(bool _isInvincible) { isInvincible_ = _isInvincible; }
 
+	/// <summary>
+	/// 弾を取り出すプールをセット(EnemyManagerが全ての通常敵で共有するもの)
+	/// </summary>
+	/// <param name="_bulletPool">弾のプール</param>
+	void SetBulletPool(ObjectPool<EnemyBullet>* _bulletPool) { bulletPool_ = _bulletPool; }
+
 	// 被弾フラグをセット
 	void SetIsHit(bool _isHit) { isHit_ = _isHit; }
 
@@ -134,8 +141,8 @@ private:
 	// 追尾停止距離
 	const float kStopChasingDistance = 15.0f;
 
-	// 弾
-	std::vector<std::unique_ptr<EnemyBullet>> pBullets_ = {};
+	// 弾のプール(EnemyManagerが持つ。弾の更新と描画もEnemyManagerで行う)
+	ObjectPool<EnemyBullet>* bulletPool_ = nullptr;
 
 	// 行動ステート
 	std::unique_ptr<EnemyBehaviorState> pBehaviorState_ = nullptr;
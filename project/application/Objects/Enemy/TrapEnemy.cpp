@@ -61,46 +61,20 @@ void TrapEnemy::Finalize()
 {
     colliderManager_->DeleteCollider(&collider_);
 
-    // 罠
-	for (auto& trap : pTimeBomb_)
+    // 置いた罠を全てプールに戻す
+	for (TimeBomb* trap : timeBombs_)
 	{
-		trap->SetIsDead(true);
-		trap->Finalize();
+		ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
+		timeBombPool_->Release(trap);
 	}
+	timeBombs_.clear();
 
-	pTimeBomb_.erase(
-		std::remove_if(pTimeBomb_.begin(), pTimeBomb_.end(), [](std::unique_ptr<TimeBomb>& trap)
-			{
-				if (trap->IsDead())
-				{
-                    ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
-					trap->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pTimeBomb_.end()
-	);
-
-    for (auto& trap : pVignetteTrap_)
-    {
-		trap->SetIsDead(true);
-		trap->Finalize();
-    }
-
-	pVignetteTrap_.erase(
-		std::remove_if(pVignetteTrap_.begin(), pVignetteTrap_.end(), [](std::unique_ptr<VignetteTrap>& trap)
-			{
-				if (trap->IsDead())
-				{
-                    ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
-					trap->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pVignetteTrap_.end()
-	);
+	for (VignetteTrap* trap : vignetteTraps_)
+	{
+		ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
+		vignetteTrapPool_->Release(trap);
+	}
+	vignetteTraps_.clear();
 
 }
 
@@ -138,45 +112,28 @@ void TrapEnemy::Update()
 		isStopAndTrap_ = true;
     }
 
-    // 罠の削除
-	pTimeBomb_.erase(
-		std::remove_if(pTimeBomb_.begin(), pTimeBomb_.end(), [](std::unique_ptr<TimeBomb>& trap)
+    // 消えた罠をプールに戻す
+	std::erase_if(timeBombs_, [this](TimeBomb* trap)
+		{
+			if (trap->IsDead())
 			{
-				if (trap->IsDead())
-				{
-                    ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
-					trap->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pTimeBomb_.end()
-	);
-
-	pVignetteTrap_.erase(
-		std::remove_if(pVignetteTrap_.begin(), pVignetteTrap_.end(), [](std::unique_ptr<VignetteTrap>& trap)
+                ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
+				timeBombPool_->Release(trap);
+				return true;
+			}
+			return false;
+		});
+
+	std::erase_if(vignetteTraps_, [this](VignetteTrap* trap)
+		{
+			if (trap->IsDead())
 			{
-				if (trap->IsDead())
-				{
-                    ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
-					trap->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pVignetteTrap_.end()
-	);
-
-    // 罠の更新
-	for (auto& trap : pTimeBomb_)
-	{
-		trap->Update();
-	}
-
-	for (auto& trap : pVignetteTrap_)
-	{
-		trap->Update();
-	}
+                ParticleEmitter::Emit("BltReaction", trap->GetPosition(), 1);
+				vignetteTrapPool_->Release(trap);
+				return true;
+			}
+			return false;
+		});
 
     // aabbの更新
     aabb_.min = position_ - object_->GetScale();
@@ -189,16 +146,6 @@ void TrapEnemy::Update()
 void TrapEnemy::Draw()
 {
     object_->Draw();
-
-	// 罠の描画
-	for (auto& trap : pTimeBomb_)
-	{
-		trap->Draw();
-	}
-	for (auto& trap : pVignetteTrap_)
-	{
-		trap->Draw();
-	}
 }
 
 void TrapEnemy::Draw2D()
@@ -265,25 +212,27 @@ void TrapEnemy::TrapInit()
 {
     if (isNextTrapTimeBomb_ && isTrapCooldownComplete_)
     {
-        // TimeBomb発射
-        auto timeBomb = std::make_unique<TimeBomb>();
-        timeBomb->Initialize();
-        timeBomb->SetPosition(position_);
-        timeBomb->SetTrapLandingPosition(playerPosition_);
-        timeBomb->LaunchTrap();
-        timeBomb->UpdateModel();
-        pTimeBomb_.push_back(std::move(timeBomb));
+        // TimeBomb発射(上限に達していれば置かない)
+        if (TimeBomb* timeBomb = timeBombPool_->Acquire())
+        {
+            timeBombs_.push_back(timeBomb);
+            timeBomb->SetPosition(position_);
+            timeBomb->SetTrapLandingPosition(playerPosition_);
+            timeBomb->LaunchTrap();
+            timeBomb->UpdateModel();
+        }
     } 
 	else if (!isNextTrapTimeBomb_ && isTrapCooldownComplete_)
     {
-        // VignetteTrap発射
-        auto vignetteTrap = std::make_unique<VignetteTrap>();
-        vignetteTrap->Initialize();
-        vignetteTrap->SetPosition(position_);
-        vignetteTrap->SetTrapLandingPosition(playerPosition_);
-        vignetteTrap->LaunchTrap();
-        vignetteTrap->UpdateModel();
-        pVignetteTrap_.push_back(std::move(vignetteTrap));
+        // VignetteTrap発射(上限に達していれば置かない)
+        if (VignetteTrap* vignetteTrap = vignetteTrapPool_->Acquire())
+        {
+            vignetteTraps_.push_back(vignetteTrap);
+            vignetteTrap->SetPosition(position_);
+            vignetteTrap->SetTrapLandingPosition(playerPosition_);
+            vignetteTrap->LaunchTrap();
+            vignetteTrap->UpdateModel();
+        }
     }
 }
 
@@ -356,10 +305,10 @@ std::vector<Vector3> TrapEnemy::GetRemainingTimeBombPositions() const
     std::vector<Vector3> positions;
 
 	// 生きているTimeBombの位置を取得
-    for (const auto& trap : pTimeBomb_)
+    for (const TimeBomb* trap : timeBombs_)
     {
 		// 生きているTimeBombのみ取得
-        if (trap && !trap->IsDead())
+        if (!trap->IsDead())
         {
             positions.push_back(trap->GetPosition());
         }
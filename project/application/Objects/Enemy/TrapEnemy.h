@@ -3,6 +3,7 @@
 #include "../../baseObject/GameObject.h"
 #include "bullet/VignetteTrap.h"
 #include "bullet/TimeBomb.h"
+#include "../../baseObject/ObjectPool.h"
 #include "behaviorState/trapEnemyState/TrapEnemyBehaviorState.h"
 #include"../../../gameEngine/collider/ColliderManager.h"
 #include "../../../gameEngine/particle/ParticleEmitter.h"
@@ -109,6 +110,17 @@ public: // セッター
 	// 次の罠がTimeBombかVignetteTrapかのフラグ反転
 	void ChangeIsNextTrapTimeBomb() { isNextTrapTimeBomb_ = !isNextTrapTimeBomb_; }
 
+	/// <summary>
+	/// 罠を取り出すプールをセット(EnemyManagerが全てのトラップ敵で共有するもの)
+	/// </summary>
+	/// <param name="_timeBombPool">TimeBombのプール</param>
+	/// <param name="_vignetteTrapPool">VignetteTrapのプール</param>
+	void SetTrapPools(ObjectPool<TimeBomb>* _timeBombPool, ObjectPool<VignetteTrap>* _vignetteTrapPool)
+	{
+		timeBombPool_ = _timeBombPool;
+		vignetteTrapPool_ = _vignetteTrapPool;
+	}
+
 	/// <summary>
 	/// objectのtransformをセット
 	/// </summary>
@@ -142,9 +154,12 @@ private:
 	// 追尾開始距離
 	const float kTooFarDistance = 20.0f;
 
-	// 罠
-	std::vector<std::unique_ptr<TimeBomb>> pTimeBomb_ = {};
-	std::vector<std::unique_ptr<VignetteTrap>> pVignetteTrap_ = {};
+	// 罠のプール(EnemyManagerが持つ。罠の更新と描画もEnemyManagerで行う)
+	ObjectPool<TimeBomb>* timeBombPool_ = nullptr;
+	ObjectPool<VignetteTrap>* vignetteTrapPool_ = nullptr;
+	// この敵が置いた罠(消えたものと、この敵が倒れた時に残っているものをプールに戻す)
+	std::vector<TimeBomb*> timeBombs_;
+	std::vector<VignetteTrap*> vignetteTraps_;
 	
 	// クールタイム完了フラグ
 	bool isTrapCooldownComplete_ = false;
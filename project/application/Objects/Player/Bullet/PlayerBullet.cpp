@@ -41,16 +41,33 @@ void PlayerBullet::Finalize()
 	colliderManager_->DeleteCollider(&collider_);
 }
 
+void PlayerBullet::Activate()
+{
+	rotation_ = {};
+	scale_ = { 0.5f,0.5f,0.5f };
+	velocity_ = {};
+	aabb_ = {};
+	isDead_ = false;
+	deathRemainingSeconds_ = kLifeTime / kDefaultFrameRate;
+
+	collider_.SetEnable(true);
+}
+
+void PlayerBullet::Deactivate()
+{
+	collider_.SetEnable(false);
+}
+
 void PlayerBullet::Update()
 {
 	const float dt = TimeManager::Instance().GetDeltaTime();
 
-	object_->Update();
-
 	object_->SetPosition(position_);
 	object_->SetRotate(rotation_);
 	object_->SetScale(scale_);
 
+	object_->Update();
+
 	rotation_.y += 1.0f * dt * PlayerBullet::kDefaultFrameRate;
 	position_ += velocity_ * dt;
 
@@ -73,7 +90,7 @@ void PlayerBullet::Update()
 
 void PlayerBullet::Draw()
 {
-	object_->Draw();
+	object_->DrawInstanced();
 }
 
 void PlayerBullet::Draw2D()
@@ -40,6 +40,13 @@ void Player::Initialize()
 	collider_.MakeAABBDesc(desc);
 	colliderManager_->RegisterCollider(&collider_);
 
+	// 弾(撃つたびに作らないよう先に作っておく)
+	bulletPool_.Initialize(kMaxBulletCount_);
+
+	// 銃口(モデルにノードがあればそれに、無ければプレイヤーの前方に付ける)
+	const int32_t muzzleNode = object_->FindNode("muzzle");
+	muzzleNodeIndex_ = muzzleNode >= 0 ? static_cast<uint32_t>(muzzleNode) : object_->AttachNode(0, MakeTranslateMatrix(kMuzzleOffset_));
+
 	// 画面が更新されたらビネットを0にする
 	PostEffectManager::GetInstance()->GetPassAs<VignettePass>("Vignette")->SetStrength(0.0f);
 
@@ -75,25 +82,12 @@ void Player::Initialize()
 
 void Player::Finalize()
 {
-	for (auto& bullet : pBullets_)
-	{
-		bullet->SetIsDead(true);
-		bullet->Finalize();
-	}
-
-	pBullets_.erase(
-		std::remove_if(pBullets_.begin(), pBullets_.end(), [](std::unique_ptr < PlayerBullet>& bullet)
-			{
-				if (bullet->IsDead())
-				{
-					ParticleEmitter::Emit("BltReaction", bullet->GetPosition(), 1);
-					bullet->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pBullets_.end()
-	);
+	bulletPool_.ReleaseIf([](PlayerBullet& bullet)
+		{
+			ParticleEmitter::Emit("BltReaction", bullet.GetPosition(), 1);
+			return true;
+		});
+	bulletPool_.Finalize();
 
 	colliderManager_->DeleteCollider(&collider_);
 }
@@ -159,23 +153,19 @@ void Player::Update()
 		rotation_.y = Lerp(rotation_.y, 0.0f, 0.05f);
 	}
 
-	// 弾の削除
-	pBullets_.erase(
-		std::remove_if(pBullets_.begin(), pBullets_.end(), [](std::unique_ptr < PlayerBullet>& bullet)
+	// 弾の削除(プールに戻す)
+	bulletPool_.ReleaseIf([](PlayerBullet& bullet)
+		{
+			if (bullet.IsDead())
 			{
-				if (bullet->IsDead())
-				{
-					ParticleEmitter::Emit("BltReaction", bullet->GetPosition(), 1);
-					bullet->Finalize();
-					return true;
-				}
-				return false;
-			}),
-		pBullets_.end()
-	);
+				ParticleEmitter::Emit("BltReaction", bullet.GetPosition(), 1);
+				return true;
+			}
+			return false;
+		});
 
 	// 弾更新
-	for (auto& bullet : pBullets_)
+	for (PlayerBullet* bullet : bulletPool_.GetActiveObjects())
 	{
 		bullet->Update();
 	}
@@ -215,7 +205,7 @@ void Player::Draw()
 	object_->Draw();
 
 	// 弾描画
-	for (auto& bullet : pBullets_)
+	for (PlayerBullet* bullet : bulletPool_.GetActiveObjects())
 	{
 		bullet->Draw();
 	}
@@ -246,7 +236,7 @@ void Player::ImGuiDraw()
 
 	ImGui::End();
 
-	for (auto& bullet : pBullets_)
+	for (PlayerBullet* bullet : bulletPool_.GetActiveObjects())
 	{
 		bullet->ImGuiDraw();
 	}
@@ -342,15 +332,12 @@ void Player::Attack()
 
 		if (shootCooldownSec <= 0)
 		{
-			// 弾を生成し、初期化
-			auto newBullet = std::make_unique<PlayerBullet>();
-
-			newBullet->SetPosition(position_);
-			newBullet->Initialize();
-			newBullet->SetVelocity(bulletVelocity);
-
-			// 弾を登録する
-			pBullets_.push_back(std::move(newBullet));
+			// プールから弾を取り出す(上限に達していれば撃たない)
+			if (PlayerBullet* newBullet = bulletPool_.Acquire())
+			{
+				newBullet->SetPosition(GetMuzzlePosition());
+				newBullet->SetVelocity(bulletVelocity);
+			}
 
 			shootCooldownSec = shootCooldownDuration;
 		}
@@ -699,14 +686,12 @@ void Player::AutoAttack()
 			std::sinf(-rotation_.x),                             // y
 			std::cosf(rotation_.x) * std::cosf(rotation_.y)      // z
 		};
-		// 弾を生成し、初期化
-		auto newBullet = std::make_unique<PlayerBullet>();
-		newBullet->SetPosition(position_);
-		newBullet->Initialize();
-		newBullet->SetVelocity(bulletVelocity);
-		
-		// 弾を登録する
-		pBullets_.push_back(std::move(newBullet));
+		// プールから弾を取り出す(上限に達していれば撃たない)
+		if (PlayerBullet* newBullet = bulletPool_.Acquire())
+		{
+			newBullet->SetPosition(GetMuzzlePosition());
+			newBullet->SetVelocity(bulletVelocity);
+		}
 		attackCooldown = attackInterval;
 	}
 	else
@@ -721,6 +706,17 @@ void Player::ClampPosition()
 	position_.z = std::clamp(position_.z, limitMin_.y, limitMax_.y);
 }
 
+Vector3 Player::GetMuzzlePosition() const
+{
+	// ノードの行列は置き場所が変わることがあるので、使うたびに番号から引く
+	if (muzzleNodeIndex_ >= object_->GetNodeCount())
+	{
+		return position_;
+	}
+	const Matrix4x4& muzzleMatrix = object_->GetNodeWorldMatrix(muzzleNodeIndex_);
+	return { muzzleMatrix.m[3][0], muzzleMatrix.m[3][1], muzzleMatrix.m[3][2] };
+}
+
 void Player::OnCollisionTrigger(const Collider* _other)
 {
 
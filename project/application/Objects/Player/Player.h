@@ -2,6 +2,7 @@
 
 #include "../../baseObject/GameObject.h"
 #include "bullet/PlayerBullet.h"
+#include "../../baseObject/ObjectPool.h"
 #include"../../../gameEngine/collider/ColliderManager.h"
 
 #include "postEffect/PostEffectManager.h"
@@ -73,6 +74,9 @@ private: // 内部処理
 	// 移動制限
 	void ClampPosition();
 
+	// 弾を出す位置(銃口のノードのワールド座標)
+	Vector3 GetMuzzlePosition() const;
+
 private: // 衝突判定
 
 	/// <summary>
@@ -139,7 +143,14 @@ private:
 	Collider::ColliderDesc desc = {};
 
 	// 弾
-	std::vector<std::unique_ptr<PlayerBullet>> pBullets_ = {};
+	ObjectPool<PlayerBullet> bulletPool_;
+	// 同時に出せる弾の数(寿命5秒に対し、発射は15フレームと自動攻撃の50フレーム間隔)
+	const size_t kMaxBulletCount_ = 32;
+
+	// 銃口のノード(モデルに"muzzle"が無ければ前方に付ける)
+	uint32_t muzzleNodeIndex_ = 0;
+	// 付ける場合の銃口の位置(プレイヤーから見た位置)
+	const Vector3 kMuzzleOffset_ = { 0.0f,0.0f,0.6f };
 
 	// 発射クールタイム
 	const int kShootCoolDownFrame_ = 15;
@@ -152,8 +152,8 @@ void ClearScene::Draw()
 	// フィールド描画
 	pField_->Draw();
 
-	// 描画前処理(Sprite)
-	SpriteCommon::GetInstance()->CommonDrawSetting();
+	// インスタンス描画をまとめて並べ替えの列に積む(実行はMyGame::Drawで行う)
+	Object3dCommon::GetInstance()->FlushDraws();
 
 	for (auto& sprite : sprites_)
 	{
@@ -166,4 +166,6 @@ void ClearScene::Draw()
 		transition_->Draw();
 	}
 
+	// 積んだスプライトをテクスチャごとにまとめて並べ替えの列に積む
+	SpriteCommon::GetInstance()->FlushDraws();
 }
@@ -169,8 +169,8 @@ void GameOverScene::Draw()
 
 	pEnemyManager_->Draw();
 
-	// 描画前処理(Sprite)
-	SpriteCommon::GetInstance()->CommonDrawSetting();
+	// インスタンス描画をまとめて並べ替えの列に積む(実行はMyGame::Drawで行う)
+	Object3dCommon::GetInstance()->FlushDraws();
 
 	for (auto& sprite : sprites_)
 	{
@@ -183,6 +183,9 @@ void GameOverScene::Draw()
 	{
 		transition_->Draw();
 	}
+
+	// 積んだスプライトをテクスチャごとにまとめて並べ替えの列に積む
+	SpriteCommon::GetInstance()->FlushDraws();
 }
 
 void GameOverScene::CameraShake()
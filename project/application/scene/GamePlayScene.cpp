@@ -274,9 +274,8 @@ void GamePlayScene::Draw()
 
 	pGoal_->Draw();
 
-
-	// 描画前処理(Sprite)
-	SpriteCommon::GetInstance()->CommonDrawSetting();
+	// インスタンス描画をまとめて並べ替えの列に積む(実行はMyGame::Drawで行う)
+	Object3dCommon::GetInstance()->FlushDraws();
 
 	for (auto& sprite : sprites_)
 	{
@@ -294,6 +293,9 @@ void GamePlayScene::Draw()
 	{
 		fadeTransition_->Draw();
 	}
+
+	// 積んだスプライトをテクスチャごとにまとめて並べ替えの列に積む
+	SpriteCommon::GetInstance()->FlushDraws();
 }
 
 void GamePlayScene::AllImGui()
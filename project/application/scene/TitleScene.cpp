@@ -234,8 +234,8 @@ void TitleScene::Draw()
 	// フィールド
 	pField_->Draw();
 
-	// 描画前処理(Sprite)
-	SpriteCommon::GetInstance()->CommonDrawSetting();
+	// インスタンス描画をまとめて並べ替えの列に積む(実行はMyGame::Drawで行う)
+	Object3dCommon::GetInstance()->FlushDraws();
 
 	for (auto& sprite : sprites_)
 	{
@@ -247,7 +247,9 @@ void TitleScene::Draw()
 	{
 		transition_->Draw();
 	}
-	
+
+	// 積んだスプライトをテクスチャごとにまとめて並べ替えの列に積む
+	SpriteCommon::GetInstance()->FlushDraws();
 }
 
 void TitleScene::CameraUpdate()
@@ -1,6 +1,7 @@
 #include "Sprite.h"
 
 #include "SpriteCommon.h"
+#include "Object3d.h"
 
 #include <fstream>
 
@@ -9,52 +10,23 @@ void Sprite::Initialize(std::string textureFilePath,
 {
 	spriteCommon_ = SpriteCommon::GetInstance();
 
+	// 初期化し直す場合は前のテクスチャの参照を手放す
+	if (!textureFilePath_.empty())
+	{
+		TextureManager::GetInstance()->ReleaseTexture(textureFilePath_);
+	}
+
 	std::ifstream file;
 	// 基本パスを指定（"Resources/images/"）
 	std::string basePath = "resources/images/";
 	std::string fullPath = basePath + textureFilePath;
 	textureFilePath_ = fullPath;
 
-	vertexResource_ = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(VertexData) * 4);
-	indexResource_ = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(uint32_t) * 6);
-	materialResource_ = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
-	transformationMatrixResource_ = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(TransformationMatrix));
-
-	TextureManager::GetInstance()->LoadTexture(textureFilePath_);
-	//リソースの先頭アドレスから使う
-	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
-	//使用するリソースのサイズは頂点６つ分のサイズ
-	vertexBufferView_.SizeInBytes = sizeof(VertexData) * 4;
-	//1頂点当たりのサイズ
-	vertexBufferView_.StrideInBytes = sizeof(VertexData);
-
-	//リソースの先頭のアドレスから使う
-	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
-	//使用するリソースのサイズをインデックス6つ分のサイズ
-	indexBufferView_.SizeInBytes = sizeof(uint32_t) * 6;
-	//インデックスはuint32_tとする
-	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
-
-
-	vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&vertexData_));
-
-
-	//IndexResourceにデータを書き込む
-	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData_));
-
-	//書き込むためのアドレスを取得
-	materialResource_->Map(0, nullptr, reinterpret_cast<void**>(&materialData_));
-
+	TextureManager::GetInstance()->AcquireTexture(textureFilePath_);
 
-	// マテリアルデータにデータの初期値を書き込む
-	materialData_->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData_->uvTransform = MakeIdentity4x4();
-
-	//書き込むためのアドレス
-	transformationMatrixResource_->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData_));
-	//単位行列を書き込んでおく
-	transformationMatrixData_->World = MakeIdentity4x4();
-	transformationMatrixData_->WVP = MakeIdentity4x4();
+	// 色の初期値と単位行列を入れておく
+	materialColor_ = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	worldViewProjection_ = MakeIdentity4x4();
 
 	transform_ = {
 		{1.0f,1.0f,1.0f},
@@ -62,11 +34,18 @@ void Sprite::Initialize(std::string textureFilePath,
 		{0.0f,0.0f,0.0f}
 	};
 
-	// 単位行列を書き込んでおく
+	// テクスチャの番号と大きさはここで1回だけ引いておく(AcquireTextureで読み込みまで終わっている)
 	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath_);
+	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureFilePath_);
+	textureWidth_ = static_cast<float>(metadata.width);
+	textureHeight_ = static_cast<float>(metadata.height);
 
 	AdjustTextureSize();
 
+	// 初期化し直したときも次のUpdateで作り直す
+	isVertexDirty_ = true;
+	isTransformDirty_ = true;
+
 	SetPosition(position);
 	SetColor(color);
 	SetAnchorPoint(anchorpoint);
@@ -74,8 +53,20 @@ void Sprite::Initialize(std::string textureFilePath,
 	color_ = color;
 }
 
+Sprite::~Sprite()
+{
+	// 初期化済みならテクスチャの参照を手放す
+	if (!textureFilePath_.empty())
+	{
+		TextureManager::GetInstance()->ReleaseTexture(textureFilePath_);
+	}
+}
+
 void Sprite::Update()
 {
+	// 行列が変わったときだけクリップ座標の頂点を作り直す
+	bool isClipDirty = false;
+
 	// スクリーン追従モード FollowWorldPosition
 	if (followWorldPositionPtr_ != nullptr && worldToScreenFunc_)
 	{
@@ -86,28 +77,84 @@ void Sprite::Update()
 		};
 		// worldToScreenFunc_ はスクリーン座標を返す
 		Vector2 screenPos = worldToScreenFunc_(worldPosWithOffset);
-		position_.x = screenPos.x;
-		position_.y = screenPos.y;
+		if (screenPos.x != position_.x || screenPos.y != position_.y)
+		{
+			position_.x = screenPos.x;
+			position_.y = screenPos.y;
+			isTransformDirty_ = true;
+		}
 	}
-	// 親行列追従モード FollowParentWorldMatrix
-	else if (parentWorldMatrixPtr_ != nullptr)
+	// 親行列追従モード FollowParentWorldMatrix / FollowNode
+	else if (parentWorldMatrixPtr_ != nullptr or followObject_ != nullptr)
 	{
+		// ノード追従なら今の置き場所から引く(無くなっていれば前の行列のまま)
+		const Matrix4x4* parentWorldMatrix = parentWorldMatrixPtr_;
+		if (followObject_ != nullptr)
+		{
+			parentWorldMatrix = followNodeIndex_ < followObject_->GetNodeCount() ? &followObject_->GetNodeWorldMatrix(followNodeIndex_) : nullptr;
+		}
 		// local transform を作る
 		Transform localTransform = transform_;
 		localTransform.translate = parentLocalOffset_;
 		// ローカル行列を作る
 		Matrix4x4 localWorld = MakeAffineMatrix(localTransform.scale, localTransform.rotate, localTransform.translate);
-		// 親ワールド行列と合成
-		Matrix4x4 composedWorld = Multiply(*parentWorldMatrixPtr_, localWorld);
-		// World 行列を直接セット
-		transformationMatrixData_->World = composedWorld;
-		// viewProjPtr_ がセットされていれば WVP を計算
-		if (viewProjPtr_ != nullptr)
+		// viewProjPtr_ がセットされていれば親ワールド行列と合成して WVP を計算
+		if (viewProjPtr_ != nullptr and parentWorldMatrix != nullptr)
 		{
-			transformationMatrixData_->WVP = Multiply(composedWorld, *viewProjPtr_);
+			Matrix4x4 composedWorld = Multiply(*parentWorldMatrix, localWorld);
+			worldViewProjection_ = Multiply(composedWorld, *viewProjPtr_);
 		}
+		// 親はこちらの知らないところで動くので毎回作り直す
+		isClipDirty = true;
+	}
+
+	// 色と透明度を更新
+	materialColor_ = color_;
+
+	if (isVertexDirty_)
+	{
+		UpdateVertexData();
+		isVertexDirty_ = false;
+		isClipDirty = true;
+	}
+
+	transform_.translate = { position_.x,position_.y ,0.0f };
+	transform_.rotate = { 0.0f,0.0f,rotation_ };
+	transform_.scale = { size_.x,size_.y,1.0f };
+
+	// 親行列追従でない場合は座標・回転・サイズが変わったときだけ WVP を作る
+	if (parentWorldMatrixPtr_ == nullptr && followObject_ == nullptr && isTransformDirty_)
+	{
+		Matrix4x4 worldMatrixSprite = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
+		Matrix4x4 viewMatrixSprite = MakeIdentity4x4();
+		Matrix4x4 projectionMatrixSprite = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
+		Matrix4x4 worldViewProjectionMatrixSprite = Multiply(worldMatrixSprite, Multiply(viewMatrixSprite, projectionMatrixSprite));
+		worldViewProjection_ = worldViewProjectionMatrixSprite;
+		isTransformDirty_ = false;
+		isClipDirty = true;
+	}
+
+	if (!isClipDirty)
+	{
+		return;
+	}
+
+	// 頂点をクリップ座標まで変換しておく
+	const Matrix4x4& m = worldViewProjection_;
+	for (uint32_t i = 0; i < SpriteBatch::kVerticesPerQuad; ++i)
+	{
+		const Vector4& p = vertexData_[i].position;
+		clipPositions_[i] = {
+			p.x * m.m[0][0] + p.y * m.m[1][0] + p.z * m.m[2][0] + p.w * m.m[3][0],
+			p.x * m.m[0][1] + p.y * m.m[1][1] + p.z * m.m[2][1] + p.w * m.m[3][1],
+			p.x * m.m[0][2] + p.y * m.m[1][2] + p.z * m.m[2][2] + p.w * m.m[3][2],
+			p.x * m.m[0][3] + p.y * m.m[1][3] + p.z * m.m[2][3] + p.w * m.m[3][3]
+		};
 	}
+}
 
+void Sprite::UpdateVertexData()
+{
 	float left = 0.0f - anchorPoint_.x;
 	float right = 1.0f - anchorPoint_.x;
 	float top = 0.0f - anchorPoint_.y;
@@ -127,80 +174,42 @@ void Sprite::Update()
 		bottom = -bottom;
 	}
 
-	// 色と透明度を更新
-	if (materialData_ != nullptr)
-	{
-		materialData_->color = color_;
-	}
-
-	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureFilePath_);
-	float tex_left = textureLeftTop_.x / metadata.width;
-	float tex_right = (textureLeftTop_.x + textureSize_.x) / metadata.width;
-	float tex_top = textureLeftTop_.y / metadata.height;
-	float tex_bottom = (textureLeftTop_.y + textureSize_.y) / metadata.height;
+	float tex_left = textureLeftTop_.x / textureWidth_;
+	float tex_right = (textureLeftTop_.x + textureSize_.x) / textureWidth_;
+	float tex_top = textureLeftTop_.y / textureHeight_;
+	float tex_bottom = (textureLeftTop_.y + textureSize_.y) / textureHeight_;
 
 	if (tex_right > 1.0f)
 	{
 		tex_right = 1.0f;
 	}
 
+	// 左下・左上・右下・右上の順(SpriteCommonのインデックスバッファがこの順で三角形を作る)
 	vertexData_[0].position = { left,bottom,0.0f,1.0f };
 	vertexData_[0].texcoord = { tex_left,tex_bottom };
-	vertexData_[0].normal = { 0.0f,0.0f,-1.0f };
 
 	vertexData_[1].position = { left,top,0.0f,1.0f };
 	vertexData_[1].texcoord = { tex_left,tex_top };
-	vertexData_[1].normal = { 0.0f,0.0f,-1.0f };
 
 	vertexData_[2].position = { right,bottom,0.0f,1.0f };
 	vertexData_[2].texcoord = { tex_right,tex_bottom };
-	vertexData_[2].normal = { 0.0f,0.0f,-1.0f };
 
 	vertexData_[3].position = { right,top,0.0f,1.0f };
 	vertexData_[3].texcoord = { tex_right,tex_top };
-	vertexData_[3].normal = { 0.0f,0.0f,-1.0f };
-
-	indexData_[0] = 0;		indexData_[1] = 1;		indexData_[2] = 2;
-	indexData_[3] = 1;		indexData_[4] = 3;		indexData_[5] = 2;
-
-
-	transform_.translate = { position_.x,position_.y ,0.0f };
-	transform_.rotate = { 0.0f,0.0f,rotation_ };
-	transform_.scale = { size_.x,size_.y,1.0f };
-
-	// 親行列追従でない場合は通常通り WVP を作る
-	if (parentWorldMatrixPtr_ == nullptr)
-	{
-		Matrix4x4 worldMatrixSprite = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
-		Matrix4x4 viewMatrixSprite = MakeIdentity4x4();
-		Matrix4x4 projectionMatrixSprite = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
-		Matrix4x4 worldViewProjectionMatrixSprite = Multiply(worldMatrixSprite, Multiply(viewMatrixSprite, projectionMatrixSprite));
-		transformationMatrixData_->WVP = worldViewProjectionMatrixSprite;
-		transformationMatrixData_->World = worldMatrixSprite;
-	}
-
 }
 
 void Sprite::Draw()
 {
+	// Updateで変換しておいた頂点に今の色を付けてまとめ描画に積む
+	SpriteBatch::Vertex vertices[SpriteBatch::kVerticesPerQuad];
+	for (uint32_t i = 0; i < SpriteBatch::kVerticesPerQuad; ++i)
+	{
+		vertices[i].position = clipPositions_[i];
+		vertices[i].texcoord = vertexData_[i].texcoord;
+		vertices[i].color = materialColor_;
+	}
 
-	// Spriteの描画。変更が必要なものだけ変更する
-	spriteCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
-	// IBVを設定
-	spriteCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView_);
-
-
-	// マテリアルCBufferの場所を設定
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
-	// TransformationMatrixCBufferの場所を設定
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource_->GetGPUVirtualAddress());
-
-	// SRVのDescriptorTableの先頭を設定。2はrootPatameter[2]である。
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureFilePath_));
-	// スプライトの描画(DrawCall//ドローコール)
-	spriteCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
-
-
+	spriteCommon_->AddQuad(layer_, textureIndex, vertices);
 }
 
 void Sprite::FollowWorldPosition(const Vector3* worldPosPtr, Vector3 offset)
@@ -215,40 +224,51 @@ void Sprite::FollowParentWorldMatrix(const Matrix4x4* parentWorldPtr, bool follo
 {
 	// 親のワールド行列ポインタを保存
 	parentWorldMatrixPtr_ = parentWorldPtr;
+	followObject_ = nullptr;
+	isTransformDirty_ = true;
 	// 回転追従フラグを保存		
 	parentFollowRotation_ = followRotation;
 	// ローカルオフセットを保存
 	parentLocalOffset_ = localOffset;
 }
 
+void Sprite::FollowNode(const Object3d* object, uint32_t nodeIndex, bool followRotation, Vector3 localOffset)
+{
+	// 行列のアドレスではなくオブジェクトとノードの番号を保存
+	followObject_ = object;
+	followNodeIndex_ = nodeIndex;
+	parentWorldMatrixPtr_ = nullptr;
+	isTransformDirty_ = true;
+	// 回転追従フラグを保存
+	parentFollowRotation_ = followRotation;
+	// ローカルオフセットを保存
+	parentLocalOffset_ = localOffset;
+}
+
 void Sprite::StopFollowing()
 {
 	// 追従ポインタをnullptrに設定
 	followWorldPositionPtr_ = nullptr;
 	parentWorldMatrixPtr_ = nullptr;
+	followObject_ = nullptr;
 	worldToScreenFunc_ = nullptr;
+	// 通常の WVP に戻す
+	isTransformDirty_ = true;
 }
 
 void Sprite::SetColorChange(const Vector4& color)
 {
 	color_ = color;
-	if (materialData_ != nullptr)
-	{
-		materialData_->color = color_;
-	}
+	materialColor_ = color_;
 }
 
 void Sprite::AdjustTextureSize()
 {
-	// テクスチャメタデータを取得
-	const DirectX::TexMetadata& metadata = TextureManager::GetInstance()->GetMetaData(textureFilePath_);
-
-	//textureSize_.x = static_cast<float>(metadata.width);
-	//textureSize_.y = static_cast<float>(metadata.height);
-	
 	textureLeftTop_ = { 0.0f,0.0f };
-	textureSize_ = { static_cast<float>(metadata.width), static_cast<float>(metadata.height) };
+	textureSize_ = { textureWidth_, textureHeight_ };
 	
 	// 画像サイズをテクスチャサイズに合わせる
 	size_ = textureSize_;
-}
\ No newline at end of file
+	isVertexDirty_ = true;
+	isTransformDirty_ = true;
+}
@@ -10,19 +10,29 @@
 
 #include "MyMath.h"
 #include "TextureManager.h"
+#include "SpriteBatch.h"
 
 class SpriteCommon;
+class Object3d;
 
 
 /// <summary>
 /// スプライト
+/// 自分ではバッファを持たず、Drawで頂点をSpriteCommonのまとめ描画に積む
 /// </summary>
 class Sprite
 {
 public:
 
+	Sprite() = default;
+	// テクスチャの参照を手放す
+	~Sprite();
+	Sprite(const Sprite&) = delete;
+	Sprite& operator=(const Sprite&) = delete;
+
 	/// <summary>
 	/// 初期化
+	/// テクスチャはスプライトが参照を持ち、破棄時に手放す
 	/// </summary>
 	/// <param name="textureFilePath">テクスチャファイルパス</param>
 	/// <param name="position">座標</param>
@@ -30,10 +40,10 @@ public:
 	/// <param name="anchorpoint">アンカーポイント</param>
 	void Initialize(std::string textureFilePath,Vector2 position, Vector4 color = { (1) , (1), (1), (1) }, Vector2 anchorpoint = { 0.0f,0.0f });
 
-	// 更新
+	// 更新(頂点と行列は設定が変わったときだけ作り直す)
 	void Update();
 
-	// 描画
+	// 描画(SpriteCommon::FlushDrawsでまとめて描画される)
 	void Draw();
 
 	/// <summary>
@@ -45,12 +55,24 @@ public:
 
 	/// <summary>
 	/// 親のワールド行列追従
+	/// 行列は追従中ずっと同じアドレスにあること(Object3dのノードにはFollowNodeを使う)
 	/// </summary>
 	/// <param name="parentWorldMatrix">親のワールド行列ポインタ</param>
 	/// <param name="followRotation">回転追従フラグ</param>
 	/// <param name="localOffset">ローカルオフセット</param>
 	void FollowParentWorldMatrix(const Matrix4x4* parentWorldPtr, bool followRotation = true, Vector3 localOffset = { 0,0,0 });
 
+	/// <summary>
+	/// Object3dのノード追従
+	/// 行列はUpdateのたびにノードの番号から引き直す(ノードが増えて行列の置き場所が変わっても追従できる)
+	/// ノードが無くなっている間は最後の位置に留まる。オブジェクトは追従中に破棄しないこと
+	/// </summary>
+	/// <param name="object">追従するオブジェクト</param>
+	/// <param name="nodeIndex">ノードの番号(Object3d::FindNode、AttachNodeの戻り値。0はオブジェクト自身)</param>
+	/// <param name="followRotation">回転追従フラグ</param>
+	/// <param name="localOffset">ローカルオフセット</param>
+	void FollowNode(const Object3d* object, uint32_t nodeIndex, bool followRotation = true, Vector3 localOffset = { 0,0,0 });
+
 	// 追従を停止する
 	void StopFollowing();
 
@@ -61,7 +83,7 @@ public:// ゲッター
 	// 回転取得
 	float GetRotation() const { return rotation_; }
 	// 色取得
-	const Vector4& GetColor() const { return materialData_->color; }
+	const Vector4& GetColor() const { return materialColor_; }
 	// サイズ取得
 	const Vector2& GetSize()const { return size_; }
 	// アンカーポイント取得
@@ -74,6 +96,8 @@ public:// ゲッター
 	const Vector2& GetTextureLeftTop()const { return textureLeftTop_; }
 	// テクスチャ切り出しサイズ取得
 	const Vector2& GetTextureSize()const { return textureSize_; }
+	// 層取得
+	uint32_t GetLayer() const { return layer_; }
 
 public:// セッター
 
@@ -81,19 +105,19 @@ public:// セッター
 	/// 座標設定
 	/// </summary>
 	/// <param name="position">座標</param>
-	void SetPosition(const Vector2& position) { position_ = position; }
+	void SetPosition(const Vector2& position) { position_ = position; isTransformDirty_ = true; }
 	
 	/// <summary>
 	/// 回転設定
 	/// </summary>
 	///	<param name="rotation">回転角</param>
-	void SetRotation(float rotation) { rotation_ = rotation; }
+	void SetRotation(float rotation) { rotation_ = rotation; isTransformDirty_ = true; }
 
 	/// <summary>
 	/// 色設定
 	/// </summary>
 	/// <param name="color">色</param>
-	void SetColor(const Vector4& color) { materialData_->color = color; }
+	void SetColor(const Vector4& color) { materialColor_ = color; }
 
 	/// <summary>
 	/// 色変更設定
@@ -105,37 +129,43 @@ public:// セッター
 	/// サイズ設定
 	/// </summary>
 	/// <param name="size">サイズ</param>
-	void SetSize(const Vector2& size) { size_ = size; }
+	void SetSize(const Vector2& size) { size_ = size; isTransformDirty_ = true; }
 
 	/// <summary>
 	/// アンカーポイント設定
 	/// </summary>
 	/// <param name="anchorPoint">アンカーポイント</param>
-	void SetAnchorPoint(const Vector2& anchorPoint) { anchorPoint_ = anchorPoint; }
+	void SetAnchorPoint(const Vector2& anchorPoint) { anchorPoint_ = anchorPoint; isVertexDirty_ = true; }
 
 	/// <summary>
 	/// フリップX設定
 	/// </summary>
 	/// <param name="IsFlipX">フリップXフラグ</param>
-	void SetFlipX(const bool& IsFlipX) { isFlipX_ = IsFlipX; }
+	void SetFlipX(const bool& IsFlipX) { isFlipX_ = IsFlipX; isVertexDirty_ = true; }
 	
 	/// <summary>
 	/// フリップY設定
 	/// </summary>
 	/// <param name="IsFlipY">フリップYフラグ</param>
-	void SetFlipY(const bool& IsFlipY) { isFlipY_ = IsFlipY; }
+	void SetFlipY(const bool& IsFlipY) { isFlipY_ = IsFlipY; isVertexDirty_ = true; }
 
 	/// <summary>
 	/// テクスチャ左上座標設定
 	/// </summary>
 	/// <param name="textureLeftTop">テクスチャ左上座標</param>
-	void SetTextureLeftTop(const Vector2& textureLeftTop) { textureLeftTop_ = textureLeftTop; }
+	void SetTextureLeftTop(const Vector2& textureLeftTop) { textureLeftTop_ = textureLeftTop; isVertexDirty_ = true; }
 	
 	/// <summary>
 	/// テクスチャ切り出しサイズ設定
 	/// </summary>
 	/// 
-	void SetTextureSize(const Vector2& textureSize) { textureSize_ = textureSize; }
+	void SetTextureSize(const Vector2& textureSize) { textureSize_ = textureSize; isVertexDirty_ = true; }
+
+	/// <summary>
+	/// 層設定(大きいほど手前に描く。同じ層の中では描画を呼んだ順)
+	/// </summary>
+	/// <param name="layer">層</param>
+	void SetLayer(uint32_t layer) { layer_ = layer; }
 
 	/// <summary>
 	/// ワールド座標をスクリーン座標に変換する関数の設定
@@ -154,6 +184,9 @@ private: // 内部関数
 	// テクスチャサイズをイメージに合わせる
 	void AdjustTextureSize();
 
+	// アンカーポイント・フリップ・切り出し範囲から頂点を作る
+	void UpdateVertexData();
+
 private: // 構造体、関数
 
 	struct Transform
@@ -167,19 +200,6 @@ private: // 構造体、関数
 	{
 		Vector4 position;
 		Vector2 texcoord;
-		Vector3 normal;
-	};
-
-	struct Material
-	{
-		Vector4 color;
-		Matrix4x4 uvTransform;
-	};
-
-	struct TransformationMatrix
-	{
-		Matrix4x4 WVP;
-		Matrix4x4 World;
 	};
 
 
@@ -189,35 +209,28 @@ private:
 	SpriteCommon* spriteCommon_ = nullptr;
 	std::string textureFilePath_;
 
-	// 定数バッファの宣言
-	Microsoft::WRL::ComPtr<ID3D12Resource> constantBuffer_;
-
-	// バッファリソース
-	//スプライト用の頂点リソースを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_{};
-	//IndexResourceを生成する
-	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_{};
-	// マテリアルリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_{};
-	//VertexShaderで利用するTransformationMatrix用のResourceを作る
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource_{};
-
-	// バッファリソース内のデータを指すポインタ
-	VertexData* vertexData_ = nullptr;
-	uint32_t* indexData_ = nullptr;
-	Material* materialData_ = nullptr;
-	TransformationMatrix* transformationMatrixData_ = nullptr;
-	// バッファリソースの使い道を補足するバッファビュー
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView_;
-	D3D12_INDEX_BUFFER_VIEW indexBufferView_;
-
-	Microsoft::WRL::ComPtr<ID3D12Resource> textureResource_;
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource_;
-
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc_{};
+	// 四角形の頂点(サイズ1の四角形)
+	VertexData vertexData_[SpriteBatch::kVerticesPerQuad] = {};
+	// ワールドビュープロジェクション行列
+	Matrix4x4 worldViewProjection_ = MakeIdentity4x4();
+	// クリップ座標まで変換した頂点の位置(Drawではこれを積むだけ)
+	Vector4 clipPositions_[SpriteBatch::kVerticesPerQuad] = {};
+
+	// アンカーポイント・フリップ・切り出し範囲が変わったか
+	bool isVertexDirty_ = true;
+	// 座標・回転・サイズが変わったか
+	bool isTransformDirty_ = true;
+	// 描画に使う色(SetColorで変え、Updateでcolor_に戻す)
+	Vector4 materialColor_ = { 1.0f,1.0f,1.0f,1.0f };
 
 	// テクスチャ番号
 	uint32_t textureIndex = 0;
+	// テクスチャの大きさ(Initializeで1回だけ引いておく)
+	float textureWidth_ = 1.0f;
+	float textureHeight_ = 1.0f;
+
+	// 層
+	uint32_t layer_ = 0;
 
 	Transform transform_;
 
@@ -248,6 +261,9 @@ private:
 
 	// 親ワールド行列追従
 	const Matrix4x4* parentWorldMatrixPtr_ = nullptr;
+	// ノード追従(parentWorldMatrixPtr_の代わりに毎回引き直す)
+	const Object3d* followObject_ = nullptr;
+	uint32_t followNodeIndex_ = 0;
 	Vector3 parentLocalOffset_ = { 0,0,0 };
 	bool parentFollowRotation_ = true;
 
@@ -0,0 +1,49 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+
+void SpriteBatch::Add(uint32_t layer, uint32_t textureIndex, const Vertex (&vertices)[kVerticesPerQuad])
+{
+	Quad& quad = quads_.emplace_back();
+	quad.layer = layer;
+	quad.textureIndex = textureIndex;
+	std::copy(std::begin(vertices), std::end(vertices), quad.vertices);
+}
+
+void SpriteBatch::Build()
+{
+	const uint32_t quadCount = GetQuadCount();
+	order_.resize(quadCount);
+	for (uint32_t i = 0; i < quadCount; ++i)
+	{
+		order_[i] = i;
+	}
+
+	// 同じ層の中では積んだ順(奥から)を守る
+	// テクスチャで並べ替えると、重なっている別のテクスチャのものと前後が入れ替わってしまう
+	std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b)
+		{
+			return quads_[a].layer < quads_[b].layer;
+		});
+
+	vertices_.clear();
+	vertices_.reserve(static_cast<size_t>(quadCount) * kVerticesPerQuad);
+	runs_.clear();
+	for (uint32_t i = 0; i < quadCount; ++i)
+	{
+		const Quad& quad = quads_[order_[i]];
+		vertices_.insert(vertices_.end(), std::begin(quad.vertices), std::end(quad.vertices));
+
+		// 層が変わってもテクスチャが同じなら続けて描ける
+		if (runs_.empty() || runs_.back().textureIndex != quad.textureIndex)
+		{
+			runs_.push_back({ quad.textureIndex, i, 0 });
+		}
+		++runs_.back().quadCount;
+	}
+}
+
+void SpriteBatch::Clear()
+{
+	quads_.clear();
+}
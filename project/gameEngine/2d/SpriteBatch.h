@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "MyMath.h"
+#include "Vector2.h"
+
+/// <summary>
+/// スプライトの四角形をフレームごとに集めて並べるもの
+/// 頂点はクリップ座標まで変換済みで受け取り、層の順に並べて同じテクスチャが続く区間にまとめる
+/// 同じ層の中では積んだ順(重なりの順)を変えないので、まとまるのは続けて積んだ同じテクスチャのものだけ
+/// デバイスを使わないので、並べた結果だけを取り出して確かめられる
+/// </summary>
+class SpriteBatch
+{
+public:
+
+	// 四角形1つ分の頂点とインデックスの数
+	static const uint32_t kVerticesPerQuad = 4;
+	static const uint32_t kIndicesPerQuad = 6;
+
+	// 頂点(クリップ座標・UV・色)
+	struct Vertex
+	{
+		Vector4 position;
+		Vector2 texcoord;
+		Vector4 color;
+	};
+
+	// 同じテクスチャが続く区間
+	struct Run
+	{
+		uint32_t textureIndex;
+		uint32_t quadStart;
+		uint32_t quadCount;
+	};
+
+public:
+
+	/// <summary>
+	/// 四角形を積む
+	/// </summary>
+	/// <param name="layer">層(小さいものから描く。同じ層の中では積んだ順)</param>
+	/// <param name="textureIndex">テクスチャのSRVの番号</param>
+	/// <param name="vertices">左下・左上・右下・右上の順の頂点</param>
+	void Add(uint32_t layer, uint32_t textureIndex, const Vertex (&vertices)[kVerticesPerQuad]);
+
+	/// <summary>
+	/// 積んだ四角形を層の順に並べ(同じ層の中は積んだ順のまま)、同じテクスチャが続く区間にまとめる
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// 積んだ四角形をすべて捨てる
+	/// </summary>
+	void Clear();
+
+public: // ゲッター
+
+	// 積んだ四角形の数
+	uint32_t GetQuadCount() const { return static_cast<uint32_t>(quads_.size()); }
+
+	// 並べた後の頂点(Buildの後で有効)
+	const std::vector<Vertex>& GetVertices() const { return vertices_; }
+
+	// 同じテクスチャが続く区間(Buildの後で有効)
+	const std::vector<Run>& GetRuns() const { return runs_; }
+
+private:
+
+	// 積んだ四角形
+	struct Quad
+	{
+		uint32_t layer;
+		uint32_t textureIndex;
+		Vertex vertices[kVerticesPerQuad];
+	};
+
+private:
+
+	// 積んだ順の四角形
+	std::vector<Quad> quads_;
+	// 並べ替えの作業用(毎フレーム使い回す)
+	std::vector<uint32_t> order_;
+
+	// 並べた結果
+	std::vector<Vertex> vertices_;
+	std::vector<Run> runs_;
+};
@@ -1,6 +1,10 @@
 #include "SpriteCommon.h"
+#include "TextureManager.h"
+#include "SrvManager.h"
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 SpriteCommon* SpriteCommon::GetInstance()
 {
@@ -32,7 +36,7 @@ void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 	depthStencilDesc_.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
 
 
-	//InputLayout
+	//InputLayout(頂点はクリップ座標まで変換済みで、色も頂点ごとに持つ)
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
 	inputElementDescs[0].SemanticName = "POSITION";
 	inputElementDescs[0].SemanticIndex = 0;
@@ -44,9 +48,9 @@ void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 	inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
 	inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
-	inputElementDescs[2].SemanticName = "NORMAL";
+	inputElementDescs[2].SemanticName = "COLOR";
 	inputElementDescs[2].SemanticIndex = 0;
-	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
 	inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
 
 	inputLayoutDesc_.pInputElementDescs = inputElementDescs;
@@ -81,6 +85,23 @@ void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 
 
 	CreateGraphicsPipeline();
+
+	// 四角形ごとに 左下・左上・右下 / 左上・右上・右下 の2枚の三角形にする
+	indexResource_ = dxCommon_->CreateBufferResource(sizeof(uint32_t) * SpriteBatch::kIndicesPerQuad * kMaxQuadCount_);
+	uint32_t* indexData = nullptr;
+	indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	for (uint32_t quad = 0; quad < kMaxQuadCount_; ++quad)
+	{
+		const uint32_t vertex = quad * SpriteBatch::kVerticesPerQuad;
+		uint32_t* index = indexData + quad * SpriteBatch::kIndicesPerQuad;
+		index[0] = vertex;		index[1] = vertex + 1;	index[2] = vertex + 2;
+		index[3] = vertex + 1;	index[4] = vertex + 3;	index[5] = vertex + 2;
+	}
+	indexResource_->Unmap(0, nullptr);
+
+	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+	indexBufferView_.SizeInBytes = sizeof(uint32_t) * SpriteBatch::kIndicesPerQuad * kMaxQuadCount_;
+	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
 }
 
 void SpriteCommon::CreateRootSignature()
@@ -91,25 +112,12 @@ void SpriteCommon::CreateRootSignature()
 	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature{};
 	descriptionRootSignature.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
-	//RootParameter作成。複数設定できるので配列。今回は結果１つだけなので長さ１の配列
-	D3D12_ROOT_PARAMETER rootParameters[4] = {};
-	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;		//CBVを使う
-	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;		//PixelShaderで使う
-	rootParameters[0].Descriptor.ShaderRegister = 0;						//レジスタ番号０とバインド
-
-	rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-	rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
-	rootParameters[1].Descriptor.ShaderRegister = 0;
-
-	rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;			//DescriptorTableを使う
-	rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;						//PixelShaderで使う
-	rootParameters[2].DescriptorTable.pDescriptorRanges = descriptorRange_; 				//Tableの中身の配列を指定
-	rootParameters[2].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange_);		//Tableで利用する数
-
-	rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
-	rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-	rootParameters[3].Descriptor.RegisterSpace = 0;
-	rootParameters[3].Descriptor.ShaderRegister = 1;
+	//RootParameter作成。色と座標は頂点に持たせるので、テクスチャのDescriptorTableだけ
+	D3D12_ROOT_PARAMETER rootParameters[1] = {};
+	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;			//DescriptorTableを使う
+	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;						//PixelShaderで使う
+	rootParameters[0].DescriptorTable.pDescriptorRanges = descriptorRange_; 				//Tableの中身の配列を指定
+	rootParameters[0].DescriptorTable.NumDescriptorRanges = _countof(descriptorRange_);		//Tableで利用する数
 
 
 	//Smaplerの設定
@@ -178,11 +186,65 @@ void SpriteCommon::CreateGraphicsPipeline()
 	rasterizerDesc_.CullMode = D3D12_CULL_MODE_NONE;
 }
 
-void SpriteCommon::CommonDrawSetting()
+void SpriteCommon::BindPipeline()
 {
 	//RootSignatureを設定。PSOに設定しているけど別途設定が必要
 	commandList_->SetGraphicsRootSignature(rootSignature_.Get());
 	commandList_->SetPipelineState(graphicsPipelineState_.Get());
 	//形状を設定。PSOに設定しているものとはまた別。同じものを設定すると考えておけばよい
 	commandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-}
\ No newline at end of file
+}
+
+void SpriteCommon::AddQuad(uint32_t layer, uint32_t textureIndex, const SpriteBatch::Vertex (&vertices)[SpriteBatch::kVerticesPerQuad])
+{
+	spriteBatch_.Add(layer, textureIndex, vertices);
+}
+
+void SpriteCommon::FlushDraws()
+{
+	if (spriteBatch_.GetQuadCount() == 0)
+	{
+		return;
+	}
+
+	// 並べた頂点をフレームごとのアップロード領域にまとめて書き込み、1つの頂点バッファとして使う
+	spriteBatch_.Build();
+	const std::vector<SpriteBatch::Vertex>& vertices = spriteBatch_.GetVertices();
+	const size_t vertexSize = sizeof(SpriteBatch::Vertex) * vertices.size();
+	DirectXCommon::UploadAllocation allocation = dxCommon_->AllocateUpload(vertexSize);
+	if (!allocation.cpuAddress)
+	{
+		// 書き込み先が無いので、このフレームのスプライトは描かない
+		spriteBatch_.Clear();
+		return;
+	}
+	std::memcpy(allocation.cpuAddress, vertices.data(), vertexSize);
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+	vertexBufferView.BufferLocation = allocation.gpuAddress;
+	vertexBufferView.SizeInBytes = static_cast<UINT>(vertexSize);
+	vertexBufferView.StrideInBytes = sizeof(SpriteBatch::Vertex);
+
+	// 3Dの描画やパーティクルより後に描くように、一番上の層に積む(区間は列を実行するまで持たせる)
+	dxCommon_->GetRenderQueue().Submit(RenderQueue::MakeKey(RenderQueue::Layer::Overlay, 0, 0, 0, 0), [this, vertexBufferView, runs = spriteBatch_.GetRuns()]()
+		{
+			BindPipeline();
+			commandList_->IASetVertexBuffers(0, 1, &vertexBufferView);
+			commandList_->IASetIndexBuffer(&indexBufferView_);
+
+			// 同じテクスチャが続く区間ごとに1回描画する(インデックスバッファに収まらない分は分けて描く)
+			SrvManager* srvManager = TextureManager::GetInstance()->GetSrvManager();
+			for (const SpriteBatch::Run& run : runs)
+			{
+				srvManager->SetGraphicsRootDescriptorTable(0, run.textureIndex);
+				for (uint32_t drawn = 0; drawn < run.quadCount; drawn += kMaxQuadCount_)
+				{
+					const uint32_t quadCount = (std::min)(run.quadCount - drawn, kMaxQuadCount_);
+					const INT baseVertex = static_cast<INT>((run.quadStart + drawn) * SpriteBatch::kVerticesPerQuad);
+					commandList_->DrawIndexedInstanced(quadCount * SpriteBatch::kIndicesPerQuad, 1, 0, baseVertex, 0);
+				}
+			}
+		});
+
+	spriteBatch_.Clear();
+}
@@ -5,6 +5,7 @@
 
 #include "DirectXCommon.h"
 #include "Logger.h"
+#include "SpriteBatch.h"
 
 /// <summary>
 /// スプライト共通クラス
@@ -40,8 +41,20 @@ public:
 	// グラフィックスパイプラインの生成
 	void CreateGraphicsPipeline();
 
-	// 共通描画設定
-	void CommonDrawSetting();
+	/// <summary>
+	/// まとめ描画に四角形を積む(FlushDrawsでテクスチャごとにまとめて描画する)
+	/// </summary>
+	/// <param name="layer">層(小さいものから描く)</param>
+	/// <param name="textureIndex">テクスチャのSRVの番号</param>
+	/// <param name="vertices">クリップ座標まで変換した頂点</param>
+	void AddQuad(uint32_t layer, uint32_t textureIndex, const SpriteBatch::Vertex (&vertices)[SpriteBatch::kVerticesPerQuad]);
+
+	/// <summary>
+	/// 積んだ四角形を層の順に並べ(同じテクスチャが続くものはまとめ)、1つの頂点バッファに詰めて並べ替えの列のOverlayの層に積む
+	/// テクスチャの区間ごとに1回ずつの描画はMyGame::Drawで列を実行するときに行う
+	/// シーンのスプライトを積み終えたら1回呼ぶ
+	/// </summary>
+	void FlushDraws();
 
 public: // ゲッター
 
@@ -51,6 +64,11 @@ public: // ゲッター
 	/// <returns>DirectXCommonのポインタ</returns>
 	DirectXCommon* GetDxCommon() const { return dxCommon_; }
 
+private:
+
+	// 共通描画設定(並べ替えた列の中から呼ぶ)
+	void BindPipeline();
+
 private:
 
 	DirectXCommon* dxCommon_;
@@ -81,4 +99,14 @@ private:
 	//PSOを生成する
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_ = nullptr;
 
+	// 1回の描画で描ける四角形の数(インデックスバッファの大きさ)
+	static const uint32_t kMaxQuadCount_ = 1024;
+
+	// 四角形の並びを共通で使うインデックスバッファ(ベース頂点をずらして使い回す)
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_ = nullptr;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
+
+	// このフレームに積まれた四角形
+	SpriteBatch spriteBatch_;
+
 };
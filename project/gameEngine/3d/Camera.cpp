@@ -15,10 +15,25 @@ Camera::Camera()
 
 void Camera::Update()
 {
-	worldMatrix_= MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
-	viewMatrix_ = Inverse(worldMatrix_);
-	projectionMatrix_ = MakePerspectiveFovMatrix(fovY_, aspectRatio_, nearClip_, farClip_);
+	if (!isViewDirty_ && !isProjectionDirty_)
+	{
+		return;
+	}
+
+	if (isViewDirty_)
+	{
+		worldMatrix_ = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
+		viewMatrix_ = Inverse(worldMatrix_);
+	}
+	if (isProjectionDirty_)
+	{
+		projectionMatrix_ = MakePerspectiveFovMatrix(fovY_, aspectRatio_, nearClip_, farClip_);
+	}
 	viewProjectionMatrix_ = viewMatrix_ * projectionMatrix_;
+
+	isViewDirty_ = false;
+	isProjectionDirty_ = false;
+	++matrixVersion_;
 }
 
 void Camera::StartShake(float duration, float magnitude)
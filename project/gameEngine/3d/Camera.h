@@ -15,7 +15,7 @@ public:
 	Camera();
 	
 	/// <summary>
-	/// 更新
+	/// 更新(設定が変わったときだけ行列を作り直す)
 	/// </summary>
 	void Update();
 
@@ -40,37 +40,37 @@ public: // セッター
 	/// 回転を設定
 	/// </summary>
 	/// <param name="rotate">回転</param>
-	void SetRotate(Vector3 rotate) { transform_.rotate = rotate; }
+	void SetRotate(Vector3 rotate) { transform_.rotate = rotate; isViewDirty_ = true; }
 	
 	/// <summary>
 	/// 位置を設定
 	/// </summary>
 	/// <param name="translate">位置</param>
-	void SetPosition(Vector3 translate) { transform_.translate = translate; }
+	void SetPosition(Vector3 translate) { transform_.translate = translate; isViewDirty_ = true; }
 	
 	/// <summary>
 	/// 視野角を設定
 	/// </summary>
 	/// <param name="fovY">視野角</param>
-	void SetFovY(float fovY) { fovY_ = fovY; }
+	void SetFovY(float fovY) { fovY_ = fovY; isProjectionDirty_ = true; }
 	
 	/// <summary>
 	/// アスペクト比を設定
 	/// </summary>
 	/// <param name="aspectRatio">アスペクト比</param>
-	void SetAspectRatio(float aspectRatio) { aspectRatio_ = aspectRatio; }
+	void SetAspectRatio(float aspectRatio) { aspectRatio_ = aspectRatio; isProjectionDirty_ = true; }
 	
 	/// <summary>
 	/// ニアクリップ距離を設定
 	/// </summary>
 	/// <param name="nearClip">ニアクリップ距離</param>
-	void SetNearClip(float nearClip) { nearClip_ = nearClip; }
+	void SetNearClip(float nearClip) { nearClip_ = nearClip; isProjectionDirty_ = true; }
 
 	/// <summary>
 	/// ファークリップ距離を設定
 	/// </summary>
 	/// <param name="farClip">ファークリップ距離</param>
-	void SetFarClip(float farClip) { farClip_ = farClip; }
+	void SetFarClip(float farClip) { farClip_ = farClip; isProjectionDirty_ = true; }
 
 public: // ゲッター
 
@@ -80,6 +80,12 @@ public: // ゲッター
 	// 位置の取得
 	const Vector3& GetPosition() const { return transform_.translate; }
 
+	// 垂直方向視野角の取得
+	float GetFovY() const { return fovY_; }
+
+	// ファークリップ距離の取得
+	float GetFarClip() const { return farClip_; }
+
 	// ワールド行列の取得
 	const Matrix4x4& GetWorldMatrix() const { return worldMatrix_; }
 	
@@ -95,6 +101,9 @@ public: // ゲッター
 	// シェイク中かどうか取得
 	bool IsShaking() const { return isShaking_; }
 
+	// ビュープロジェクション行列を作り直した回数(Object3dが作り直しの要否を判断するのに使う)
+	uint32_t GetMatrixVersion() const { return matrixVersion_; }
+
 private:
 
 	struct Transform
@@ -118,6 +127,12 @@ private:
 
 	Matrix4x4 viewProjectionMatrix_{};
 
+	// 行列の作り直しが必要か(セッターで立てる)
+	bool isViewDirty_ = false;
+	bool isProjectionDirty_ = false;
+	// ビュープロジェクション行列を作り直した回数
+	uint32_t matrixVersion_ = 0;
+
 	// シェイクのための変数
 	bool isShaking_ = false;
 	float shakeDuration_ = 0.0f;
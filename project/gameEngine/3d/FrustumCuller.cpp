@@ -0,0 +1,146 @@
+#include "FrustumCuller.h"
+
+#include <cassert>
+#include <cmath>
+#include <xmmintrin.h>
+
+uint32_t FrustumCuller::Register()
+{
+	// 空きがなければ4つ分まとめて増やす(SIMDで読むときに端数を気にしなくてよいように)
+	if (freeIndices_.empty())
+	{
+		const uint32_t oldSize = static_cast<uint32_t>(isUsed_.size());
+		const uint32_t newSize = oldSize + kLaneCount_;
+		centerX_.resize(newSize, 0.0f);
+		centerY_.resize(newSize, 0.0f);
+		centerZ_.resize(newSize, 0.0f);
+		extentX_.resize(newSize, 0.0f);
+		extentY_.resize(newSize, 0.0f);
+		extentZ_.resize(newSize, 0.0f);
+		isUsed_.resize(newSize, 0);
+		visible_.resize(newSize, 0);
+		for (uint32_t i = newSize; i > oldSize; --i)
+		{
+			freeIndices_.push_back(i - 1);
+		}
+	}
+
+	const uint32_t index = freeIndices_.back();
+	freeIndices_.pop_back();
+	isUsed_[index] = 1;
+	// 次の判定までは見えている扱い
+	visible_[index] = 1;
+	SetAlwaysVisible(index);
+	++registeredCount_;
+	return index;
+}
+
+void FrustumCuller::Unregister(uint32_t index)
+{
+	if (index >= isUsed_.size() || !isUsed_[index])
+	{
+		return;
+	}
+	isUsed_[index] = 0;
+	visible_[index] = 0;
+	freeIndices_.push_back(index);
+	--registeredCount_;
+}
+
+void FrustumCuller::SetBounds(uint32_t index, const Vector3& center, const Vector3& extent)
+{
+	assert(index < isUsed_.size() && isUsed_[index]);
+	centerX_[index] = center.x;
+	centerY_[index] = center.y;
+	centerZ_[index] = center.z;
+	extentX_[index] = extent.x;
+	extentY_[index] = extent.y;
+	extentZ_[index] = extent.z;
+}
+
+void FrustumCuller::SetAlwaysVisible(uint32_t index)
+{
+	SetBounds(index, { 0.0f, 0.0f, 0.0f }, { kUnboundedExtent_, kUnboundedExtent_, kUnboundedExtent_ });
+}
+
+void FrustumCuller::Cull(const Matrix4x4& viewProjection)
+{
+	// 行ベクトルに掛ける行列なので、クリップ座標の各成分は列との内積になる
+	// 左右下上は -w <= x,y <= w、手前奥は 0 <= z <= w の内側
+	const Matrix4x4& m = viewProjection;
+	const float planes[6][4] =
+	{
+		{ m.m[0][3] + m.m[0][0], m.m[1][3] + m.m[1][0], m.m[2][3] + m.m[2][0], m.m[3][3] + m.m[3][0] },
+		{ m.m[0][3] - m.m[0][0], m.m[1][3] - m.m[1][0], m.m[2][3] - m.m[2][0], m.m[3][3] - m.m[3][0] },
+		{ m.m[0][3] + m.m[0][1], m.m[1][3] + m.m[1][1], m.m[2][3] + m.m[2][1], m.m[3][3] + m.m[3][1] },
+		{ m.m[0][3] - m.m[0][1], m.m[1][3] - m.m[1][1], m.m[2][3] - m.m[2][1], m.m[3][3] - m.m[3][1] },
+		{ m.m[0][2],             m.m[1][2],             m.m[2][2],             m.m[3][2] },
+		{ m.m[0][3] - m.m[0][2], m.m[1][3] - m.m[1][2], m.m[2][3] - m.m[2][2], m.m[3][3] - m.m[3][2] },
+	};
+
+	// 平面の各成分を4レーンに広げておく(法線は半分の大きさとの内積に使う絶対値も)
+	__m128 normalX[6], normalY[6], normalZ[6], distance[6];
+	__m128 absNormalX[6], absNormalY[6], absNormalZ[6];
+	for (int i = 0; i < 6; ++i)
+	{
+		normalX[i] = _mm_set1_ps(planes[i][0]);
+		normalY[i] = _mm_set1_ps(planes[i][1]);
+		normalZ[i] = _mm_set1_ps(planes[i][2]);
+		distance[i] = _mm_set1_ps(planes[i][3]);
+		absNormalX[i] = _mm_set1_ps(std::abs(planes[i][0]));
+		absNormalY[i] = _mm_set1_ps(std::abs(planes[i][1]));
+		absNormalZ[i] = _mm_set1_ps(std::abs(planes[i][2]));
+	}
+
+	visibleIndices_.clear();
+	const __m128 zero = _mm_setzero_ps();
+	const uint32_t count = static_cast<uint32_t>(isUsed_.size());
+	for (uint32_t base = 0; base < count; base += kLaneCount_)
+	{
+		const __m128 centerX = _mm_loadu_ps(&centerX_[base]);
+		const __m128 centerY = _mm_loadu_ps(&centerY_[base]);
+		const __m128 centerZ = _mm_loadu_ps(&centerZ_[base]);
+		const __m128 extentX = _mm_loadu_ps(&extentX_[base]);
+		const __m128 extentY = _mm_loadu_ps(&extentY_[base]);
+		const __m128 extentZ = _mm_loadu_ps(&extentZ_[base]);
+
+		// 中心の符号付き距離に、法線方向へ最も張り出した分を足しても負なら外側
+		__m128 inside = _mm_cmpeq_ps(zero, zero);
+		for (int i = 0; i < 6; ++i)
+		{
+			__m128 d = _mm_add_ps(_mm_mul_ps(normalX[i], centerX), _mm_mul_ps(normalY[i], centerY));
+			d = _mm_add_ps(d, _mm_mul_ps(normalZ[i], centerZ));
+			d = _mm_add_ps(d, distance[i]);
+			__m128 r = _mm_add_ps(_mm_mul_ps(absNormalX[i], extentX), _mm_mul_ps(absNormalY[i], extentY));
+			r = _mm_add_ps(r, _mm_mul_ps(absNormalZ[i], extentZ));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), zero));
+		}
+
+		const int mask = _mm_movemask_ps(inside);
+		for (uint32_t lane = 0; lane < kLaneCount_; ++lane)
+		{
+			const uint32_t index = base + lane;
+			const bool isVisible = isUsed_[index] && (mask & (1 << lane)) != 0;
+			visible_[index] = isVisible ? 1 : 0;
+			if (isVisible)
+			{
+				visibleIndices_.push_back(index);
+			}
+		}
+	}
+}
+
+void FrustumCuller::TransformBounds(const Vector3& localMin, const Vector3& localMax, const Matrix4x4& world, Vector3& center, Vector3& extent)
+{
+	const Vector3 localCenter = { (localMin.x + localMax.x) * 0.5f, (localMin.y + localMax.y) * 0.5f, (localMin.z + localMax.z) * 0.5f };
+	const Vector3 localExtent = { (localMax.x - localMin.x) * 0.5f, (localMax.y - localMin.y) * 0.5f, (localMax.z - localMin.z) * 0.5f };
+
+	// 中心は点として変換し、半分の大きさは行列の絶対値で広げる
+	const Matrix4x4& m = world;
+	center.x = localCenter.x * m.m[0][0] + localCenter.y * m.m[1][0] + localCenter.z * m.m[2][0] + m.m[3][0];
+	center.y = localCenter.x * m.m[0][1] + localCenter.y * m.m[1][1] + localCenter.z * m.m[2][1] + m.m[3][1];
+	center.z = localCenter.x * m.m[0][2] + localCenter.y * m.m[1][2] + localCenter.z * m.m[2][2] + m.m[3][2];
+	extent.x = localExtent.x * std::abs(m.m[0][0]) + localExtent.y * std::abs(m.m[1][0]) + localExtent.z * std::abs(m.m[2][0]);
+	extent.y = localExtent.x * std::abs(m.m[0][1]) + localExtent.y * std::abs(m.m[1][1]) + localExtent.z * std::abs(m.m[2][1]);
+	extent.z = localExtent.x * std::abs(m.m[0][2]) + localExtent.y * std::abs(m.m[1][2]) + localExtent.z * std::abs(m.m[2][2]);
+}
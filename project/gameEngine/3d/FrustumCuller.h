@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Vector3.h"
+#include "Matrix4x4.h"
+
+/// <summary>
+/// 視錐台カリング
+/// オブジェクトごとに枠を持たせてワールド空間のAABB(中心と半分の大きさ)を詰めて並べ、
+/// 視錐台の6平面とまとめて4つずつSIMDで判定する
+/// デバイスを使わないので、判定の結果だけを取り出して確かめられる
+/// </summary>
+class FrustumCuller
+{
+public:
+
+	// 枠を持っていないときの番号
+	static const uint32_t kInvalidIndex = UINT32_MAX;
+
+public:
+
+	/// <summary>
+	/// 枠を確保する(範囲を設定するまでは常に見えている扱い)
+	/// </summary>
+	/// <returns>枠の番号</returns>
+	uint32_t Register();
+
+	/// <summary>
+	/// 枠を返す
+	/// </summary>
+	/// <param name="index">枠の番号</param>
+	void Unregister(uint32_t index);
+
+	/// <summary>
+	/// ワールド空間のAABBを設定する
+	/// </summary>
+	/// <param name="index">枠の番号</param>
+	/// <param name="center">中心</param>
+	/// <param name="extent">各軸の半分の大きさ</param>
+	void SetBounds(uint32_t index, const Vector3& center, const Vector3& extent);
+
+	/// <summary>
+	/// 常に見えている扱いにする(別のカメラで描くもの等)
+	/// </summary>
+	/// <param name="index">枠の番号</param>
+	void SetAlwaysVisible(uint32_t index);
+
+	/// <summary>
+	/// ビュープロジェクション行列から視錐台を取り出し、すべての枠を判定する
+	/// </summary>
+	/// <param name="viewProjection">ビュープロジェクション行列</param>
+	void Cull(const Matrix4x4& viewProjection);
+
+	/// <summary>
+	/// ローカル空間のAABBをワールド行列で変換し、それを囲むAABBを求める
+	/// </summary>
+	/// <param name="localMin">ローカル空間の最小点</param>
+	/// <param name="localMax">ローカル空間の最大点</param>
+	/// <param name="world">ワールド行列</param>
+	/// <param name="center">ワールド空間の中心</param>
+	/// <param name="extent">ワールド空間の各軸の半分の大きさ</param>
+	static void TransformBounds(const Vector3& localMin, const Vector3& localMax, const Matrix4x4& world, Vector3& center, Vector3& extent);
+
+public: // ゲッター
+
+	// 最後の判定で見えていたか(枠を持っていなければ見えている扱い)
+	bool IsVisible(uint32_t index) const { return index >= visible_.size() || visible_[index] != 0; }
+
+	// 最後の判定で見えていた枠の番号(小さい順)
+	const std::vector<uint32_t>& GetVisibleIndices() const { return visibleIndices_; }
+
+	// 使用中の枠の数
+	uint32_t GetRegisteredCount() const { return registeredCount_; }
+
+private:
+
+	// 範囲を設定していない枠に入れる大きさ(どの平面に対しても内側になる)
+	static constexpr float kUnboundedExtent_ = 1.0e30f;
+	// SIMDで一度に判定する数(枠はこの倍数ずつ増やす)
+	static const uint32_t kLaneCount_ = 4;
+
+private:
+
+	// 詰めて並べたAABB(SoA)
+	std::vector<float> centerX_;
+	std::vector<float> centerY_;
+	std::vector<float> centerZ_;
+	std::vector<float> extentX_;
+	std::vector<float> extentY_;
+	std::vector<float> extentZ_;
+	// 使用中か
+	std::vector<uint8_t> isUsed_;
+
+	// 判定の結果
+	std::vector<uint8_t> visible_;
+	std::vector<uint32_t> visibleIndices_;
+
+	// 空いている枠
+	std::vector<uint32_t> freeIndices_;
+	uint32_t registeredCount_ = 0;
+};
@@ -0,0 +1,56 @@
+#include "InstanceBatcher.h"
+
+void InstanceBatcher::Add(Model* model, uint32_t lodIndex, const Object3d* object, const InstanceData& instance)
+{
+	entries_.push_back({ model, lodIndex, object, instance });
+}
+
+void InstanceBatcher::Build()
+{
+	groups_.clear();
+	sortedInstances_.clear();
+
+	// 各インスタンスがどのグループに入るか(グループの数は少ないので線形に探す)
+	std::vector<uint32_t> groupIndices(entries_.size());
+	for (size_t i = 0; i < entries_.size(); ++i)
+	{
+		const Entry& entry = entries_[i];
+		uint32_t groupIndex = 0;
+		while (groupIndex < groups_.size() &&
+			!(groups_[groupIndex].model == entry.model && groups_[groupIndex].lodIndex == entry.lodIndex))
+		{
+			++groupIndex;
+		}
+		if (groupIndex == groups_.size())
+		{
+			groups_.push_back({ entry.model, entry.lodIndex, entry.object, 0, 0 });
+		}
+		++groups_[groupIndex].instanceCount;
+		groupIndices[i] = groupIndex;
+	}
+
+	// グループごとの先頭を決めてから詰める(グループ内は積まれた順のまま)
+	uint32_t instanceStart = 0;
+	for (Group& group : groups_)
+	{
+		group.instanceStart = instanceStart;
+		instanceStart += group.instanceCount;
+	}
+	sortedInstances_.resize(entries_.size());
+	std::vector<uint32_t> cursor(groups_.size());
+	for (size_t i = 0; i < groups_.size(); ++i)
+	{
+		cursor[i] = groups_[i].instanceStart;
+	}
+	for (size_t i = 0; i < entries_.size(); ++i)
+	{
+		sortedInstances_[cursor[groupIndices[i]]++] = entries_[i].instance;
+	}
+}
+
+void InstanceBatcher::Clear()
+{
+	entries_.clear();
+	groups_.clear();
+	sortedInstances_.clear();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "Matrix4x4.h"
+
+class Model;
+class Object3d;
+
+/// <summary>
+/// 同じモデル・同じ詳細度の段のインスタンスをまとめて1回の描画にする
+/// デバイスを使わないので、並べ替えの結果だけを取り出して確かめられる
+/// </summary>
+class InstanceBatcher
+{
+public:
+
+	// 1インスタンス分の座標変換行列(Object3d.VS.hlslのTransformationMatrixと同じ並び)
+	struct InstanceData
+	{
+		Matrix4x4 WVP;
+		Matrix4x4 World;
+		Matrix4x4 WorldInvTranspose;
+	};
+
+	// まとめた描画1回分
+	struct Group
+	{
+		Model* model;
+		uint32_t lodIndex;
+		// ライト等の定数を借りるオブジェクト(グループの最初に積まれたもの)
+		const Object3d* firstObject;
+		uint32_t instanceStart;
+		uint32_t instanceCount;
+	};
+
+public:
+
+	/// <summary>
+	/// インスタンスを積む
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="lodIndex">詳細度の段</param>
+	/// <param name="object">積んだオブジェクト</param>
+	/// <param name="instance">座標変換行列</param>
+	void Add(Model* model, uint32_t lodIndex, const Object3d* object, const InstanceData& instance);
+
+	/// <summary>
+	/// 積んだインスタンスをモデルと詳細度の段ごとにまとめる
+	/// グループは最初に積まれた順、グループ内は積まれた順に並ぶ
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// 積んだインスタンスとまとめた結果を捨てる
+	/// </summary>
+	void Clear();
+
+public: // ゲッター
+
+	// まとめた描画の一覧(Buildの後で有効)
+	const std::vector<Group>& GetGroups() const { return groups_; }
+
+	// グループ順に詰めた座標変換行列(Buildの後で有効)
+	const std::vector<InstanceData>& GetInstances() const { return sortedInstances_; }
+
+	// 積まれているインスタンスの数
+	size_t GetInstanceCount() const { return entries_.size(); }
+
+private:
+
+	// 積まれた1インスタンス
+	struct Entry
+	{
+		Model* model;
+		uint32_t lodIndex;
+		const Object3d* object;
+		InstanceData instance;
+	};
+
+private:
+
+	std::vector<Entry> entries_;
+	std::vector<Group> groups_;
+	std::vector<InstanceData> sortedInstances_;
+};
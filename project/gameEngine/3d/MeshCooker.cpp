@@ -0,0 +1,411 @@
+#include "MeshCooker.h"
+
+#include <Windows.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+namespace
+{
+	// FNV-1aにバイト列を混ぜる
+	void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	constexpr uint64_t kHashBasis = 14695981039346656037ull;
+
+	// 読み込み位置から指定サイズを取り出す
+	bool ReadBytes(const uint8_t*& cursor, const uint8_t* end, void* dst, size_t size)
+	{
+		if (static_cast<size_t>(end - cursor) < size)
+		{
+			return false;
+		}
+		std::memcpy(dst, cursor, size);
+		cursor += size;
+		return true;
+	}
+
+	// 書き出し先の末尾に追加
+	void WriteBytes(std::string& buffer, const void* src, size_t size)
+	{
+		buffer.append(static_cast<const char*>(src), size);
+	}
+}
+
+bool MeshCooker::Load(const std::string& sourceFilePath, Model::ModelData& modelData)
+{
+	if (!std::filesystem::exists(sourceFilePath))
+	{
+		return false;
+	}
+
+	// 変換済みファイルをメモリマップで開く
+	const std::string cookedFilePath = GetCookedFilePath(sourceFilePath);
+	HANDLE file = CreateFileA(cookedFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	HANDLE mapping = nullptr;
+	const uint8_t* view = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart >= static_cast<LONGLONG>(sizeof(Header)))
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping)
+		{
+			view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+	}
+
+	bool result = false;
+	// 中身は同じで更新時刻だけが変わっていたらヘッダーを書き直す
+	bool isStampChanged = false;
+	Header header{};
+	if (view)
+	{
+		const uint8_t* cursor = view;
+		const uint8_t* end = view + fileSize.QuadPart;
+
+		ReadBytes(cursor, end, &header, sizeof(Header));
+
+		bool isValid =
+			std::memcmp(header.magic, kMagic_, sizeof(kMagic_)) == 0 &&
+			header.version == kVersion_ &&
+			header.vertexStride == sizeof(Model::VertexData) &&
+			header.dependencyCount <= static_cast<size_t>(end - cursor) / sizeof(uint32_t);
+
+		// 依存ファイル一覧
+		std::vector<std::string> dependencies(isValid ? header.dependencyCount : 0);
+		for (std::string& dependency : dependencies)
+		{
+			uint32_t pathLength = 0;
+			isValid = isValid &&
+				ReadBytes(cursor, end, &pathLength, sizeof(uint32_t)) &&
+				static_cast<size_t>(end - cursor) >= pathLength;
+			if (isValid)
+			{
+				dependency.assign(reinterpret_cast<const char*>(cursor), pathLength);
+				cursor += pathLength;
+			}
+		}
+
+		// 配列を確保する前に、ヘッダーの数が残りのデータ量に収まるかを確かめる
+		// (壊れたファイルの数をそのまま使って巨大な確保をしないように。マテリアルはパスの長さの分だけ数える)
+		const uint64_t requiredSize =
+			static_cast<uint64_t>(header.vertexCount) * sizeof(Model::VertexData) +
+			static_cast<uint64_t>(header.indexCount) * sizeof(uint32_t) +
+			static_cast<uint64_t>(header.materialCount) * sizeof(uint32_t) +
+			static_cast<uint64_t>(header.subMeshCount) * sizeof(Model::SubMesh) +
+			static_cast<uint64_t>(header.lodCount) * sizeof(Model::LodLevel);
+		isValid = isValid && requiredSize <= static_cast<uint64_t>(end - cursor);
+
+		// 更新時刻が違っても中身が同じなら使う(チェックアウトし直した場合など)
+		if (isValid)
+		{
+			const uint64_t stamp = MakeStamp(dependencies);
+			if (header.sourceStamp != stamp)
+			{
+				isValid = header.sourceHash == HashFiles(dependencies);
+				isStampChanged = isValid;
+				header.sourceStamp = stamp;
+			}
+		}
+
+		if (isValid)
+		{
+			Model::ModelData cooked;
+			cooked.vertices.resize(header.vertexCount);
+			cooked.indices.resize(header.indexCount);
+			cooked.materials.resize(header.materialCount);
+			cooked.subMeshes.resize(header.subMeshCount);
+			cooked.lods.resize(header.lodCount);
+			cooked.vertexFormat = static_cast<Model::VertexFormat>(header.vertexFormat);
+
+			result =
+				ReadBytes(cursor, end, cooked.vertices.data(), sizeof(Model::VertexData) * header.vertexCount) &&
+				ReadBytes(cursor, end, cooked.indices.data(), sizeof(uint32_t) * header.indexCount);
+			for (Model::MaterialData& material : cooked.materials)
+			{
+				uint32_t pathLength = 0;
+				result = result &&
+					ReadBytes(cursor, end, &pathLength, sizeof(uint32_t)) &&
+					static_cast<size_t>(end - cursor) >= pathLength;
+				if (result)
+				{
+					material.textureFilePath.assign(reinterpret_cast<const char*>(cursor), pathLength);
+					cursor += pathLength;
+				}
+			}
+			result = result &&
+				ReadBytes(cursor, end, cooked.subMeshes.data(), sizeof(Model::SubMesh) * header.subMeshCount) &&
+				ReadBytes(cursor, end, cooked.lods.data(), sizeof(Model::LodLevel) * header.lodCount) &&
+				ReadNode(cursor, end, cooked.rootNode) &&
+				HasValidRanges(cooked);
+
+			if (result)
+			{
+				modelData = std::move(cooked);
+			}
+		}
+
+		UnmapViewOfFile(view);
+	}
+
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+
+	// 次の起動で中身を読み直さないように、新しい更新時刻をヘッダーに書き込む
+	if (result && isStampChanged)
+	{
+		std::fstream cookedFile(cookedFilePath, std::ios::binary | std::ios::in | std::ios::out);
+		if (cookedFile.is_open())
+		{
+			cookedFile.seekp(0);
+			cookedFile.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		}
+	}
+
+	return result;
+}
+
+bool MeshCooker::Save(const std::string& sourceFilePath, const Model::ModelData& modelData)
+{
+	Header header{};
+	std::memcpy(header.magic, kMagic_, sizeof(kMagic_));
+	header.version = kVersion_;
+	if (!std::filesystem::exists(sourceFilePath))
+	{
+		return false;
+	}
+	const std::vector<std::string> dependencies = CollectDependencies(sourceFilePath, modelData);
+	header.sourceStamp = MakeStamp(dependencies);
+	header.sourceHash = HashFiles(dependencies);
+	header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+	header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+	header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+	header.vertexStride = sizeof(Model::VertexData);
+	header.materialCount = static_cast<uint32_t>(modelData.materials.size());
+	header.subMeshCount = static_cast<uint32_t>(modelData.subMeshes.size());
+	header.lodCount = static_cast<uint32_t>(modelData.lods.size());
+	header.vertexFormat = static_cast<uint32_t>(modelData.vertexFormat);
+
+	// ヘッダー、依存ファイル、頂点、インデックス、マテリアル、サブメッシュ、ノードの順に詰める
+	std::string buffer;
+	buffer.reserve(sizeof(Header) + sizeof(Model::VertexData) * header.vertexCount + sizeof(uint32_t) * header.indexCount);
+	WriteBytes(buffer, &header, sizeof(Header));
+	for (const std::string& dependency : dependencies)
+	{
+		const uint32_t pathLength = static_cast<uint32_t>(dependency.size());
+		WriteBytes(buffer, &pathLength, sizeof(uint32_t));
+		WriteBytes(buffer, dependency.data(), pathLength);
+	}
+	WriteBytes(buffer, modelData.vertices.data(), sizeof(Model::VertexData) * header.vertexCount);
+	WriteBytes(buffer, modelData.indices.data(), sizeof(uint32_t) * header.indexCount);
+	for (const Model::MaterialData& material : modelData.materials)
+	{
+		const uint32_t pathLength = static_cast<uint32_t>(material.textureFilePath.size());
+		WriteBytes(buffer, &pathLength, sizeof(uint32_t));
+		WriteBytes(buffer, material.textureFilePath.data(), pathLength);
+	}
+	WriteBytes(buffer, modelData.subMeshes.data(), sizeof(Model::SubMesh) * header.subMeshCount);
+	WriteBytes(buffer, modelData.lods.data(), sizeof(Model::LodLevel) * header.lodCount);
+	WriteNode(modelData.rootNode, buffer);
+
+	std::ofstream file(GetCookedFilePath(sourceFilePath), std::ios::binary | std::ios::trunc);
+	if (file.fail())
+	{
+		return false;
+	}
+	file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+	return !file.fail();
+}
+
+Model::VertexFormat MeshCooker::SelectVertexFormat(const Model::ModelData& modelData)
+{
+	if (modelData.vertices.empty())
+	{
+		return Model::VertexFormat::Full;
+	}
+
+	// 位置とUVの範囲を求める
+	const Vector4& firstPosition = modelData.vertices.front().position;
+	Vector3 positionMin = { firstPosition.x, firstPosition.y, firstPosition.z };
+	Vector3 positionMax = positionMin;
+	Vector2 texcoordMin = modelData.vertices.front().texcoord;
+	Vector2 texcoordMax = texcoordMin;
+	for (const Model::VertexData& vertex : modelData.vertices)
+	{
+		positionMin = { (std::min)(positionMin.x, vertex.position.x), (std::min)(positionMin.y, vertex.position.y), (std::min)(positionMin.z, vertex.position.z) };
+		positionMax = { (std::max)(positionMax.x, vertex.position.x), (std::max)(positionMax.y, vertex.position.y), (std::max)(positionMax.z, vertex.position.z) };
+		texcoordMin = { (std::min)(texcoordMin.x, vertex.texcoord.x), (std::min)(texcoordMin.y, vertex.texcoord.y) };
+		texcoordMax = { (std::max)(texcoordMax.x, vertex.texcoord.x), (std::max)(texcoordMax.y, vertex.texcoord.y) };
+	}
+
+	// 16bitに詰めたときの1段の大きさが許容誤差に収まるなら圧縮する
+	const float positionExtent = (std::max)({ positionMax.x - positionMin.x, positionMax.y - positionMin.y, positionMax.z - positionMin.z });
+	const float texcoordExtent = (std::max)(texcoordMax.x - texcoordMin.x, texcoordMax.y - texcoordMin.y);
+	const bool isCompactable =
+		positionExtent / 65535.0f <= kMaxPositionError_ &&
+		texcoordExtent / 65535.0f <= kMaxTexcoordError_;
+	return isCompactable ? Model::VertexFormat::Compact : Model::VertexFormat::Full;
+}
+
+std::vector<std::string> MeshCooker::CollectDependencies(const std::string& sourceFilePath, const Model::ModelData& modelData)
+{
+	std::vector<std::string> dependencies = { sourceFilePath };
+	auto add = [&dependencies](const std::string& filePath)
+		{
+			if (std::find(dependencies.begin(), dependencies.end(), filePath) == dependencies.end())
+			{
+				dependencies.push_back(filePath);
+			}
+		};
+
+	// 元ファイルが参照する.mtl(マテリアルを書き換えたら作り直す)
+	const std::string directoryPath = std::filesystem::path(sourceFilePath).parent_path().generic_string();
+	std::ifstream source(sourceFilePath);
+	std::string line;
+	while (std::getline(source, line))
+	{
+		std::istringstream stream(line);
+		std::string identifier;
+		stream >> identifier;
+		if (identifier == "mtllib")
+		{
+			std::string mtlFileName;
+			stream >> mtlFileName;
+			add(directoryPath + "/" + mtlFileName);
+		}
+	}
+
+	// マテリアルのテクスチャ
+	for (const Model::MaterialData& material : modelData.materials)
+	{
+		add(material.textureFilePath);
+	}
+
+	return dependencies;
+}
+
+uint64_t MeshCooker::MakeStamp(const std::vector<std::string>& filePaths)
+{
+	uint64_t stamp = kHashBasis;
+	for (const std::string& filePath : filePaths)
+	{
+		// 無いファイルはサイズと時刻を0として混ぜる(後から置かれたら変わる)
+		std::error_code ec;
+		uint64_t size = std::filesystem::file_size(filePath, ec);
+		int64_t writeTime = 0;
+		if (ec)
+		{
+			size = 0;
+		}
+		else
+		{
+			writeTime = static_cast<int64_t>(std::filesystem::last_write_time(filePath, ec).time_since_epoch().count());
+		}
+		HashBytes(stamp, filePath.data(), filePath.size());
+		HashBytes(stamp, &size, sizeof(size));
+		HashBytes(stamp, &writeTime, sizeof(writeTime));
+	}
+	return stamp;
+}
+
+uint64_t MeshCooker::HashFiles(const std::vector<std::string>& filePaths)
+{
+	uint64_t hash = kHashBasis;
+	char chunk[4096];
+	for (const std::string& filePath : filePaths)
+	{
+		// ファイルの区切りとしてパスも混ぜる
+		HashBytes(hash, filePath.data(), filePath.size());
+
+		std::ifstream file(filePath, std::ios::binary);
+		while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+		{
+			HashBytes(hash, chunk, static_cast<size_t>(file.gcount()));
+		}
+	}
+	return hash;
+}
+
+void MeshCooker::WriteNode(const Model::Node& node, std::string& buffer)
+{
+	const uint32_t nameLength = static_cast<uint32_t>(node.name.size());
+	const uint32_t childCount = static_cast<uint32_t>(node.children.size());
+	WriteBytes(buffer, &node.localMatrix, sizeof(Matrix4x4));
+	WriteBytes(buffer, &nameLength, sizeof(uint32_t));
+	WriteBytes(buffer, node.name.data(), nameLength);
+	WriteBytes(buffer, &childCount, sizeof(uint32_t));
+	for (const Model::Node& child : node.children)
+	{
+		WriteNode(child, buffer);
+	}
+}
+
+bool MeshCooker::ReadNode(const uint8_t*& cursor, const uint8_t* end, Model::Node& node)
+{
+	uint32_t nameLength = 0;
+	if (!ReadBytes(cursor, end, &node.localMatrix, sizeof(Matrix4x4)) ||
+		!ReadBytes(cursor, end, &nameLength, sizeof(uint32_t)) ||
+		static_cast<size_t>(end - cursor) < nameLength)
+	{
+		return false;
+	}
+	node.name.assign(reinterpret_cast<const char*>(cursor), nameLength);
+	cursor += nameLength;
+
+	// 子の数が残りのデータ量に収まらなければ壊れている
+	uint32_t childCount = 0;
+	if (!ReadBytes(cursor, end, &childCount, sizeof(uint32_t)) ||
+		childCount > static_cast<size_t>(end - cursor) / (sizeof(Matrix4x4) + sizeof(uint32_t) * 2))
+	{
+		return false;
+	}
+	node.children.resize(childCount);
+	for (Model::Node& child : node.children)
+	{
+		if (!ReadNode(cursor, end, child))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MeshCooker::HasValidRanges(const Model::ModelData& modelData)
+{
+	// サブメッシュはインデックスとマテリアルの範囲内
+	for (const Model::SubMesh& subMesh : modelData.subMeshes)
+	{
+		if (static_cast<uint64_t>(subMesh.indexStart) + subMesh.indexCount > modelData.indices.size() ||
+			subMesh.materialIndex >= modelData.materials.size())
+		{
+			return false;
+		}
+	}
+
+	// 詳細度の段はサブメッシュの範囲内
+	for (const Model::LodLevel& lod : modelData.lods)
+	{
+		if (static_cast<uint64_t>(lod.subMeshStart) + lod.subMeshCount > modelData.subMeshes.size())
+		{
+			return false;
+		}
+	}
+	return true;
+}
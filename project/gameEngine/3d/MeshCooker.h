@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Model.h"
+
+/// <summary>
+/// モデルの変換済みバイナリ(.mesh)の書き出しと読み込み
+/// 2回目以降の起動ではAssimpを通さずにメモリマップから読み込む
+/// </summary>
+class MeshCooker
+{
+public:
+
+	/// <summary>
+	/// 変換済みバイナリの読み込み
+	/// 元ファイル、.mtl、テクスチャのどれかが更新されていれば失敗扱いにする
+	/// 更新時刻だけが変わって中身が同じならヘッダーの更新時刻を書き直す
+	/// </summary>
+	/// <param name="sourceFilePath">元のモデルファイルのパス</param>
+	/// <param name="modelData">読み込み先</param>
+	/// <returns>読み込めたか</returns>
+	static bool Load(const std::string& sourceFilePath, Model::ModelData& modelData);
+
+	/// <summary>
+	/// 変換済みバイナリの書き出し(元ファイルの隣に.meshを付けて置く)
+	/// </summary>
+	/// <param name="sourceFilePath">元のモデルファイルのパス</param>
+	/// <param name="modelData">書き出すデータ</param>
+	/// <returns>書き出せたか</returns>
+	static bool Save(const std::string& sourceFilePath, const Model::ModelData& modelData);
+
+	/// <summary>
+	/// 変換済みバイナリのパス
+	/// </summary>
+	/// <param name="sourceFilePath">元のモデルファイルのパス</param>
+	/// <returns>変換済みバイナリのパス</returns>
+	static std::string GetCookedFilePath(const std::string& sourceFilePath) { return sourceFilePath + ".mesh"; }
+
+	/// <summary>
+	/// GPUに置く頂点の形式を選ぶ
+	/// 位置とUVを16bitに詰めても誤差が許容範囲に収まるなら圧縮形式にする
+	/// </summary>
+	/// <param name="modelData">モデルデータ</param>
+	/// <returns>頂点の形式</returns>
+	static Model::VertexFormat SelectVertexFormat(const Model::ModelData& modelData);
+
+private:
+
+	// ファイルの先頭に置く情報
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		// 元ファイルと依存ファイルの情報(更新の確認用)
+		// stampはサイズと更新時刻から、hashは中身から作る
+		uint64_t sourceStamp;
+		uint64_t sourceHash;
+		uint32_t dependencyCount;
+		// 中身の数
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t vertexStride;
+		uint32_t materialCount;
+		uint32_t subMeshCount;
+		uint32_t lodCount;
+		uint32_t vertexFormat;
+	};
+
+	/// <summary>
+	/// キャッシュの中身に影響するファイルを集める
+	/// 元ファイル、元ファイルが参照する.mtl、マテリアルのテクスチャ
+	/// </summary>
+	/// <param name="sourceFilePath">元のモデルファイルのパス</param>
+	/// <param name="modelData">モデルデータ</param>
+	/// <returns>ファイルパス一覧(先頭は元ファイル)</returns>
+	static std::vector<std::string> CollectDependencies(const std::string& sourceFilePath, const Model::ModelData& modelData);
+
+	/// <summary>
+	/// ファイル群のサイズと更新時刻から作る値(中身は読まない)
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	/// <returns>スタンプ</returns>
+	static uint64_t MakeStamp(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// ファイル群の中身のハッシュ(FNV-1a)
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	/// <returns>ハッシュ値</returns>
+	static uint64_t HashFiles(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// ノードを書き出す(子も再帰的に)
+	/// </summary>
+	/// <param name="node">ノード</param>
+	/// <param name="buffer">書き出し先</param>
+	static void WriteNode(const Model::Node& node, std::string& buffer);
+
+	/// <summary>
+	/// ノードを読み込む(子も再帰的に)
+	/// </summary>
+	/// <param name="cursor">読み込み位置(読んだ分進める)</param>
+	/// <param name="end">データの終端</param>
+	/// <param name="node">読み込み先</param>
+	/// <returns>読み込めたか</returns>
+	static bool ReadNode(const uint8_t*& cursor, const uint8_t* end, Model::Node& node);
+
+	/// <summary>
+	/// サブメッシュと詳細度の段が指す範囲が、インデックス・マテリアル・サブメッシュの数に収まっているか
+	/// </summary>
+	/// <param name="modelData">読み込んだモデルデータ</param>
+	/// <returns>収まっているか(収まっていなければ変換済みファイルは使わずに読み直す)</returns>
+	static bool HasValidRanges(const Model::ModelData& modelData);
+
+private:
+
+	static constexpr char kMagic_[4] = { 'M', 'E', 'S', 'H' };
+	static const uint32_t kVersion_ = 5;
+
+	// 圧縮形式で許す位置の誤差(量子化1段の大きさ)
+	static constexpr float kMaxPositionError_ = 0.001f;
+
+	// 圧縮形式で許すUVの誤差(8192pxのテクスチャで1px未満)
+	static constexpr float kMaxTexcoordError_ = 1.0f / 8192.0f;
+};
@@ -0,0 +1,275 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(const Quadric& other)
+{
+	a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+	a11 += other.a11; a12 += other.a12; a13 += other.a13;
+	a22 += other.a22; a23 += other.a23;
+	a33 += other.a33;
+	weight += other.weight;
+	return *this;
+}
+
+std::vector<uint32_t> MeshSimplifier::Simplify(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices,
+	size_t targetIndexCount, float maxError, float& resultError)
+{
+	resultError = 0.0f;
+	std::vector<uint32_t> result = indices;
+	const size_t vertexCount = positions.size();
+
+	// 同じ位置にある頂点(UVや法線の継ぎ目で分かれたもの)を1つの代表にまとめる
+	std::vector<uint32_t> representative(vertexCount);
+	std::vector<bool> isLocked(vertexCount, false);
+	{
+		std::map<std::tuple<float, float, float>, uint32_t> firstVertex;
+		std::vector<uint32_t> groupSize(vertexCount, 0);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			const Vector3& position = positions[i];
+			representative[i] = firstVertex.try_emplace({ position.x, position.y, position.z }, i).first->second;
+			++groupSize[representative[i]];
+		}
+		// 継ぎ目の頂点を動かすとUVや法線が裂けるので固定する
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			isLocked[i] = groupSize[representative[i]] > 1;
+		}
+	}
+
+	// 開いた縁と3枚以上の面が集まる辺の頂点を固定する(位置で数えるので継ぎ目の向こう側も同じ辺になる)
+	{
+		std::unordered_map<uint64_t, uint32_t> edgeCount;
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t a = representative[result[i + corner]];
+				const uint32_t b = representative[result[i + (corner + 1) % 3]];
+				++edgeCount[(uint64_t((std::min)(a, b)) << 32) | (std::max)(a, b)];
+			}
+		}
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t a = result[i + corner];
+				const uint32_t b = result[i + (corner + 1) % 3];
+				const uint32_t ra = representative[a];
+				const uint32_t rb = representative[b];
+				if (edgeCount[(uint64_t((std::min)(ra, rb)) << 32) | (std::max)(ra, rb)] != 2)
+				{
+					isLocked[a] = true;
+					isLocked[b] = true;
+				}
+			}
+		}
+	}
+
+	// 頂点ごとに周りの面の二次誤差をためる
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i + 2 < result.size(); i += 3)
+	{
+		const Quadric plane = MakePlaneQuadric(positions[result[i]], positions[result[i + 1]], positions[result[i + 2]]);
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			quadrics[representative[result[i + corner]]] += plane;
+		}
+	}
+
+	const float maxCost = maxError * maxError;
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1);
+	std::vector<uint32_t> vertexTriangles;
+	std::vector<Collapse> candidates;
+	std::vector<bool> isTouched(vertexCount);
+
+	while (result.size() > targetIndexCount)
+	{
+		// 頂点ごとの三角形一覧を作る
+		std::fill(triangleOffsets.begin(), triangleOffsets.end(), 0);
+		for (uint32_t index : result)
+		{
+			++triangleOffsets[index + 1];
+		}
+		for (size_t i = 0; i < vertexCount; ++i)
+		{
+			triangleOffsets[i + 1] += triangleOffsets[i];
+		}
+		vertexTriangles.resize(result.size());
+		{
+			std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); ++i)
+			{
+				vertexTriangles[cursor[result[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		// 辺ごとに縮約の候補を作り、誤差の小さい順に並べる
+		candidates.clear();
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				const uint32_t a = result[i + corner];
+				const uint32_t b = result[i + (corner + 1) % 3];
+				Quadric quadric = quadrics[representative[a]];
+				quadric += quadrics[representative[b]];
+				if (!isLocked[a])
+				{
+					candidates.push_back({ a, b, Evaluate(quadric, positions[b]) });
+				}
+				if (!isLocked[b])
+				{
+					candidates.push_back({ b, a, Evaluate(quadric, positions[a]) });
+				}
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+		// 1回の走査では周りの三角形が重ならない縮約だけを行う
+		std::fill(isTouched.begin(), isTouched.end(), false);
+		size_t remainingIndexCount = result.size();
+		size_t collapseCount = 0;
+		std::vector<uint32_t> remap(vertexCount);
+		for (uint32_t i = 0; i < vertexCount; ++i)
+		{
+			remap[i] = i;
+		}
+		for (const Collapse& collapse : candidates)
+		{
+			if (collapse.cost > maxCost or remainingIndexCount <= targetIndexCount)
+			{
+				break;
+			}
+			if (isTouched[collapse.from] or isTouched[collapse.to])
+			{
+				continue;
+			}
+
+			const uint32_t* triangleBegin = vertexTriangles.data() + triangleOffsets[collapse.from];
+			const uint32_t* triangleEnd = vertexTriangles.data() + triangleOffsets[collapse.from + 1];
+			if (HasFlip(positions, result, triangleBegin, triangleEnd, collapse.from, collapse.to))
+			{
+				continue;
+			}
+
+			// 消える頂点の周りは今回の走査ではもう触らない
+			for (const uint32_t* triangle = triangleBegin; triangle != triangleEnd; ++triangle)
+			{
+				bool hasTo = false;
+				for (size_t corner = 0; corner < 3; ++corner)
+				{
+					const uint32_t index = result[*triangle * 3 + corner];
+					isTouched[index] = true;
+					hasTo = hasTo or index == collapse.to;
+				}
+				// 辺を共有する三角形はつぶれて消える
+				if (hasTo)
+				{
+					remainingIndexCount -= 3;
+				}
+			}
+
+			remap[collapse.from] = collapse.to;
+			quadrics[representative[collapse.to]] += quadrics[representative[collapse.from]];
+			resultError = (std::max)(resultError, collapse.cost);
+			++collapseCount;
+		}
+
+		if (collapseCount == 0)
+		{
+			break;
+		}
+
+		// インデックスを付け替え、つぶれた三角形を取り除く
+		size_t writeIndex = 0;
+		for (size_t i = 0; i + 2 < result.size(); i += 3)
+		{
+			const uint32_t a = remap[result[i]];
+			const uint32_t b = remap[result[i + 1]];
+			const uint32_t c = remap[result[i + 2]];
+			if (a != b and b != c and c != a)
+			{
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+		}
+		result.resize(writeIndex);
+	}
+
+	resultError = std::sqrt(resultError);
+	return result;
+}
+
+MeshSimplifier::Quadric MeshSimplifier::MakePlaneQuadric(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+	Quadric quadric;
+	const Vector3 normal = (p1 - p0).Cross(p2 - p0);
+	const float length = normal.Length();
+	if (length <= 0.0f)
+	{
+		return quadric;
+	}
+
+	// 面の方程式 ax + by + cz + d = 0
+	const double a = normal.x / length;
+	const double b = normal.y / length;
+	const double c = normal.z / length;
+	const double d = -(a * p0.x + b * p0.y + c * p0.z);
+	const double area = length * 0.5;
+
+	quadric.a00 = area * a * a; quadric.a01 = area * a * b; quadric.a02 = area * a * c; quadric.a03 = area * a * d;
+	quadric.a11 = area * b * b; quadric.a12 = area * b * c; quadric.a13 = area * b * d;
+	quadric.a22 = area * c * c; quadric.a23 = area * c * d;
+	quadric.a33 = area * d * d;
+	quadric.weight = area;
+	return quadric;
+}
+
+float MeshSimplifier::Evaluate(const Quadric& quadric, const Vector3& position)
+{
+	if (quadric.weight <= 0.0)
+	{
+		return 0.0f;
+	}
+
+	const double x = position.x;
+	const double y = position.y;
+	const double z = position.z;
+	const double error =
+		quadric.a00 * x * x + quadric.a11 * y * y + quadric.a22 * z * z + quadric.a33 +
+		2.0 * (quadric.a01 * x * y + quadric.a02 * x * z + quadric.a03 * x + quadric.a12 * y * z + quadric.a13 * y + quadric.a23 * z);
+	return static_cast<float>((std::max)(error, 0.0) / quadric.weight);
+}
+
+bool MeshSimplifier::HasFlip(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices,
+	const uint32_t* triangleBegin, const uint32_t* triangleEnd, uint32_t from, uint32_t to)
+{
+	for (const uint32_t* triangle = triangleBegin; triangle != triangleEnd; ++triangle)
+	{
+		const uint32_t* corners = &indices[*triangle * 3];
+		if (corners[0] == to or corners[1] == to or corners[2] == to)
+		{
+			// 辺を共有する三角形は消えるので調べない
+			continue;
+		}
+
+		// fromの位置をtoに動かしたときに面の向きが反対を向くか
+		const Vector3& p0 = positions[corners[0] == from ? to : corners[0]];
+		const Vector3& p1 = positions[corners[1] == from ? to : corners[1]];
+		const Vector3& p2 = positions[corners[2] == from ? to : corners[2]];
+		const Vector3 before = (positions[corners[1]] - positions[corners[0]]).Cross(positions[corners[2]] - positions[corners[0]]);
+		const Vector3 after = (p1 - p0).Cross(p2 - p0);
+		if (before.Dot(after) <= 0.0f)
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Vector3.h"
+
+/// <summary>
+/// 二次誤差(QEM)による辺の縮約でメッシュを簡略化する
+/// 頂点は新しく作らず元の頂点を使い回すので、LODごとにインデックスだけを持てばよい
+/// </summary>
+class MeshSimplifier
+{
+public:
+
+	/// <summary>
+	/// インデックスを目標数まで減らす
+	/// 開いた縁とUV・法線の継ぎ目にある頂点は動かさないので、サブメッシュ同士の境目に隙間はできない
+	/// </summary>
+	/// <param name="positions">頂点の位置</param>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="targetIndexCount">目標のインデックス数</param>
+	/// <param name="maxError">許す誤差(面からの距離)</param>
+	/// <param name="resultError">実際の誤差(面からの距離)</param>
+	/// <returns>簡略化したインデックス</returns>
+	static std::vector<uint32_t> Simplify(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices,
+		size_t targetIndexCount, float maxError, float& resultError);
+
+private:
+
+	// 面からの距離の二乗和を表す対称4x4行列(上三角の10要素)と面積の合計
+	struct Quadric
+	{
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+		double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+		double a22 = 0.0, a23 = 0.0;
+		double a33 = 0.0;
+		double weight = 0.0;
+
+		Quadric& operator+=(const Quadric& other);
+	};
+
+	// 縮約の候補
+	struct Collapse
+	{
+		uint32_t from;
+		uint32_t to;
+		float cost;
+	};
+
+	/// <summary>
+	/// 三角形の面から二次誤差を作る(面積で重み付け)
+	/// </summary>
+	/// <param name="p0">頂点0</param>
+	/// <param name="p1">頂点1</param>
+	/// <param name="p2">頂点2</param>
+	/// <returns>二次誤差</returns>
+	static Quadric MakePlaneQuadric(const Vector3& p0, const Vector3& p1, const Vector3& p2);
+
+	/// <summary>
+	/// 二次誤差を位置で評価する
+	/// </summary>
+	/// <param name="quadric">二次誤差</param>
+	/// <param name="position">位置</param>
+	/// <returns>面からの距離の二乗(面積で平均したもの)</returns>
+	static float Evaluate(const Quadric& quadric, const Vector3& position);
+
+	/// <summary>
+	/// 縮約で周りの三角形が裏返らないか調べる
+	/// </summary>
+	/// <param name="positions">頂点の位置</param>
+	/// <param name="indices">インデックス</param>
+	/// <param name="triangleBegin">fromを含む三角形の番号の先頭</param>
+	/// <param name="triangleEnd">fromを含む三角形の番号の終端</param>
+	/// <param name="from">消す頂点</param>
+	/// <param name="to">残す頂点</param>
+	/// <returns>裏返るならtrue</returns>
+	static bool HasFlip(const std::vector<Vector3>& positions, const std::vector<uint32_t>& indices,
+		const uint32_t* triangleBegin, const uint32_t* triangleEnd, uint32_t from, uint32_t to);
+};
@@ -3,26 +3,81 @@
 
 #include <fstream>
 #include <sstream>
+#include <format>
+#include <deque>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
 
 #include "ModelCommon.h"
+#include "MeshCooker.h"
+#include "MeshSimplifier.h"
 
 void Model::Initialize(ModelCommon* modelCommon, const std::string& directorypath, const std::string& filename)
+{
+	//モデル読み込み
+	LoadData(directorypath, filename);
+
+	// GPUリソースを作る
+	CreateGpuResources(modelCommon);
+}
+
+void Model::LoadData(const std::string& directorypath, const std::string& filename)
+{
+	fileName_ = filename;
+
+	//モデル読み込み(変換済みバイナリが古くなければそちらを使い、無ければ作る)
+	const std::string sourceFilePath = directorypath + "/" + filename;
+	if (!MeshCooker::Load(sourceFilePath, modelData_))
+	{
+		modelData_ = LoadObjFile(directorypath, filename);
+		// 遠くで使う簡略化したメッシュも一緒に書き出す
+		GenerateLods();
+		// GPUに置く頂点の形式はモデルごとに精度を見て選ぶ
+		modelData_.vertexFormat = MeshCooker::SelectVertexFormat(modelData_);
+		MeshCooker::Save(sourceFilePath, modelData_);
+	}
+
+	FlattenNodes();
+}
+
+void Model::CreateGpuResources(ModelCommon* modelCommon)
 {
 	modelCommon_ = modelCommon;
 
-	//モデル読み込み
-	modelData_ = LoadObjFile(directorypath, filename);
+	// 詳細度を選ぶための境界球
+	CalculateBounds();
 
 	// VertexResourceを作る
-	CreateVertexData();
+	if (modelData_.vertexFormat == VertexFormat::Compact)
+	{
+		CreateCompactVertexData();
+	}
+	else
+	{
+		CreateVertexData();
+	}
+
+	// IndexResourceを作る
+	UpdateIndexBuffer();
+
+	// 展開していた場合と比べた削減量を出力
+	LogIndexedSavings(fileName_);
 
 	// マテリアルリソースを作る
 	CreateMaterialData();
 
-	// .objの参照しているテクスチャファイル読み込み
-	TextureManager::GetInstance()->LoadTexture(modelData_.material.textureFilePath);
-	// 読み込んだテクスチャの番号を取得
-	modelData_.material.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(modelData_.material.textureFilePath);
+	// .objの参照しているテクスチャファイル読み込み(まとめて読み込み済みなら何もしない)
+	for (MaterialData& material : modelData_.materials)
+	{
+		// 裏で読み込み中のものは待たずに仮テクスチャで描く(SRVの番号は変わらない)
+		if (!TextureManager::GetInstance()->IsStreaming(material.textureFilePath))
+		{
+			TextureManager::GetInstance()->LoadTexture(material.textureFilePath);
+		}
+		// 読み込んだテクスチャの番号を取得
+		material.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(material.textureFilePath);
+	}
 
 }
 
@@ -30,7 +85,73 @@ void Model::UpData()
 {
 }
 
-void Model::Draw()
+uint64_t Model::GetGpuMemorySize() const
+{
+	uint64_t size = 0;
+	for (ID3D12Resource* resource : { vertexResource_.Get(), vertexDequantResource_.Get(), indexResource_.Get(), materialResource_.Get() })
+	{
+		if (resource != nullptr)
+		{
+			size += resource->GetDesc().Width;
+		}
+	}
+	return size;
+}
+
+void Model::Draw(uint32_t lodIndex, uint32_t instanceCount)
+{
+	BindMeshResources();
+
+	// 描画する段のサブメッシュの範囲
+	uint32_t subMeshStart = 0;
+	uint32_t subMeshCount = 0;
+	GetSubMeshRange(lodIndex, subMeshStart, subMeshCount);
+
+	// サブメッシュはマテリアル順に並んでいるので、テクスチャは切り替わるときだけ設定する
+	uint32_t boundMaterial = UINT32_MAX;
+	for (uint32_t subMeshIndex = subMeshStart; subMeshIndex < subMeshStart + subMeshCount; ++subMeshIndex)
+	{
+		const SubMesh& subMesh = modelData_.subMeshes[subMeshIndex];
+		if (subMesh.materialIndex != boundMaterial)
+		{
+			// SRVのDescriptorTableの先頭を設定。2はrootPatameter[2]である。
+			assert(subMesh.materialIndex < modelData_.materials.size());
+			const MaterialData& material = modelData_.materials[subMesh.materialIndex];
+			modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(material.textureFilePath));
+			boundMaterial = subMesh.materialIndex;
+		}
+
+		//描画！
+		modelCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(subMesh.indexCount, instanceCount, subMesh.indexStart, 0, 0);
+	}
+}
+
+void Model::DrawSubMesh(uint32_t subMeshIndex, uint32_t instanceCount)
+{
+	BindMeshResources();
+
+	assert(subMeshIndex < modelData_.subMeshes.size());
+	const SubMesh& subMesh = modelData_.subMeshes[subMeshIndex];
+	assert(subMesh.materialIndex < modelData_.materials.size());
+	const MaterialData& material = modelData_.materials[subMesh.materialIndex];
+	modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(material.textureFilePath));
+
+	modelCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(subMesh.indexCount, instanceCount, subMesh.indexStart, 0, 0);
+}
+
+void Model::GetSubMeshRange(uint32_t lodIndex, uint32_t& subMeshStart, uint32_t& subMeshCount) const
+{
+	subMeshStart = 0;
+	subMeshCount = static_cast<uint32_t>(modelData_.subMeshes.size());
+	if (!modelData_.lods.empty())
+	{
+		const LodLevel& lod = modelData_.lods[(std::min)(static_cast<size_t>(lodIndex), modelData_.lods.size() - 1)];
+		subMeshStart = lod.subMeshStart;
+		subMeshCount = lod.subMeshCount;
+	}
+}
+
+void Model::BindMeshResources()
 {
 	// VertexBufferViewを設定
 	modelCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView_);
@@ -38,13 +159,38 @@ void Model::Draw()
 	// マテリアルCBufferの場所を設定
 	modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
 
+	// 圧縮した頂点を戻すためのCBufferの場所を設定
+	if (modelData_.vertexFormat == VertexFormat::Compact)
+	{
+		modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(9, vertexDequantResource_->GetGPUVirtualAddress());
+	}
 
-	// SRVのDescriptorTableの先頭を設定。2はrootPatameter[2]である。
-	modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(modelData_.material.textureFilePath));
+	// IndexBufferViewを設定
+	modelCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView_);
+}
 
+uint32_t Model::SelectLod(float pixelsPerUnit) const
+{
+	// 粗い段から順に、誤差が画面上で許容範囲に収まるものを探す
+	for (size_t i = modelData_.lods.size(); i-- > 1;)
+	{
+		if (modelData_.lods[i].error * pixelsPerUnit <= kLodPixelError_)
+		{
+			return static_cast<uint32_t>(i);
+		}
+	}
+	return 0;
+}
 
-	//描画！
-	modelCommon_->GetDxCommon()->GetCommandList()->DrawInstanced(UINT(modelData_.vertices.size()), 1, 0, 0);
+std::vector<std::string> Model::GetTextureFilePaths() const
+{
+	std::vector<std::string> filePaths;
+	filePaths.reserve(modelData_.materials.size());
+	for (const MaterialData& material : modelData_.materials)
+	{
+		filePaths.push_back(material.textureFilePath);
+	}
+	return filePaths;
 }
 
 Model::MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename)
@@ -82,49 +228,100 @@ Model::ModelData Model::LoadObjFile(const std::string& directoryPath, const std:
 
 	Assimp::Importer importer;
 	std::string fullPath = directoryPath + "/" + filename;
-	const aiScene* scene = importer.ReadFile(fullPath.c_str(), aiProcess_FlipWindingOrder | aiProcess_FlipUVs);
+	// 同じ頂点はまとめてインデックスで参照し、頂点キャッシュに乗りやすい順に並べ替える
+	const aiScene* scene = importer.ReadFile(fullPath.c_str(),
+		aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ImproveCacheLocality);
 	assert(scene->HasMeshes()); // メッシュがない場合はエラー
 
+	// マテリアルのテクスチャはメッシュごとではなくマテリアルごとに1回だけ求める
+	// (使われているものだけを出てきた順に登録する)
+	std::vector<uint32_t> materialSlots(scene->mNumMaterials, UINT32_MAX);
+	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+	{
+		const uint32_t materialIndex = scene->mMeshes[meshIndex]->mMaterialIndex;
+		if (materialSlots[materialIndex] != UINT32_MAX)
+		{
+			continue;
+		}
+
+		MaterialData materialData;
+		aiMaterial* material = scene->mMaterials[materialIndex];
+		if (material->GetTextureCount(aiTextureType_DIFFUSE) != 0)
+		{
+			aiString textureFilePath;
+			material->GetTexture(aiTextureType_DIFFUSE, 0, &textureFilePath);
+			materialData.textureFilePath = directoryPath + "/" + textureFilePath.C_Str();
+		}
+		else
+		{
+			// テクスチャの無いマテリアルは白で塗る
+			materialData.textureFilePath = kDefaultTextureFilePath_;
+		}
+
+		materialSlots[materialIndex] = static_cast<uint32_t>(modelData.materials.size());
+		modelData.materials.push_back(std::move(materialData));
+	}
+
+	// 頂点は全メッシュを1つの頂点バッファに詰める
+	std::vector<uint32_t> baseVertices(scene->mNumMeshes);
+	size_t indexCount = 0;
 	for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
 	{
 		aiMesh* mesh = scene->mMeshes[meshIndex];
 		assert(mesh->HasNormals()); // 法線がない場合はエラー
 		assert(mesh->HasTextureCoords(0)); // TexCoordがない場合はエラー
 
-		for (uint32_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex)
+		// 複数メッシュは1つの頂点バッファに詰めるので、インデックスをずらす
+		baseVertices[meshIndex] = static_cast<uint32_t>(modelData.vertices.size());
+		modelData.vertices.reserve(modelData.vertices.size() + mesh->mNumVertices);
+		indexCount += mesh->mNumFaces * 3;
+
+		for (uint32_t vertexIndex = 0; vertexIndex < mesh->mNumVertices; ++vertexIndex)
 		{
-			aiFace& face = mesh->mFaces[faceIndex];
-			assert(face.mNumIndices == 3); // 三角形以外はエラー
+			aiVector3D& position = mesh->mVertices[vertexIndex];
+			aiVector3D& normal = mesh->mNormals[vertexIndex];
+			aiVector3D& texcoord = mesh->mTextureCoords[0][vertexIndex];
+			VertexData vertex;
+			vertex.position = { position.x, position.y, position.z, 1.0f };
+			vertex.normal = { normal.x, normal.y, normal.z };
+			vertex.texcoord = { texcoord.x, texcoord.y };
+			// aiProcess_MakeLeftHandedはz*=-1で、右手->左手に変換するので手動で対処
+			vertex.position.x *= -1.0f;
+			vertex.normal.x *= -1.0f;
+			modelData.vertices.push_back(vertex);
+		}
+	}
+
+	// インデックスはマテリアルごとにまとめて並べ、マテリアル1つにつき1回の描画にする
+	modelData.indices.reserve(indexCount);
+	for (uint32_t slot = 0; slot < modelData.materials.size(); ++slot)
+	{
+		SubMesh subMesh;
+		subMesh.indexStart = static_cast<uint32_t>(modelData.indices.size());
+		subMesh.materialIndex = slot;
 
-			for (uint32_t element = 0; element < face.mNumIndices; ++element)
+		for (uint32_t meshIndex = 0; meshIndex < scene->mNumMeshes; ++meshIndex)
+		{
+			aiMesh* mesh = scene->mMeshes[meshIndex];
+			if (materialSlots[mesh->mMaterialIndex] != slot)
 			{
-				uint32_t vertexIndex = face.mIndices[element];
-				aiVector3D& position = mesh->mVertices[vertexIndex];
-				aiVector3D& normal = mesh->mNormals[vertexIndex];
-				aiVector3D& texcoord = mesh->mTextureCoords[0][vertexIndex];
-				VertexData vertex;
-				vertex.position = { position.x, position.y, position.z, 1.0f };
-				vertex.normal = { normal.x, normal.y, normal.z };
-				vertex.texcoord = { texcoord.x, texcoord.y };
-				// aiProcess_MakeLeftHandedはz*=-1で、右手->左手に変換するので手動で対処
-				vertex.position.x *= -1.0f;
-				vertex.normal.x *= -1.0f;
-				modelData.vertices.push_back(vertex);
+				continue;
 			}
 
-			for (uint32_t materialIndex = 0; materialIndex < scene->mNumMaterials; ++materialIndex)
+			for (uint32_t faceIndex = 0; faceIndex < mesh->mNumFaces; ++faceIndex)
 			{
-				aiMaterial* material = scene->mMaterials[materialIndex];
-				if (material->GetTextureCount(aiTextureType_DIFFUSE) != 0)
-				{
-					aiString textureFilePath;
-					material->GetTexture(aiTextureType_DIFFUSE, 0, &textureFilePath);
-					modelData.material.textureFilePath = directoryPath + "/" + textureFilePath.C_Str();
+				aiFace& face = mesh->mFaces[faceIndex];
+				assert(face.mNumIndices == 3); // 三角形以外はエラー
 
+				for (uint32_t element = 0; element < face.mNumIndices; ++element)
+				{
+					modelData.indices.push_back(baseVertices[meshIndex] + face.mIndices[element]);
 				}
 			}
 		}
 
+		subMesh.indexCount = static_cast<uint32_t>(modelData.indices.size()) - subMesh.indexStart;
+		modelData.subMeshes.push_back(subMesh);
 	}
 
 	// ノードの情報を取得
@@ -148,10 +345,181 @@ void Model::CreateVertexData()
 
 }
 
+void Model::GenerateLods()
+{
+	modelData_.lods.clear();
+	if (modelData_.subMeshes.empty())
+	{
+		return;
+	}
+
+	// 元のメッシュを0番の段にする
+	const LodLevel baseLod = { 0, static_cast<uint32_t>(modelData_.subMeshes.size()), 0.0f };
+	modelData_.lods.push_back(baseLod);
+
+	std::vector<Vector3> positions;
+	positions.reserve(modelData_.vertices.size());
+	float radius = 0.0f;
+	for (const VertexData& vertex : modelData_.vertices)
+	{
+		positions.emplace_back(vertex.position.x, vertex.position.y, vertex.position.z);
+		radius = (std::max)(radius, positions.back().Length());
+	}
+
+	const size_t baseIndexCount = modelData_.indices.size();
+	size_t previousIndexCount = baseIndexCount;
+	float ratio = 1.0f;
+	for (size_t level = 1; level < kMaxLodCount_; ++level)
+	{
+		ratio *= kLodIndexRatio_;
+		const size_t indexStart = modelData_.indices.size();
+		LodLevel lod = { static_cast<uint32_t>(modelData_.subMeshes.size()), 0, 0.0f };
+
+		// サブメッシュごとに元のメッシュから簡略化する(境目の頂点は動かないので隙間はできない)
+		for (uint32_t subMeshIndex = 0; subMeshIndex < baseLod.subMeshCount; ++subMeshIndex)
+		{
+			const SubMesh baseSubMesh = modelData_.subMeshes[subMeshIndex];
+			const std::vector<uint32_t> source(
+				modelData_.indices.begin() + baseSubMesh.indexStart,
+				modelData_.indices.begin() + baseSubMesh.indexStart + baseSubMesh.indexCount);
+			const size_t targetIndexCount = static_cast<size_t>(baseSubMesh.indexCount * ratio) / 3 * 3;
+
+			float error = 0.0f;
+			const std::vector<uint32_t> simplified = MeshSimplifier::Simplify(positions, source, targetIndexCount, radius * kLodMaxRelativeError_, error);
+			if (simplified.empty())
+			{
+				continue;
+			}
+
+			modelData_.subMeshes.push_back({ static_cast<uint32_t>(modelData_.indices.size()), static_cast<uint32_t>(simplified.size()), baseSubMesh.materialIndex });
+			modelData_.indices.insert(modelData_.indices.end(), simplified.begin(), simplified.end());
+			++lod.subMeshCount;
+			lod.error = (std::max)(lod.error, error);
+		}
+
+		// 前の段から十分に減らなければ、これ以上段を作っても意味がない
+		const size_t indexCount = modelData_.indices.size() - indexStart;
+		if (lod.subMeshCount == 0 or static_cast<float>(indexCount) > static_cast<float>(previousIndexCount) * kLodMinReduction_)
+		{
+			modelData_.indices.resize(indexStart);
+			modelData_.subMeshes.resize(lod.subMeshStart);
+			break;
+		}
+
+		Logger::Log(std::format("Model {} : LOD{} indices {} -> {} (error {:.4f})\n",
+			fileName_, level, baseIndexCount, indexCount, lod.error));
+		modelData_.lods.push_back(lod);
+		previousIndexCount = indexCount;
+	}
+}
+
+void Model::CalculateBounds()
+{
+	boundingRadius_ = 0.0f;
+	boundsMin_ = {};
+	boundsMax_ = {};
+	if (modelData_.vertices.empty())
+	{
+		return;
+	}
+
+	boundsMin_ = { FLT_MAX, FLT_MAX, FLT_MAX };
+	boundsMax_ = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (const VertexData& vertex : modelData_.vertices)
+	{
+		const Vector3 position = { vertex.position.x, vertex.position.y, vertex.position.z };
+		boundingRadius_ = (std::max)(boundingRadius_, position.Length());
+		boundsMin_ = { (std::min)(boundsMin_.x, position.x), (std::min)(boundsMin_.y, position.y), (std::min)(boundsMin_.z, position.z) };
+		boundsMax_ = { (std::max)(boundsMax_.x, position.x), (std::max)(boundsMax_.y, position.y), (std::max)(boundsMax_.z, position.z) };
+	}
+}
+
+void Model::CreateCompactVertexData()
+{
+	// 位置とUVの範囲を求める
+	Vector3 positionMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+	Vector3 positionMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	Vector2 texcoordMin = { FLT_MAX, FLT_MAX };
+	Vector2 texcoordMax = { -FLT_MAX, -FLT_MAX };
+	for (const VertexData& vertex : modelData_.vertices)
+	{
+		positionMin = { (std::min)(positionMin.x, vertex.position.x), (std::min)(positionMin.y, vertex.position.y), (std::min)(positionMin.z, vertex.position.z) };
+		positionMax = { (std::max)(positionMax.x, vertex.position.x), (std::max)(positionMax.y, vertex.position.y), (std::max)(positionMax.z, vertex.position.z) };
+		texcoordMin = { (std::min)(texcoordMin.x, vertex.texcoord.x), (std::min)(texcoordMin.y, vertex.texcoord.y) };
+		texcoordMax = { (std::max)(texcoordMax.x, vertex.texcoord.x), (std::max)(texcoordMax.y, vertex.texcoord.y) };
+	}
+
+	// 範囲をシェーダーに渡す
+	VertexDequant dequant{};
+	dequant.positionMin = positionMin;
+	dequant.positionExtent = { positionMax.x - positionMin.x, positionMax.y - positionMin.y, positionMax.z - positionMin.z };
+	dequant.texcoordMin = texcoordMin;
+	dequant.texcoordExtent = { texcoordMax.x - texcoordMin.x, texcoordMax.y - texcoordMin.y };
+
+	vertexDequantResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(VertexDequant));
+	VertexDequant* dequantData = nullptr;
+	vertexDequantResource_->Map(0, nullptr, reinterpret_cast<void**>(&dequantData));
+	*dequantData = dequant;
+	vertexDequantResource_->Unmap(0, nullptr);
+
+	// 範囲内の位置を16bitにする(幅が0の軸は0に詰める)
+	auto quantize = [](float value, float min, float extent)
+		{
+			const float normalized = extent > 0.0f ? std::clamp((value - min) / extent, 0.0f, 1.0f) : 0.0f;
+			return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+		};
+
+	// VertexResourceを作る
+	const size_t vertexCount = modelData_.vertices.size();
+	vertexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(CompactVertexData) * vertexCount);
+	vertexBufferView_.BufferLocation = vertexResource_->GetGPUVirtualAddress();
+	vertexBufferView_.SizeInBytes = UINT(sizeof(CompactVertexData) * vertexCount);
+	vertexBufferView_.StrideInBytes = sizeof(CompactVertexData);
+
+	// 圧縮しながら書き込む(CPU側で書き換えることは無いのでマップは残さない)
+	CompactVertexData* compactData = nullptr;
+	vertexResource_->Map(0, nullptr, reinterpret_cast<void**>(&compactData));
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		const VertexData& vertex = modelData_.vertices[i];
+		CompactVertexData& compact = compactData[i];
+		compact.position[0] = quantize(vertex.position.x, dequant.positionMin.x, dequant.positionExtent.x);
+		compact.position[1] = quantize(vertex.position.y, dequant.positionMin.y, dequant.positionExtent.y);
+		compact.position[2] = quantize(vertex.position.z, dequant.positionMin.z, dequant.positionExtent.z);
+		compact.position[3] = 0;
+		compact.texcoord[0] = quantize(vertex.texcoord.x, dequant.texcoordMin.x, dequant.texcoordExtent.x);
+		compact.texcoord[1] = quantize(vertex.texcoord.y, dequant.texcoordMin.y, dequant.texcoordExtent.y);
+		EncodeOctahedral(vertex.normal, compact.normal);
+	}
+	vertexResource_->Unmap(0, nullptr);
+	vertexData_ = nullptr;
+}
+
+void Model::EncodeOctahedral(const Vector3& normal, int16_t encoded[2])
+{
+	// 八面体に投影する
+	const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+	float x = length > 0.0f ? normal.x / length : 0.0f;
+	float y = length > 0.0f ? normal.y / length : 0.0f;
+
+	// 下半分は外側に折り返す
+	if (normal.z < 0.0f)
+	{
+		const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	encoded[0] = static_cast<int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+	encoded[1] = static_cast<int16_t>(std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+}
+
 void Model::CreateMaterialData()
 {
 	// マテリアルリソースを作る
 	materialResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
+	materialId_ = nextMaterialId_++;
 	// マテリアルリソースにデータを描きこむためのアドレスを取得し マテリアルリソースに割り当てる
 	materialResource_->Map(0, nullptr, reinterpret_cast<void**>(&materialData_));
 	// マテリアルデータの初期値を描き来む
@@ -165,6 +533,27 @@ void Model::CreateMaterialData()
 	materialData_->spotLight = false;
 }
 
+void Model::FlattenNodes()
+{
+	nodes_.clear();
+
+	// 幅優先でたどり、親を並べてから子を並べる
+	std::deque<std::pair<const Node*, int32_t>> queue;
+	queue.push_back({ &modelData_.rootNode, -1 });
+	while (!queue.empty())
+	{
+		const auto [node, parentIndex] = queue.front();
+		queue.pop_front();
+
+		const int32_t index = static_cast<int32_t>(nodes_.size());
+		nodes_.push_back({ node->name, parentIndex, node->localMatrix });
+		for (const Node& child : node->children)
+		{
+			queue.push_back({ &child, index });
+		}
+	}
+}
+
 Model::Node Model::ReadNode(aiNode* node)
 {
 	Node result;
@@ -205,6 +594,11 @@ void Model::UpdateVertexBuffer()
 		return;
 	}
 
+	// 手で組み立てた頂点はそのままの形式で置く
+	modelData_.vertexFormat = VertexFormat::Full;
+	vertexDequantResource_.Reset();
+	CalculateBounds();
+
 	// 新しい頂点バッファを作成
 	vertexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(VertexData) * modelData_.vertices.size());
 
@@ -228,18 +622,87 @@ void Model::UpdateIndexBuffer()
 		return;
 	}
 
+	// 手で組み立てたメッシュはサブメッシュが無いので、全体を1つのサブメッシュにする(詳細度の段も1つ)
+	if (modelData_.subMeshes.empty())
+	{
+		modelData_.lods.clear();
+		modelData_.subMeshes.push_back({ 0, static_cast<uint32_t>(modelData_.indices.size()), 0 });
+	}
+
+	// 頂点数が16bitに収まるなら16bitのインデックスにして半分のサイズにする
+	const bool is16Bit = modelData_.vertices.size() <= kMaxIndex16Vertices_;
+	const size_t indexSize = is16Bit ? sizeof(uint16_t) : sizeof(uint32_t);
+
 	// 新しいインデックスバッファを作成
-	indexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(uint32_t) * modelData_.indices.size());
+	indexResource_ = modelCommon_->GetDxCommon()->CreateBufferResource(indexSize * modelData_.indices.size());
 	
 	// インデックスデータを GPU バッファにコピー
 	void* mappedData = nullptr;
 	indexResource_->Map(0, nullptr, &mappedData);
-	std::memcpy(mappedData, modelData_.indices.data(), sizeof(uint32_t) * modelData_.indices.size());
+	if (is16Bit)
+	{
+		uint16_t* indexData = static_cast<uint16_t*>(mappedData);
+		for (size_t i = 0; i < modelData_.indices.size(); ++i)
+		{
+			indexData[i] = static_cast<uint16_t>(modelData_.indices[i]);
+		}
+	}
+	else
+	{
+		std::memcpy(mappedData, modelData_.indices.data(), sizeof(uint32_t) * modelData_.indices.size());
+	}
 	indexResource_->Unmap(0, nullptr);
 	// インデックスバッファビューを更新
 	indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
-	indexBufferView_.SizeInBytes = static_cast<UINT>(sizeof(uint32_t) * modelData_.indices.size());
-	indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+	indexBufferView_.SizeInBytes = static_cast<UINT>(indexSize * modelData_.indices.size());
+	indexBufferView_.Format = is16Bit ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+uint32_t Model::CountVertexCacheMiss(const std::vector<uint32_t>& indices, uint32_t cacheSize)
+{
+	// FIFOの頂点キャッシュを真似て、頂点シェーダーが走る回数を数える
+	std::deque<uint32_t> cache;
+	uint32_t missCount = 0;
+	for (uint32_t index : indices)
+	{
+		if (std::find(cache.begin(), cache.end(), index) != cache.end())
+		{
+			continue;
+		}
+
+		++missCount;
+		cache.push_back(index);
+		if (cache.size() > cacheSize)
+		{
+			cache.pop_front();
+		}
+	}
+	return missCount;
+}
+
+void Model::LogIndexedSavings(const std::string& filename) const
+{
+	// 詳細度の段は除いて、元のメッシュだけで数える
+	size_t baseIndexCount = modelData_.indices.size();
+	if (modelData_.lods.size() > 1)
+	{
+		const SubMesh& lastSubMesh = modelData_.subMeshes[modelData_.lods[0].subMeshCount - 1];
+		baseIndexCount = lastSubMesh.indexStart + lastSubMesh.indexCount;
+	}
+	const std::vector<uint32_t> baseIndices(modelData_.indices.begin(), modelData_.indices.begin() + baseIndexCount);
+
+	// インデックス無しで展開していた場合は1角ごとに1頂点
+	const size_t expandedCount = baseIndices.size();
+	const size_t expandedBytes = sizeof(VertexData) * expandedCount;
+
+	const size_t indexSize = indexBufferView_.Format == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t);
+	const size_t indexedBytes = size_t(vertexBufferView_.StrideInBytes) * modelData_.vertices.size() + indexSize * baseIndices.size();
+
+	const uint32_t invocations = CountVertexCacheMiss(baseIndices, kVertexCacheSize_);
+
+	Logger::Log(std::format("Model {} : vertices {} -> {} ({} bytes each), index {}bit, memory {} -> {} bytes, VS invocations {} -> {} (ACMR {:.2f})\n",
+		filename, expandedCount, modelData_.vertices.size(), vertexBufferView_.StrideInBytes, indexSize * 8, expandedBytes, indexedBytes,
+		expandedCount, invocations, expandedCount > 0 ? float(invocations) / float(expandedCount / 3) : 0.0f));
 }
 
 void Model::ClearVertexData()
@@ -247,10 +710,17 @@ void Model::ClearVertexData()
 	// リソースを解放
 	modelData_.vertices.clear();
 	modelData_.indices.clear();
+	modelData_.subMeshes.clear();
+	modelData_.lods.clear();
+	boundingRadius_ = 0.0f;
+	boundsMin_ = {};
+	boundsMax_ = {};
 
 	// 頂点リソースとインデックスリソースをリセット
 	vertexResource_.Reset();
+	vertexDequantResource_.Reset();
 	indexResource_.Reset();
+	modelData_.vertexFormat = VertexFormat::Full;
 
 	// 頂点バッファビューとインデックスバッファビューをリセット
 	vertexBufferView_ = {};
@@ -260,8 +730,14 @@ void Model::ClearVertexData()
 void Model::CopyFrom(const Model& other)
 {
 	modelData_ = other.modelData_;
+	nodes_ = other.nodes_;
+	boundingRadius_ = other.boundingRadius_;
+	boundsMin_ = other.boundsMin_;
+	boundsMax_ = other.boundsMax_;
 	vertexResource_ = other.vertexResource_;
+	vertexDequantResource_ = other.vertexDequantResource_;
 	materialResource_ = other.materialResource_;
+	materialId_ = other.materialId_;
 	vertexData_ = other.vertexData_;
 	materialData_ = other.materialData_;
 	vertexBufferView_ = other.vertexBufferView_;
@@ -270,14 +746,35 @@ void Model::CopyFrom(const Model& other)
 	transform_ = other.transform_;
 }
 
+void Model::ShareMesh(const Model& other)
+{
+	modelData_.vertices = other.modelData_.vertices;
+	modelData_.indices = other.modelData_.indices;
+	modelData_.subMeshes = other.modelData_.subMeshes;
+	modelData_.lods = other.modelData_.lods;
+	modelData_.vertexFormat = other.modelData_.vertexFormat;
+	boundingRadius_ = other.boundingRadius_;
+	boundsMin_ = other.boundsMin_;
+	boundsMax_ = other.boundsMax_;
+	vertexResource_ = other.vertexResource_;
+	vertexDequantResource_ = other.vertexDequantResource_;
+	vertexData_ = other.vertexData_;
+	vertexBufferView_ = other.vertexBufferView_;
+	indexResource_ = other.indexResource_;
+	indexBufferView_ = other.indexBufferView_;
+}
+
+void Model::ReserveMesh(size_t vertexCount, size_t indexCount)
+{
+	modelData_.vertices.reserve(vertexCount);
+	modelData_.indices.reserve(indexCount);
+}
+
 void Model::AddVertex(const Vector4& position, const Vector2& texcoord, const Vector3& normal)
 {
 	// 頂点データを作成して追加
 	VertexData vertex = { position, texcoord, normal };
 	modelData_.vertices.push_back(vertex);
-
-	// VertexBufferViewを更新
-	UpdateVertexBuffer();
 }
 
 void Model::AddIndex(uint32_t index)
@@ -3,6 +3,7 @@
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <cassert>
 
 #include "MyMath.h"
 #include "TextureManager.h"
@@ -15,8 +16,26 @@ class ModelCommon;
 /// </summary>
 class Model
 {
+	// 変換済みバイナリの読み書きでModelDataを直接扱う
+	friend class MeshCooker;
+
 public:
 
+	// GPUに置く頂点の形式
+	enum class VertexFormat : uint32_t
+	{
+		Full,    // float4位置 + float2UV + float3法線(36バイト)
+		Compact, // 16bit量子化位置 + 16bitUV + 八面体法線(16バイト)
+	};
+
+	// ノードの木を平らにしたもの(親は必ず子より前に並ぶ)
+	struct FlatNode
+	{
+		std::string name;
+		int32_t parentIndex; // 親がいなければ-1
+		Matrix4x4 localMatrix;
+	};
+
 	/// <summary>
 	/// 初期化
 	/// </summary>
@@ -25,6 +44,19 @@ public:
 	/// <param name="filename">ファイル名</param>
 	void Initialize(ModelCommon* modelCommon, const std::string& directorypath, const std::string& filename);
 
+	/// <summary>
+	/// ファイルからモデルデータだけを読み込む(GPUを使わないのでワーカースレッドから呼べる)
+	/// </summary>
+	/// <param name="directoryPath">ディレクトリパス</param>
+	/// <param name="filename">ファイル名</param>
+	void LoadData(const std::string& directorypath, const std::string& filename);
+
+	/// <summary>
+	/// 読み込んだモデルデータからGPUリソースを作る(メインスレッドから呼ぶ)
+	/// </summary>
+	/// <param name="modelCommon">モデル共通機能管理クラスへのポインタ</param>
+	void CreateGpuResources(ModelCommon* modelCommon);
+
 	/// <summary>
 	/// 更新
 	/// </summary>
@@ -33,7 +65,32 @@ public:
 	/// <summary>
 	/// 描画
 	/// </summary>
-	void Draw();
+	/// <param name="lodIndex">詳細度の段(0が元のメッシュ。範囲外なら一番粗い段)</param>
+	/// <param name="instanceCount">インスタンス数(座標変換行列は呼ぶ側が設定しておく)</param>
+	void Draw(uint32_t lodIndex = 0, uint32_t instanceCount = 1);
+
+	/// <summary>
+	/// サブメッシュを1つだけ描画する(描画の並べ替えでサブメッシュごとに積むときに使う)
+	/// </summary>
+	/// <param name="subMeshIndex">サブメッシュの番号(GetSubMeshRangeの範囲のもの)</param>
+	/// <param name="instanceCount">インスタンス数(座標変換行列は呼ぶ側が設定しておく)</param>
+	void DrawSubMesh(uint32_t subMeshIndex, uint32_t instanceCount = 1);
+
+	/// <summary>
+	/// 詳細度の段で描くサブメッシュの範囲を求める
+	/// </summary>
+	/// <param name="lodIndex">詳細度の段(範囲外なら一番粗い段)</param>
+	/// <param name="subMeshStart">最初のサブメッシュの番号</param>
+	/// <param name="subMeshCount">サブメッシュの数</param>
+	void GetSubMeshRange(uint32_t lodIndex, uint32_t& subMeshStart, uint32_t& subMeshCount) const;
+
+	/// <summary>
+	/// 画面上の大きさから詳細度の段を選ぶ
+	/// 簡略化の誤差が画面上で許容ピクセル以下に収まる中で一番粗い段にする
+	/// </summary>
+	/// <param name="pixelsPerUnit">モデル空間の長さ1が画面上で何ピクセルになるか</param>
+	/// <returns>詳細度の段</returns>
+	uint32_t SelectLod(float pixelsPerUnit) const;
 
 	/// <summary>
 	/// 頂点バッファ更新
@@ -56,6 +113,19 @@ public:
 	/// <param name="other">コピー元モデルデータ</param>
 	void CopyFrom(const Model& other);
 
+	/// <summary>
+	/// 他のモデルの頂点とインデックスのバッファを共有する(マテリアルは自分のものを使う)
+	/// </summary>
+	/// <param name="other">共有元モデル</param>
+	void ShareMesh(const Model& other);
+
+	/// <summary>
+	/// 頂点とインデックスの領域を先に確保
+	/// </summary>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="indexCount">インデックス数</param>
+	void ReserveMesh(size_t vertexCount, size_t indexCount);
+
 private: // 構造体、関数
 
 	struct Transform
@@ -72,6 +142,25 @@ private: // 構造体、関数
 		Vector3 normal;
 	};
 
+	// 圧縮した頂点(位置とUVはメッシュの範囲内で16bitに量子化し、法線は八面体で2成分に詰める)
+	struct CompactVertexData
+	{
+		uint16_t position[4];
+		uint16_t texcoord[2];
+		int16_t normal[2];
+	};
+
+	// 圧縮した頂点を元に戻すための値(シェーダーのVertexDequantと同じ並び)
+	struct VertexDequant
+	{
+		Vector3 positionMin;
+		float padding0;
+		Vector3 positionExtent;
+		float padding1;
+		Vector2 texcoordMin;
+		Vector2 texcoordExtent;
+	};
+
 	struct MaterialData
 	{
 		std::string textureFilePath;
@@ -100,12 +189,35 @@ private: // 構造体、関数
 		std::vector<Node> children;
 	};
 
+	// 同じマテリアルで描画するインデックスの範囲
+	struct SubMesh
+	{
+		uint32_t indexStart = 0;
+		uint32_t indexCount = 0;
+		uint32_t materialIndex = 0;
+	};
+
+	// 詳細度の段(サブメッシュの範囲と簡略化の誤差)
+	struct LodLevel
+	{
+		uint32_t subMeshStart = 0;
+		uint32_t subMeshCount = 0;
+		float error = 0.0f; // 元のメッシュからのずれ(モデル空間の距離)
+	};
+
 	struct  ModelData
 	{
 		std::vector<VertexData> vertices;
 		std::vector<uint32_t> indices;
-		MaterialData material;
+		// 使われているマテリアル(SubMesh::materialIndexで参照する)
+		std::vector<MaterialData> materials;
+		// マテリアル順に並べたサブメッシュ(同じマテリアルのメッシュは1つにまとめる)
+		std::vector<SubMesh> subMeshes;
+		// 詳細度の段(0番が元のメッシュ。空ならsubMeshes全体を1段として扱う)
+		std::vector<LodLevel> lods;
 		Node rootNode;
+		// GPUに置く頂点の形式(MeshCookerが選ぶ)
+		VertexFormat vertexFormat = VertexFormat::Full;
 	};
 
 	//mtlファイルを読む関数
@@ -117,26 +229,96 @@ private: // 構造体、関数
 	// 頂点データ生成
 	void CreateVertexData();
 
+	// 簡略化したメッシュを詳細度の段として作る(インデックスとサブメッシュを後ろに足す)
+	void GenerateLods();
+
+	// 原点を中心とした境界球の半径とAABBを求める
+	void CalculateBounds();
+
+	// 圧縮した頂点データ生成
+	void CreateCompactVertexData();
+
+	/// <summary>
+	/// 法線を八面体に詰めて16bitにする
+	/// </summary>
+	/// <param name="normal">法線</param>
+	/// <param name="encoded">詰めた法線</param>
+	static void EncodeOctahedral(const Vector3& normal, int16_t encoded[2]);
+
 	// マテリアルデータ生成
 	void CreateMaterialData();
 
+	// 頂点・インデックス・マテリアル等、サブメッシュに共通のものを設定する
+	void BindMeshResources();
+
 	static Node ReadNode(aiNode* node);
 
+	// ノードの木を親が先に来る順に平らにする
+	void FlattenNodes();
+
+	/// <summary>
+	/// 頂点キャッシュを通したときの頂点シェーダーの実行回数を数える
+	/// </summary>
+	/// <param name="indices">インデックス</param>
+	/// <param name="cacheSize">キャッシュに残る頂点数</param>
+	/// <returns>キャッシュミスの回数</returns>
+	static uint32_t CountVertexCacheMiss(const std::vector<uint32_t>& indices, uint32_t cacheSize);
+
+	// インデックス化による削減量をログに出す
+	void LogIndexedSavings(const std::string& filename) const;
+
 
 public: // ゲッター
 
 	D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView()const { return vertexBufferView_; }
-	ModelData GetModelData() { return modelData_; }
+	const ModelData& GetModelData() const { return modelData_; }
+
+	// ルートノードの行列
+	const Matrix4x4& GetRootMatrix() const { return modelData_.rootNode.localMatrix; }
+
+	// 平らにしたノード(0番がルート。ファイルから読まなかったモデルでは空)
+	const std::vector<FlatNode>& GetNodes() const { return nodes_; }
 
 	uint32_t GetVertexCount() const { return static_cast<uint32_t>(modelData_.vertices.size()); }
 
 	uint32_t GetIndexCount() const { return static_cast<uint32_t>(modelData_.indices.size()); }
 
+	// 参照しているテクスチャファイルパス(マテリアル順)
+	std::vector<std::string> GetTextureFilePaths() const;
+
+	// サブメッシュ数(全ての段の合計)
+	uint32_t GetSubMeshCount() const { return static_cast<uint32_t>(modelData_.subMeshes.size()); }
+
+	// サブメッシュが使うテクスチャのSRVの番号
+	uint32_t GetSubMeshTextureIndex(uint32_t subMeshIndex) const { return modelData_.materials[modelData_.subMeshes[subMeshIndex].materialIndex].textureIndex; }
+
+	// マテリアルのCBufferの番号(作ったときに振る。描画の並べ替えに使う)
+	uint32_t GetMaterialId() const { return materialId_; }
+
+	// 詳細度の段の数
+	uint32_t GetLodCount() const { return modelData_.lods.empty() ? 1 : static_cast<uint32_t>(modelData_.lods.size()); }
+
+	// 原点を中心とした境界球の半径(ルートノードの行列は含まない)
+	float GetBoundingRadius() const { return boundingRadius_; }
+
+	// ローカル空間のAABB(ルートノードの行列は含まない)
+	const Vector3& GetBoundsMin() const { return boundsMin_; }
+	const Vector3& GetBoundsMax() const { return boundsMax_; }
+
+	// GPUに置いている頂点の形式
+	VertexFormat GetVertexFormat() const { return modelData_.vertexFormat; }
+
 	D3D12_INDEX_BUFFER_VIEW GetIndexBufferView() const { return indexBufferView_; }
 
+	// このモデルを使っているObject3dの数
+	uint32_t GetUserCount() const { return userCount_; }
+
+	// 頂点、インデックス、マテリアルのバッファが使っているGPUメモリ量
+	uint64_t GetGpuMemorySize() const;
+
 public: // セッター
 
-	// Vertexを入れる
+	// Vertexを入れる(GPUへの転送はUpdateVertexBufferでまとめて行う)
 	void AddVertex(const Vector4& position, const Vector2& texcoord, const Vector3& normal);
 
 	// indexを入れる
@@ -151,13 +333,55 @@ public: // セッター
 
 	void SetModelCommon(ModelCommon* modelCommon) { modelCommon_ = modelCommon; }
 
+	// 使用中のObject3dを数える(Object3d::SetModelから呼ぶ)
+	void AddUser() { ++userCount_; }
+	void RemoveUser() { assert(userCount_ > 0); --userCount_; }
+
 private:
 
+	// 16bitインデックスで表せる頂点数
+	static const size_t kMaxIndex16Vertices_ = 65536;
+	// 削減量の計算に使う頂点キャッシュのサイズ
+	static const uint32_t kVertexCacheSize_ = 32;
+	// 詳細度の段の最大数(元のメッシュを含む)
+	static const size_t kMaxLodCount_ = 4;
+	// 1段ごとに目指すインデックス数の割合
+	static constexpr float kLodIndexRatio_ = 0.5f;
+	// 前の段からこの割合までしか減らなければ段を作らない
+	static constexpr float kLodMinReduction_ = 0.8f;
+	// 簡略化で許す誤差(境界球の半径に対する割合)
+	static constexpr float kLodMaxRelativeError_ = 0.1f;
+	// 画面上で許す簡略化の誤差(ピクセル)
+	static constexpr float kLodPixelError_ = 1.0f;
+	// テクスチャの無いマテリアルに使うテクスチャ
+	static inline const std::string kDefaultTextureFilePath_ = "resources/images/white.png";
+
+	// 次に作るマテリアルのCBufferに振る番号(メインスレッドでしか作らない)
+	static inline uint32_t nextMaterialId_ = 0;
+
 	ModelCommon* modelCommon_ = nullptr;
 
+	// マテリアルのCBufferの番号
+	uint32_t materialId_ = 0;
+
 	// Objファイルのデータ
 	ModelData modelData_;
 
+	// 読み込んだファイル名(ログ用)
+	std::string fileName_;
+
+	// 使用中のObject3dの数(0になるまでModelManagerは破棄しない)
+	uint32_t userCount_ = 0;
+
+	// 原点を中心とした境界球の半径
+	float boundingRadius_ = 0.0f;
+	// ローカル空間のAABB
+	Vector3 boundsMin_{};
+	Vector3 boundsMax_{};
+
+	// 平らにしたノード
+	std::vector<FlatNode> nodes_;
+
 	// バッファリソース
 	// 頂点リソース
 	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_{};
@@ -174,6 +398,9 @@ private:
 	// Transform
 	Transform transform_;
 
+	// 圧縮した頂点を戻すための定数バッファ(Compactのときだけ作る)
+	Microsoft::WRL::ComPtr<ID3D12Resource> vertexDequantResource_{};
+
 	// GPU上のインデックスバッファ
 	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_{};
 	// GPU上にセットするためのビュー
@@ -1,9 +1,54 @@
 #include "ModelManager.h"
 
 #include <filesystem>
+#include <algorithm>
+#include <cassert>
+#include <format>
 
 #include "DirectXCommon.h"
 #include "ModelCommon.h"
+#include "JobSystem.h"
+#include "Logger.h"
+
+namespace
+{
+	/// <summary>
+	/// 正規化したパスを1文字ずつ渡す
+	/// 区切りごとに見て、空の区切りと"."を飛ばし、区切り文字は'/'、英字は小文字にそろえる
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="emit">1文字ごとに呼ばれる関数</param>
+	template<typename Func>
+	void ForEachNormalizedChar(std::string_view filePath, Func&& emit)
+	{
+		bool hasSegment = false;
+		size_t begin = 0;
+		while (begin <= filePath.size())
+		{
+			size_t end = filePath.find_first_of("/\\", begin);
+			if (end == std::string_view::npos)
+			{
+				end = filePath.size();
+			}
+
+			std::string_view segment = filePath.substr(begin, end - begin);
+			if (!segment.empty() && segment != ".")
+			{
+				if (hasSegment)
+				{
+					emit('/');
+				}
+				for (char c : segment)
+				{
+					emit((c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c);
+				}
+				hasSegment = true;
+			}
+
+			begin = end + 1;
+		}
+	}
+}
 
 ModelManager* ModelManager::GetInstance()
 {
@@ -21,36 +66,287 @@ void ModelManager::Initialize(DirectXCommon* dxCommon)
 
 void ModelManager::LoadModel(const std::string& filePath)
 {
+	// 読み込み済みモデルを検索(ファイル名だけのときは別名から引く)
+	auto found = FindEntry(filePath);
+	if (found != models.end()) {
+		// 読み込み済みなら参照を増やして早期 return
+		models.at(found->first).refCount++;
+		return;
+	}
+	const uint64_t key = HashPath(filePath);
+
 	// ファイルパスからディレクトリとファイル名を抽出
-	std::filesystem::path path(filePath);
-	std::string directory = "resources/models/" + path.parent_path().string();
-	std::string fileName = path.filename().string(); // ファイル名だけを抽出
+	std::string directory;
+	std::string fileName;
+	SplitPath(filePath, directory, fileName);
 
-	// 読み込み済みモデルを検索
-	if (models.contains(filePath)) {
-		// 読み込み済みなら早期 return
+	// モデルの生成とファイル読み込み・初期化 ---
+	std::unique_ptr<Model> model = std::make_unique<Model>();
+	model->LoadData(directory, fileName);
+	// 参照しているテクスチャはモデルが参照を持つ(モデルの破棄で手放す)
+	// 1つずつの読み込みはゲーム中にも呼ばれるので、テクスチャは裏で読み込み、それまでは仮テクスチャで描く
+	TextureManager::GetInstance()->AcquireTexturesAsync(model->GetTextureFilePaths());
+	model->CreateGpuResources(modelCommon_.get());
+
+	// モデルを登録する
+	Register(key, filePath, std::move(model)); // 所有権を譲渡
+}
+
+void ModelManager::LoadModels(const std::vector<std::string>& filePaths)
+{
+	// 読み込み待ちのモデル
+	struct Request
+	{
+		uint64_t key = 0;
+		std::string filePath;
+		std::string directory;
+		std::string fileName;
+		std::unique_ptr<Model> model;
+		uint32_t refCount = 0;
+	};
+
+	// 未読み込みのものだけを重複なく集める
+	std::vector<Request> requests;
+	for (const std::string& filePath : filePaths)
+	{
+		auto loaded = FindEntry(filePath);
+		if (loaded != models.end())
+		{
+			models.at(loaded->first).refCount++;
+			continue;
+		}
+		const uint64_t key = HashPath(filePath);
+
+		auto duplicate = std::find_if(requests.begin(), requests.end(), [key](const Request& other)
+			{
+				return other.key == key;
+			});
+		if (duplicate != requests.end())
+		{
+			duplicate->refCount++;
+			continue;
+		}
+
+		Request request;
+		request.key = key;
+		request.filePath = filePath;
+		SplitPath(filePath, request.directory, request.fileName);
+		request.model = std::make_unique<Model>();
+		request.refCount = 1;
+		requests.push_back(std::move(request));
+	}
+
+	// ファイルの解析はワーカースレッドで並列に行う
+	JobSystem::ParallelFor(requests.size(), [&](size_t index)
+		{
+			requests[index].model->LoadData(requests[index].directory, requests[index].fileName);
+		});
+
+	// 参照しているテクスチャをまとめて読み込む(デコードは並列、転送は1回)
+	// テクスチャの参照はモデルが持ち、モデルの破棄で手放す
+	std::vector<std::string> texturePaths;
+	texturePaths.reserve(requests.size());
+	for (const Request& request : requests)
+	{
+		std::vector<std::string> modelTexturePaths = request.model->GetTextureFilePaths();
+		texturePaths.insert(texturePaths.end(), modelTexturePaths.begin(), modelTexturePaths.end());
+	}
+	TextureManager::GetInstance()->AcquireTextures(texturePaths);
+
+	// GPUリソースの生成と登録はここでまとめて行う
+	for (Request& request : requests)
+	{
+		request.model->CreateGpuResources(modelCommon_.get());
+		Register(request.key, request.filePath, std::move(request.model));
+		models.at(request.key).refCount = request.refCount;
+	}
+}
+
+void ModelManager::ReleaseModel(std::string_view filePath)
+{
+	auto found = FindEntry(filePath);
+	if (found == models.end())
+	{
+		Logger::Log(std::format("ModelManager : release of unknown model {}\n", filePath));
 		return;
 	}
 
-	// ディレクトリが存在しない場合は "resources/models/" をデフォルトに
-	if (directory.empty()) {
-		directory = "resources/models/";
+	Entry& entry = models.at(found->first);
+	assert(entry.refCount > 0);
+	if (--entry.refCount > 0)
+	{
+		return;
 	}
 
-	// モデルの生成とファイル読み込み・初期化 ---
-	std::unique_ptr<Model> model = std::make_unique<Model>();
-	model->Initialize(modelCommon_.get(), directory, fileName);
+	// まだObject3dが使っているなら、使い終わってからCollectReleasedModelsで破棄する
+	if (entry.model->GetUserCount() > 0)
+	{
+		Logger::Log(std::format("ModelManager : {} is still used by {} objects, release deferred\n", entry.path, entry.model->GetUserCount()));
+		return;
+	}
+
+	EraseEntry(found->first);
+}
+
+void ModelManager::CollectReleasedModels()
+{
+	std::vector<uint64_t> releasedKeys;
+	for (const auto& [key, entry] : models)
+	{
+		if (entry.refCount == 0 && entry.model->GetUserCount() == 0)
+		{
+			releasedKeys.push_back(key);
+		}
+	}
+	for (uint64_t key : releasedKeys)
+	{
+		EraseEntry(key);
+	}
+}
 
-	// モデルをmapコンテナに格納する
-	models.insert(std::make_pair(fileName, std::move(model))); // 所有権を譲渡
+void ModelManager::EraseEntry(uint64_t key)
+{
+	const Entry& entry = models.at(key);
+
+	// ファイル名の別名を外す。同名が1つだけ残るならそれをファイル名で引けるようにする
+	const uint64_t fileNameKey = HashPath(GetFileName(entry.path));
+	auto alias = fileNameAliases_.find(fileNameKey);
+	if (alias != fileNameAliases_.end())
+	{
+		if (--alias->second.modelCount == 0)
+		{
+			fileNameAliases_.erase(alias);
+		}
+		else if (alias->second.modelCount == 1)
+		{
+			for (const auto& [otherKey, other] : models)
+			{
+				if (otherKey != key && HashPath(GetFileName(other.path)) == fileNameKey)
+				{
+					alias->second.key = otherKey;
+					break;
+				}
+			}
+		}
+	}
+
+	for (const std::string& texturePath : entry.model->GetTextureFilePaths())
+	{
+		TextureManager::GetInstance()->ReleaseTexture(texturePath);
+	}
+	models.erase(key);
+}
+
+uint32_t ModelManager::GetRefCount(std::string_view filePath) const
+{
+	auto found = FindEntry(filePath);
+	return found != models.end() ? found->second.refCount : 0;
+}
+
+uint64_t ModelManager::GetMemorySize() const
+{
+	uint64_t size = 0;
+	for (const auto& [key, entry] : models)
+	{
+		size += entry.model->GetGpuMemorySize();
+	}
+	return size;
+}
+
+uint64_t ModelManager::HashPath(std::string_view filePath)
+{
+	// FNV-1a(64bit)
+	uint64_t hash = 14695981039346656037ull;
+	ForEachNormalizedChar(filePath, [&hash](char c)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		});
+	return hash;
+}
+
+void ModelManager::SplitPath(const std::string& filePath, std::string& directory, std::string& fileName)
+{
+	std::filesystem::path path(filePath);
+	directory = "resources/models/" + path.parent_path().string();
+	fileName = path.filename().string(); // ファイル名だけを抽出
+}
+
+std::string ModelManager::NormalizePath(std::string_view filePath)
+{
+	std::string normalized;
+	normalized.reserve(filePath.size());
+	ForEachNormalizedChar(filePath, [&normalized](char c) { normalized.push_back(c); });
+	return normalized;
+}
+
+std::string_view ModelManager::GetFileName(std::string_view filePath)
+{
+	size_t separator = filePath.find_last_of("/\\");
+	return separator == std::string_view::npos ? filePath : filePath.substr(separator + 1);
+}
+
+void ModelManager::Register(uint64_t key, const std::string& filePath, std::unique_ptr<Model> model)
+{
+	Entry entry;
+	entry.model = std::move(model);
+	entry.refCount = 1;
+	entry.path = NormalizePath(filePath);
+
+	// ファイル名だけでも引けるようにする。同名のモデルが既にあればファイル名では引けなくなる
+	const uint64_t fileNameKey = HashPath(GetFileName(entry.path));
+	FileNameAlias& alias = fileNameAliases_[fileNameKey];
+	if (alias.modelCount++ == 0)
+	{
+		alias.key = key;
+	}
+	else
+	{
+		Logger::Log(std::format("ModelManager : file name of {} is shared with another model, look it up by its path\n", entry.path));
+	}
+
+	// 64bitハッシュの衝突は起こらない前提だが、念のため確認する
+	assert(!models.contains(key));
+	models.emplace(key, std::move(entry));
+}
+
+std::unordered_map<uint64_t, ModelManager::Entry>::const_iterator ModelManager::FindEntry(std::string_view filePath) const
+{
+	// まずはパスそのもので引く
+	auto found = models.find(HashPath(filePath));
+	if (found != models.end())
+	{
+		return found;
+	}
+
+	// ディレクトリを含むパスはファイル名では引かない(別のモデルを返さないため)
+	if (filePath.find_first_of("/\\") != std::string_view::npos)
+	{
+		return models.end();
+	}
+
+	// ファイル名として引く
+	auto alias = fileNameAliases_.find(HashPath(filePath));
+	if (alias == fileNameAliases_.end())
+	{
+		return models.end();
+	}
+	if (alias->second.modelCount > 1)
+	{
+		Logger::Log(std::format("ModelManager : file name {} matches several models, look it up by its path\n", filePath));
+		assert(false && "ModelManager : ambiguous model file name");
+		return models.end();
+	}
+	return models.find(alias->second.key);
 }
 
-Model* ModelManager::FindModel(const std::string& filePath)
+Model* ModelManager::FindModel(std::string_view filePath) const
 {
 	// 読み込み済みモデルを検索
-	if (models.contains(filePath)) {
+	auto found = FindEntry(filePath);
+	if (found != models.end()) {
 		// 読み込みモデルを戻り値としてreturn
-		return models.at(filePath).get();
+		return found->second.model.get();
 	}
 	// ファイル名一致無し
 	return nullptr;
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
-#include <map>
+#include <string_view>
+#include <unordered_map>
 #include <memory>
+#include <vector>
+#include <cstdint>
 
 #include "Model.h"
 
@@ -12,6 +15,7 @@ class DirectXCommon;
 /// <summary>
 /// モデル管理クラス
 /// モデルの読み込み、検索を行う
+/// モデルは正規化したパスのハッシュで登録し、参照カウントで寿命を管理する
 /// </summary>
 class ModelManager
 {
@@ -44,23 +48,137 @@ public:
 
 	/// <summary>
 	/// モデルファイルの読み込み
+	/// 読み込み済みなら参照カウントだけを増やす(ファイル名だけを渡した場合も読み込み済みのものを探す)
+	/// テクスチャはワーカースレッドで読み込み、終わるまでは仮テクスチャで描画される
 	/// </summary>
-	/// <param name="filePath">ファイルパス</param>
+	/// <param name="filePath">ファイルパス("resources/models/"からの相対パス)</param>
 	void LoadModel(const std::string& filePath);
 
+	/// <summary>
+	/// 複数のモデルファイルをまとめて読み込み
+	/// ファイルの解析とテクスチャのデコードはワーカースレッドで並列に行い、
+	/// GPUリソースの生成と転送はこの関数を呼んだスレッドでまとめて行う(メインスレッドから呼ぶこと)
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	void LoadModels(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// モデルの参照を1つ手放す
+	/// 参照カウントが0になったモデルは破棄する
+	/// まだ使っているObject3dがあれば破棄を遅らせ、CollectReleasedModelsで破棄する
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	void ReleaseModel(std::string_view filePath);
+
+	/// <summary>
+	/// 破棄を遅らせていたモデルのうち、使っているObject3dが無くなったものを破棄する
+	/// 破棄までに読み込み直されたモデルはそのまま使い続ける
+	/// </summary>
+	void CollectReleasedModels();
+
 	/// <summary>
 	/// モデルの検索
+	/// 相対パスでもファイル名だけでも引ける。メモリ確保は行わない
+	/// ファイル名だけで引く場合、同名のモデルが複数あると区別できないのでassertで止める
+	/// </summary>
+	/// <param name="filePath">ファイルパスまたはファイル名</param>
+	/// <returns>モデルデータ(見つからなければnullptr)</returns>
+	Model* FindModel(std::string_view filePath) const;
+
+	/// <summary>
+	/// 参照カウントの取得
+	/// </summary>
+	/// <param name="filePath">ファイルパスまたはファイル名</param>
+	/// <returns>参照カウント(未登録なら0)</returns>
+	uint32_t GetRefCount(std::string_view filePath) const;
+
+	// 読み込み済みモデル数
+	size_t GetModelCount() const { return models.size(); }
+
+	/// <summary>
+	/// 読み込み済みモデルが使っているGPUメモリ量を取得
+	/// </summary>
+	/// <returns>バイト数</returns>
+	uint64_t GetMemorySize() const;
+
+	/// <summary>
+	/// 正規化したパスのハッシュ値を求める
+	/// 区切りを'/'にそろえ、英字を小文字にし、"./"と重複した'/'を取り除いたうえでFNV-1aをとる
 	/// </summary>
 	/// <param name="filePath">ファイルパス</param>
-	/// <returns>モデルデータ</returns>
-	Model* FindModel(const std::string& filePath);
+	/// <returns>ハッシュ値</returns>
+	static uint64_t HashPath(std::string_view filePath);
 
 private:
 
-	// モデルデータ
-	std::map<std::string, std::unique_ptr<Model>> models;
+	// 登録済みモデル
+	struct Entry
+	{
+		std::unique_ptr<Model> model;
+		uint32_t refCount = 0;
+		std::string path; // 正規化したパス(衝突確認とログ用)
+	};
+
+	/// <summary>
+	/// ファイルパスから読み込むディレクトリとファイル名を求める
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="directory">ディレクトリ</param>
+	/// <param name="fileName">ファイル名</param>
+	static void SplitPath(const std::string& filePath, std::string& directory, std::string& fileName);
+
+	/// <summary>
+	/// パスを正規化した文字列を求める
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>正規化したパス</returns>
+	static std::string NormalizePath(std::string_view filePath);
+
+	/// <summary>
+	/// パスからファイル名部分を取り出す
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>ファイル名</returns>
+	static std::string_view GetFileName(std::string_view filePath);
+
+	/// <summary>
+	/// 読み込んだモデルを登録する
+	/// </summary>
+	/// <param name="key">パスのハッシュ値</param>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="model">モデル</param>
+	void Register(uint64_t key, const std::string& filePath, std::unique_ptr<Model> model);
+
+	/// <summary>
+	/// パスまたはファイル名から登録先を探す
+	/// '/'を含まないものだけをファイル名として別名から引く
+	/// </summary>
+	/// <param name="filePath">ファイルパスまたはファイル名</param>
+	/// <returns>登録先(見つからなければend)</returns>
+	std::unordered_map<uint64_t, Entry>::const_iterator FindEntry(std::string_view filePath) const;
+
+	/// <summary>
+	/// 登録を外してモデルを破棄する(別名とテクスチャの参照も外す)
+	/// </summary>
+	/// <param name="key">パスのハッシュ値</param>
+	void EraseEntry(uint64_t key);
+
+private:
+
+	// モデルデータ(メインスレッドからのみ触る。ワーカーは自分のModelだけを扱う)
+	std::unordered_map<uint64_t, Entry> models;
+
+	// ファイル名の別名
+	struct FileNameAlias
+	{
+		uint64_t key = 0;       // 登録先のハッシュ(同名が1つのときだけ有効)
+		uint32_t modelCount = 0; // このファイル名のモデル数
+	};
+
+	// ファイル名のハッシュ -> 別名
+	// 既存の呼び出し側はファイル名だけで引くため、同名が1つだけのときに対応させる
+	std::unordered_map<uint64_t, FileNameAlias> fileNameAliases_;
 
 	// モデル共通部
 	std::unique_ptr<ModelCommon> modelCommon_ = nullptr;
 };
-
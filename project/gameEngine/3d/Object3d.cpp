@@ -2,188 +2,274 @@
 
 #include <fstream>
 #include <sstream>
-#include <numbers>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 #include "Object3dCommon.h"
 #include "Model.h"
 #include "ModelManager.h"
+#include "WinApp.h"
+
+Object3d::~Object3d()
+{
+	SetModel(static_cast<Model*>(nullptr));
+	if (object3dCommon_)
+	{
+		object3dCommon_->GetFrustumCuller().Unregister(cullIndex_);
+	}
+}
 
 void Object3d::Initialize(const std::string& filePath)
 {
 	object3dCommon_ = Object3dCommon::GetInstance();
+	// 視錐台カリングの枠(2回初期化されても枠は1つ)
+	if (cullIndex_ == FrustumCuller::kInvalidIndex)
+	{
+		cullIndex_ = object3dCommon_->GetFrustumCuller().Register();
+	}
 	// モデルを設定
 	SetModel(filePath);
 
 	// 座標変換行列リソースを作る
 	CreateTransformationMatrixData();
 
-	// 平行光源リソースを作る
-	CreateDirectionalLight();
-
 	// Transform変数を作る
 	transform_ = { {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f},{0.0f,4.0f,-10.0f} };
+	isTransformDirty_ = true;
 
 	camera_ = object3dCommon_->GetDefaultCamera();
-
-	// カメラリソースを作る
-	CreateCamera();
-
-	// ポイントライトリソースを作る
-	CreatePointLight();
-
-	// スポットライトリソースを作る
-	CreateSpotLight();
-
-	// 環境マップリソースを作る
-	CreateEnvironment();
 }
 
 void Object3d::Update()
 {
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate);
-	Matrix4x4 worldViewProjectionMatrix;
-	
 	model_->SetEnableLighting(enableLighting);
-	model_->SetEnableDirectionalLight(directionalLightData_->enable);
-	model_->SetEnablePointLight(pointLightData_->enable);
-	model_->SetEnableSpotLight(spotLightData_->enable);
-	model_->SetEnvironment(environmentData_->enable);
-	model_->SetEnvironmentStrength(environmentData_->strength);
+	model_->SetEnableDirectionalLight(enableDirectionalLight_);
+	model_->SetEnablePointLight(enablePointLight_);
+	model_->SetEnableSpotLight(enableSpotLight_);
+	model_->SetEnvironment(enableEnvironment_);
+	model_->SetEnvironmentStrength(environmentStrength_);
 
+	// モデルが差し替えられていれば階層を作り直す
+	if (hierarchyModel_ != model_)
+	{
+		BuildHierarchy();
+	}
+
+	// Transformが変わったときだけ0番の行列を入れ直す(動かない壁や床は初回だけ)
+	if (isTransformDirty_)
+	{
+		hierarchy_.SetLocalMatrix(0, MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate));
+		isTransformDirty_ = false;
+	}
 
+	// 変わったノードの子孫だけワールド行列を作り直す(付けたノードもここで決まる)
+	if (hierarchy_.Propagate() and hierarchy_.IsChanged(kModelRootNodeIndex_))
+	{
+		// 描画に使うのはモデルのルートノードのワールド行列
+		transformationMatrix_.World = hierarchy_.GetWorldMatrix(kModelRootNodeIndex_);
+		isWvpDirty_ = true;
+	}
+
+	// カメラが差し替えられたか、カメラの行列が作り直されていればWVPも作り直す
+	const uint32_t cameraVersion = camera_ ? camera_->GetMatrixVersion() : 0;
+	if (camera_.get() != lastCamera_ or cameraVersion != lastCameraVersion_)
+	{
+		lastCamera_ = camera_.get();
+		lastCameraVersion_ = cameraVersion;
+		isWvpDirty_ = true;
+	}
+
+	// 以下はワールド行列かカメラが変わったときだけでよい
+	if (!isWvpDirty_)
+	{
+		return;
+	}
+	isWvpDirty_ = false;
 
 	if (camera_)
 	{
-		const Matrix4x4& viewProjectionMatrix = camera_->GetViewProjectionMatrix();
-		worldViewProjectionMatrix = (worldMatrix * viewProjectionMatrix);
+		transformationMatrix_.WVP = transformationMatrix_.World * camera_->GetViewProjectionMatrix();
 	}
 	else
 	{
-		worldViewProjectionMatrix = worldMatrix;
+		transformationMatrix_.WVP = transformationMatrix_.World;
 	}
 
-	//transformationMatrixData_->WVP = worldViewProjectionMatrix;
-	//transformationMatrixData_->World = worldMatrix;
+	// 視錐台カリング用のワールド空間のAABB(判定はデフォルトカメラで行うので、別のカメラで描くものは常に描く)
+	FrustumCuller& culler = object3dCommon_->GetFrustumCuller();
+	if (camera_ and camera_ == object3dCommon_->GetDefaultCamera())
+	{
+		Vector3 center;
+		Vector3 extent;
+		FrustumCuller::TransformBounds(model_->GetBoundsMin(), model_->GetBoundsMax(), transformationMatrix_.World, center, extent);
+		culler.SetBounds(cullIndex_, center, extent);
+	}
+	else
+	{
+		culler.SetAlwaysVisible(cullIndex_);
+	}
 
-	transformationMatrixData_->WVP = model_->GetModelData().rootNode.localMatrix * worldViewProjectionMatrix;
-	transformationMatrixData_->World = model_->GetModelData().rootNode.localMatrix * worldMatrix;
+	// 画面上の大きさから詳細度の段を選ぶ
+	lodIndex_ = 0;
+	if (camera_ and model_->GetLodCount() > 1)
+	{
+		const float scale = (std::max)({ std::abs(transform_.scale.x), std::abs(transform_.scale.y), std::abs(transform_.scale.z) });
+		// 境界球の手前の面までの距離で測る(中に入っているときは一番細かい段)
+		const float distance = (transform_.translate - camera_->GetPosition()).Length() - model_->GetBoundingRadius() * scale;
+		if (distance > 0.0f)
+		{
+			const float pixelsPerUnit = scale * WinApp::kClientHeight * 0.5f / (distance * std::tan(camera_->GetFovY() * 0.5f));
+			lodIndex_ = model_->SelectLod(pixelsPerUnit);
+		}
+	}
 }
 
 void Object3d::Draw()
 {
-	// TransformationMatrixCBufferの場所を設定
-	object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource_->GetGPUVirtualAddress());
-	// 平行光源CBufferの場所を設定
-	object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource_->GetGPUVirtualAddress());
-	// カメラCBufferの場所を設定
-	object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(4, cameraResource_->GetGPUVirtualAddress());
-	// ポイントライトCBufferの場所を設定
-	object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(5, pointLightResource_->GetGPUVirtualAddress());
-	// スポットライトCBufferの場所を設定
-	object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(6, spotLightResource_->GetGPUVirtualAddress());
+	if (!model_ or !IsVisible())
+	{
+		return;
+	}
 
-	if (environmentMapHandle_.ptr != 0) 
+	// 座標変換行列は今の値をフレームごとのアップロード領域に書き込んでおく
+	DirectXCommon::UploadAllocation transformation = object3dCommon_->GetDxCommon()->AllocateUpload(sizeof(TransformationMatrix));
+	if (!transformation.cpuAddress)
 	{
-		//object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, environmentMapHandle_);
-		//SetGraphicsRootDescriptorTable
-		object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(8, environmentMapHandle_);
+		// 書き込み先が無いので、このフレームは描かない
+		return;
 	}
+	std::memcpy(transformation.cpuAddress, &transformationMatrix_, sizeof(TransformationMatrix));
 
-	if (model_)
+	// コマンドは並べ替えてから積むので、モデルも今の値で持たせる
+	const Vector3 worldPosition = { transformationMatrix_.World.m[3][0], transformationMatrix_.World.m[3][1], transformationMatrix_.World.m[3][2] };
+	object3dCommon_->SubmitDraw(model_, lodIndex_, false, isTransparent_, worldPosition, [this, model = model_, address = transformation.gpuAddress](uint32_t subMeshIndex)
+		{
+			// TransformationMatrixCBufferの場所を設定
+			object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, address);
+
+			BindEnvironmentMap();
+
+			// モデルの頂点形式に合うパイプラインにする
+			object3dCommon_->SetVertexFormat(model->GetVertexFormat());
+			model->DrawSubMesh(subMeshIndex);
+		});
+}
+
+void Object3d::DrawInstanced()
+{
+	if (!model_ or !IsVisible())
 	{
-		model_->Draw();
+		return;
 	}
+
+	InstanceBatcher::InstanceData instance;
+	instance.WVP = transformationMatrix_.WVP;
+	instance.World = transformationMatrix_.World;
+	instance.WorldInvTranspose = transformationMatrix_.WorldInvTranspose;
+	object3dCommon_->AddInstance(model_, lodIndex_, this, instance);
 }
 
-void Object3d::SetModel(const std::string& filePath)
+uint32_t Object3d::AttachNode(uint32_t parentIndex, const Matrix4x4& localMatrix)
 {
-	model_ = ModelManager::GetInstance()->FindModel(filePath);
-	modelFilePath_ = filePath;
+	// 階層がまだ無ければ先に作る(子は親より後ろに並ぶ)
+	if (hierarchyModel_ != model_)
+	{
+		BuildHierarchy();
+	}
+	return hierarchy_.AddNode(static_cast<int32_t>(parentIndex), localMatrix);
 }
 
-void Object3d::SetEnvironmentMapHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle, bool useEnvironmentMap)
+int32_t Object3d::FindNode(const std::string& name) const
 {
-	environmentMapHandle_ = handle;
-	environmentData_->enable = useEnvironmentMap;
+	if (!model_)
+	{
+		return -1;
+	}
+	const std::vector<Model::FlatNode>& nodes = model_->GetNodes();
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		if (nodes[i].name == name)
+		{
+			// 0番はこのオブジェクト自身なのでモデルのノードは1つずれる
+			return static_cast<int32_t>(i + kModelRootNodeIndex_);
+		}
+	}
+	return -1;
 }
 
-void Object3d::CreateTransformationMatrixData()
+bool Object3d::IsVisible() const
 {
-	// 座標変換行列リソースを作る
-	transformationMatrixResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(TransformationMatrix));
-	//書き込むためのアドレス
-	transformationMatrixResource_->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData_));
-	//単位行列を書き込んでおく
-	transformationMatrixData_->World = MakeIdentity4x4();
-	transformationMatrixData_->WVP = MakeIdentity4x4();
-	transformationMatrixData_->WorldInvTranspose = InverseTranspose(transformationMatrixData_->World);
+	return object3dCommon_->GetFrustumCuller().IsVisible(cullIndex_);
 }
 
-void Object3d::CreateDirectionalLight()
+void Object3d::BindEnvironmentMap() const
 {
-	// 平行光源リソースを作る
-	directionalLightResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(DirectionalLight));
-	//書き込むためのアドレス
-	directionalLightResource_->Map(0, nullptr, reinterpret_cast<void**>(&directionalLightData_));
-	//デフォルト値は以下のようにしておく
-	directionalLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	directionalLightData_->direction = Normalize({ 0.0f,-1.0f,0.0f });
-	directionalLightData_->intensity = 1.0f;
-	directionalLightData_->enable = false;
+	if (environmentMapHandle_.ptr != 0) 
+	{
+		//object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, environmentMapHandle_);
+		//SetGraphicsRootDescriptorTable
+		object3dCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(8, environmentMapHandle_);
+	}
+}
+
+void Object3d::SetModel(Model* model)
+{
+	// 使用中の数を付け替える(0になるまでモデルは破棄されない)
+	if (model)
+	{
+		model->AddUser();
+	}
+	if (model_)
+	{
+		model_->RemoveUser();
+	}
+	model_ = model;
+	isTransformDirty_ = true;
 }
 
-void Object3d::CreateCamera()
+void Object3d::SetModel(const std::string& filePath)
 {
-	// カメラリソースを作る
-	cameraResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(CameraForGPU));
-	//書き込むためのアドレス
-	cameraResource_->Map(0, nullptr, reinterpret_cast<void**>(&cameraData_));
-	//デフォルト値は以下のようにしておく
-	cameraData_->worldPosition = camera_->GetPosition();
+	SetModel(ModelManager::GetInstance()->FindModel(filePath));
+	modelFilePath_ = filePath;
 }
 
-void Object3d::CreatePointLight()
+void Object3d::SetEnvironmentMapHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle, bool useEnvironmentMap)
 {
-	// ポイントライトリソースを作る
-	pointLightResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(PointLight));
-	// 書き込むためのアドレス
-	pointLightResource_->Map(0, nullptr, reinterpret_cast<void**>(&pointLightData_));
-	// デフォルト値は以下のようにしておく
-	pointLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	pointLightData_->position = { 0.0f,0.0f,0.0f };
-	pointLightData_->intensity = 1.0f;
-	pointLightData_->radius = 10.0f;
-	pointLightData_->decay = 1.0f;
-	pointLightData_->enable = false;
+	environmentMapHandle_ = handle;
+	enableEnvironment_ = useEnvironmentMap;
 }
 
-void Object3d::CreateSpotLight()
+void Object3d::CreateTransformationMatrixData()
 {
-	// スポットライトリソースを作る
-	spotLightResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(SpotLight));
-	// 書き込むためのアドレス
-	spotLightResource_->Map(0, nullptr, reinterpret_cast<void**>(&spotLightData_));
-	// デフォルト値は以下のようにしておく
-	spotLightData_->color = { 1.0f,1.0f,1.0f,1.0f };
-	spotLightData_->position = { 2.0f,1.25f,0.0f };
-	spotLightData_->intensity = 4.0f;
-	spotLightData_->direction = Normalize({ 0.0f,-1.0f,0.0f });
-	spotLightData_->distance = 7.0f;
-	spotLightData_->decay = 2.0f;
-	spotLightData_->consAngle = std::cos(std::numbers::pi_v<float> / 3.0f);
-	spotLightData_->cosFalloffStart = 1.0f;
-	spotLightData_->enable = false;
+	// GPUへは描画のたびにフレームごとのアップロード領域へ書き込むので、ここでは単位行列を入れておくだけ
+	transformationMatrix_.World = MakeIdentity4x4();
+	transformationMatrix_.WVP = MakeIdentity4x4();
+	transformationMatrix_.WorldInvTranspose = InverseTranspose(transformationMatrix_.World);
 }
 
-void Object3d::CreateEnvironment()
+void Object3d::BuildHierarchy()
 {
-	// 環境マップリソースを作る
-	environmentResource_ = object3dCommon_->GetDxCommon()->CreateBufferResource(sizeof(Environment));
-	// 書き込むためのアドレス
-	environmentResource_->Map(0, nullptr, reinterpret_cast<void**>(&environmentData_));
-	// デフォルト値は以下のようにしておく
-	environmentData_->enable = false;
-	environmentData_->strength = 0.5f;
+	hierarchy_.Clear();
+	hierarchyModel_ = model_;
+
+	// 0番はこのオブジェクト自身
+	hierarchy_.AddNode(TransformHierarchy::kNoParent, MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate));
+	isTransformDirty_ = false;
+
+	// モデルのノードはルートを0番の子にして、読み込んだ順(親が先)に並べる
+	const std::vector<Model::FlatNode> emptyNodes;
+	const std::vector<Model::FlatNode>& nodes = model_ ? model_->GetNodes() : emptyNodes;
+	if (nodes.empty())
+	{
+		hierarchy_.AddNode(0, model_ ? model_->GetRootMatrix() : MakeIdentity4x4());
+		return;
+	}
+	for (const Model::FlatNode& node : nodes)
+	{
+		const int32_t parentIndex = node.parentIndex < 0 ? 0 : node.parentIndex + static_cast<int32_t>(kModelRootNodeIndex_);
+		hierarchy_.AddNode(parentIndex, node.localMatrix);
+	}
 }
 
 std::string Object3d::GetModel() const
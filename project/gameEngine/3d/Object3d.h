@@ -3,6 +3,7 @@
 #include "MyMath.h"
 #include "TextureManager.h"
 #include "CameraManager.h"
+#include "TransformHierarchy.h"
 
 class Object3dCommon;
 class Model;
@@ -14,6 +15,12 @@ class Object3d
 {
 public:
 
+	Object3d() = default;
+	~Object3d();
+	// 視錐台カリングの枠を持つのでコピーしない
+	Object3d(const Object3d&) = delete;
+	Object3d& operator=(const Object3d&) = delete;
+
 	/// <summary>
 	/// 初期化
 	/// </summary>
@@ -21,17 +28,45 @@ public:
 	void Initialize(const std::string& filePath);
 
 	/// <summary>
-	/// 更新処理
+	/// 更新処理(Transformかカメラが変わったときだけ行列を作り直す)
 	/// </summary>
 	void Update();
 
 	/// <summary>
-	/// 描画処理
+	/// 描画処理(視錐台の外にあれば何もしない)
+	/// 描画は並べ替えの列に積まれ、MyGame::Drawで他の描画と一緒に実行される
 	/// </summary>
 	void Draw();
 
+	/// <summary>
+	/// インスタンス描画に積む(Object3dCommon::FlushDrawsで同じモデルのものとまとめて並べ替えの列に積む)
+	/// 環境マップはまとめた中で最初に積まれたオブジェクトのものになるので、同じ設定のオブジェクトにだけ使う
+	/// </summary>
+	void DrawInstanced();
+
+	/// <summary>
+	/// 環境マップを設定する(設定されていなければ何もしない)
+	/// </summary>
+	void BindEnvironmentMap() const;
+
+	/// <summary>
+	/// ノードに子を付ける(エフェクト等をモデルの一部に追従させる)
+	/// ワールド行列は次のUpdateで決まる。モデルを差し替えると付けたノードは消える
+	/// </summary>
+	/// <param name="parentIndex">親のノードの番号(0はこのオブジェクト自身)</param>
+	/// <param name="localMatrix">親から見た行列</param>
+	/// <returns>付けたノードの番号</returns>
+	uint32_t AttachNode(uint32_t parentIndex, const Matrix4x4& localMatrix);
+
 public: // セッター
 
+	/// <summary>
+	/// 付けたノードの行列設定
+	/// </summary>
+	/// <param name="index">ノードの番号</param>
+	/// <param name="localMatrix">親から見た行列</param>
+	void SetNodeLocalMatrix(uint32_t index, const Matrix4x4& localMatrix) { hierarchy_.SetLocalMatrix(index, localMatrix); }
+
 	/// <summary>
 	/// カメラ設定
 	/// </summary>
@@ -40,9 +75,10 @@ public: // セッター
 
 	/// <summary>
 	/// モデル設定
+	/// 設定中のモデルはModelManagerが破棄を遅らせる
 	/// </summary>
 	/// <param name="model">モデル</param>
-	void SetModel(Model* model) { model_ = model; }
+	void SetModel(Model* model);
 
 	/// <summary>
 	/// モデル設定(ファイルパスから)
@@ -54,19 +90,19 @@ public: // セッター
 	/// スケール設定
 	/// </summary>
 	/// <param name="scale">スケール</param>
-	void SetScale(const Vector3& scale) { transform_.scale = scale; }
+	void SetScale(const Vector3& scale) { transform_.scale = scale; isTransformDirty_ = true; }
 
 	/// <summary>
 	/// 回転設定
 	/// </summary>
 	/// <param name="rotate">回転</param>
-	void SetRotate(const Vector3& rotate) { transform_.rotate = rotate; }
+	void SetRotate(const Vector3& rotate) { transform_.rotate = rotate; isTransformDirty_ = true; }
 
 	/// <summary>
 	/// 位置設定
 	/// </summary>
 	/// <param name="translate">位置</param>
-	void SetPosition(const Vector3& translate) { transform_.translate = translate; }
+	void SetPosition(const Vector3& translate) { transform_.translate = translate; isTransformDirty_ = true; }
 
 	/// <summary>
 	/// 環境マップ設定
@@ -75,6 +111,12 @@ public: // セッター
 	/// <param name="useEnvironmentMap">環境マップを使用するかどうか</param>
 	void SetEnvironmentMapHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle, bool useEnvironmentMap);
 
+	/// <summary>
+	/// 半透明として描くか設定(不透明なものを描いた後に奥から順に描く。DrawInstancedには効かない)
+	/// </summary>
+	/// <param name="isTransparent">半透明として描くか</param>
+	void SetTransparent(bool isTransparent) { isTransparent_ = isTransparent; }
+
 public: // ゲッター
 
 	// スケール取得
@@ -89,6 +131,29 @@ public: // ゲッター
 	// モデル取得
 	std::string GetModel() const;
 
+	// 今のフレームで描画する詳細度の段
+	uint32_t GetLodIndex() const { return lodIndex_; }
+
+	// 最後の視錐台カリングで見えていたか
+	bool IsVisible() const;
+
+	// 半透明として描くか
+	bool IsTransparent() const { return isTransparent_; }
+
+	/// <summary>
+	/// モデルのノードを名前から探す
+	/// </summary>
+	/// <param name="name">ノード名</param>
+	/// <returns>ノードの番号(見つからなければ-1)</returns>
+	int32_t FindNode(const std::string& name) const;
+
+	// ノードのワールド行列(0はこのオブジェクト自身。Updateの後で有効)
+	// ノードを付けると置き場所が変わるので、参照やアドレスは持ち続けないこと(追従させるならノードの番号を持つ)
+	const Matrix4x4& GetNodeWorldMatrix(uint32_t index) const { return hierarchy_.GetWorldMatrix(index); }
+
+	// ノードの数(0番のオブジェクト自身と付けたノードを含む。最初のUpdateまでは0のことがある)
+	uint32_t GetNodeCount() const { return hierarchy_.GetNodeCount(); }
+
 private:
 
 	struct TransformationMatrix
@@ -98,14 +163,6 @@ private:
 		Matrix4x4 WorldInvTranspose;
 	};
 
-	struct DirectionalLight
-	{
-		Vector4 color;
-		Vector3 direction;
-		float intensity;
-		bool enable;
-	};
-
 	struct Transform
 	{
 		Vector3 scale;
@@ -113,226 +170,52 @@ private:
 		Vector3 translate;
 	};
 
-	struct CameraForGPU
-	{
-		Vector3 worldPosition;
-	};
-
-	struct PointLight
-	{
-		Vector4 color;
-		Vector3 position;
-		float intensity;
-		float radius;
-		float decay;
-		bool enable;
-		char padding[3];
-	};
-
-	struct SpotLight
-	{
-		Vector4 color;
-		Vector3 position;
-		Vector3 direction;
-		float intensity;
-		float distance;
-		float decay;
-		float consAngle;
-		float cosFalloffStart;
-		bool enable;
-	};
-
-	struct Environment
-	{
-		bool enable;
-		float strength;
-	};
-
-public: // ライト等
+public: // ライト等(光源の値はシーン共通なのでObject3dCommonで設定する)
 
 	/// <summary>
-	/// 座標変換行列データ生成
+	/// 座標変換行列データの初期化
 	/// </summary>
 	void CreateTransformationMatrixData();
 
 	/// <summary>
-	/// 平行光源データ生成
+	/// このオブジェクトとモデルのノードで座標変換の階層を作り直す
 	/// </summary>
-	void CreateDirectionalLight();
-	/// <summary>
-	/// 平行光源設定
-	/// </summary>
-	/// <param name="directionalLight">平行光源データ</param>
-	void SetDirectionalLight(const DirectionalLight& directionalLight) { *directionalLightData_ = directionalLight; }
-	/// <summary>
-	/// 平行光源取得
-	/// </summary>
-	/// <returns>平行光源データ</returns>
-	DirectionalLight GetDirectionalLight() { return *directionalLightData_; }
-	/// <summary>
-	/// 平行光源の方向設定
-	/// </summary>
-	/// <param name="direction">方向ベクトル</param>
-	void SetDirectionalLightDirection(const Vector3& direction) { directionalLightData_->direction = direction; }
-	/// <summary>
-	/// 平行光源の色設定
-	/// </summary>
-	/// <param name="color">色ベクトル</param>
-	void SetDirectionalLightColor(const Vector4& color) { directionalLightData_->color = color; }
-	/// <summary>
-	/// 平行光源の強さ設定
-	/// </summary>
-	/// <param name="intensity">強さ</param>
-	void SetDirectionalLightIntensity(float intensity) { directionalLightData_->intensity = intensity; }
-	
+	void BuildHierarchy();
+
 	/// <summary>
 	/// 平行光源のオンオフ設定
 	/// </summary>
 	/// <param name="enable"> オンオフフラグ</param>
-	void SetDirectionalLightEnable(bool enable) { directionalLightData_->enable = enable; }
+	void SetDirectionalLightEnable(bool enable) { enableDirectionalLight_ = enable; }
 
-	/// <summary>
-	/// カメラデータ生成
-	/// </summary>
-	void CreateCamera();
-
-	/// <summary>
-	/// ポイントライトデータ生成
-	/// </summary>
-	void CreatePointLight();
-	/// <summary>
-	/// ポイントライト設定
-	/// </summary>
-	/// <param name="pointLight">ポイントライトデータ</param>
-	void SetPointLight(const PointLight& pointLight) { *pointLightData_ = pointLight; }
-	/// <summary>
-	/// ポイントライト取得
-	/// </summary>
-	/// <returns>ポイントライトデータ</returns>
-	PointLight GetPointLight() { return *pointLightData_; }
-	/// <summary>
-	/// ポイントライトの位置設定
-	/// </summary>
-	/// <param name="position">位置ベクトル</param>
-	void SetPointLightPosition(const Vector3& position) { pointLightData_->position = position; }
-	/// <summary>
-	/// ポイントライトの色設定
-	/// </summary>
-	/// <param name="color">色ベクトル</param>
-	void SetPointLightColor(const Vector4& color) { pointLightData_->color = color; }
-	/// <summary>
-	/// ポイントライトの強さ設定
-	/// </summary>
-	/// <param name="intensity">強さ</param>
-	void SetPointLightIntensity(float intensity) { pointLightData_->intensity = intensity; }
-	/// <summary>
-	/// ポイントライトの距離設定
-	/// </summary>
-	/// <param name="radius">距離</param>
-	void SetPointLightRadius(float radius) { pointLightData_->radius = radius; }
-	/// <summary>
-	/// ポイントライトの距離取得
-	/// </summary>
-	/// <returns>距離</returns>
-	float GetPointLightRadius() { return pointLightData_->radius; }
-	/// <summary>
-	/// ポイントライトの減衰率設定
-	/// </summary>
-	/// <param name="decay">減衰率</param>
-	void SetPointLightDecay(float decay) { pointLightData_->decay = decay; }
-	/// <summary>
-	/// ポイントライトの減衰率取得
-	/// </summary>
-	/// <returns>減衰率</returns>
-	float GetPointLightDecay() { return pointLightData_->decay; }
 	/// <summary>
 	/// ポイントライトのオンオフ設定
 	/// </summary>
 	/// <param name="enable">オンオフフラグ</param>
-	void SetPointLightEnable(bool enable) { pointLightData_->enable = enable; }
+	void SetPointLightEnable(bool enable) { enablePointLight_ = enable; }
 
-	
-	/// <summary>
-	/// スポットライトデータ生成
-	/// </summary>
-	void CreateSpotLight();
-	/// <summary>
-	/// スポットライト設定
-	/// </summary>
-	/// <param name="spotLight">スポットライトデータ</param>
-	void SetSpotLight(const SpotLight& spotLight) { *spotLightData_ = spotLight; }
-	/// <summary>
-	/// スポットライト取得
-	/// </summary>
-	/// <returns>スポットライトデータ</returns>
-	SpotLight GetSpotLight() { return *spotLightData_; }
-	/// <summary>
-	/// スポットライトの位置
-	/// </summary>
-	/// <param name="position">位置ベクトル</param>
-	void SetSpotLightPosition(const Vector3& position) { spotLightData_->position = position; }
-	/// <summary>
-	/// スポットライトの方向設定
-	/// </summary>
-	/// <param name="direction">方向ベクトル</param>
-	void SetSpotLightDirection(const Vector3& direction) { spotLightData_->direction = direction; }
-	/// <summary>
-	/// スポットライトの色設定
-	/// </summary>
-	/// <param name="color">色ベクトル</param>
-	void SetSpotLightColor(const Vector4& color) { spotLightData_->color = color; }
-	/// <summary>
-	/// スポットライトの強さ設定
-	/// </summary>
-	/// <param name="intensity">強さ</param>
-	void SetSpotLightIntensity(float intensity) { spotLightData_->intensity = intensity; }
-	/// <summary>
-	/// スポットライトの距離設定
-	/// </summary>
-	/// <param name="distance">距離</param>
-	void SetSpotLightDistance(float distance) { spotLightData_->distance = distance; }
-	/// <summary>
-	/// スポットライトの減衰率設定
-	/// </summary>
-	/// <param name="decay">減衰率</param>
-	void SetSpotLightDecay(float decay) { spotLightData_->decay = decay; }
-	/// <summary>
-	/// スポットライトのコーン角度設定
-	/// </summary>
-	/// <param name="consAngle">コーン角度</param>
-	void SetSpotLightConsAngle(float consAngle) { spotLightData_->consAngle = consAngle; }
-	/// <summary>
-	/// スポットライトのコーン外側減衰開始角度の余弦設定
-	/// </summary>
-	/// <param name="cosFalloffStart">コーン外側減衰開始角度の余弦</param>
-	void SetSpotLightCosFalloffStart(float cosFalloffStart) { spotLightData_->cosFalloffStart = cosFalloffStart; }
 	/// <summary>
 	/// スポットライトのオンオフ設定
 	/// </summary>
 	/// <param name="enable">オンオフフラグ</param>
-	void SetSpotLightEnable(bool enable) { spotLightData_->enable = enable; }
+	void SetSpotLightEnable(bool enable) { enableSpotLight_ = enable; }
 
-	
 	/// <summary>
 	/// ライティングのオンオフ設定
 	/// </summary>
 	/// <param name="enable">オンオフフラグ</param>
 	void SetLighting(bool enable) { enableLighting = enable; }
 
-	/// <summary>
-	/// 環境マップデータ生成
-	/// </summary>
-	void CreateEnvironment();
 	/// <summary>
 	/// 環境マップのオンオフ設定
 	/// </summary>
 	/// <param name="enable">オンオフフラグ</param>
-	void IsEnvironment(bool enable) { environmentData_->enable = enable; }
+	void IsEnvironment(bool enable) { enableEnvironment_ = enable; }
 	/// <summary>
 	/// 環境マップの強さ設定
 	/// </summary>
 	/// <param name="strength">強さ</param>
-	void SetEnvironmentStrength(float strength) { environmentData_->strength = strength; }
+	void SetEnvironmentStrength(float strength) { environmentStrength_ = strength; }
 
 private:
 
@@ -342,34 +225,45 @@ private:
 
 	Model* model_ = nullptr;
 	
-	//TransformationMatrix用のリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource_{};
-	// 平行光源リソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource_{};
-	// カメラリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> cameraResource_{};
-	// ポイントライトリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> pointLightResource_{};
-	// スポットライトリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> spotLightResource_{};
-	// 環境マップリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> environmentResource_{};
-
-
-	//// バッファリソース内のデータを指すポインタ
-	TransformationMatrix* transformationMatrixData_ = nullptr;
-	DirectionalLight* directionalLightData_ = nullptr;
-	CameraForGPU* cameraData_ = nullptr;
-	PointLight* pointLightData_ = nullptr;
-	SpotLight* spotLightData_ = nullptr;
-	Environment* environmentData_ = nullptr;
+	// 座標変換行列(描画のたびにフレームごとのアップロード領域へ書き込む)
+	TransformationMatrix transformationMatrix_{};
 
 	D3D12_GPU_DESCRIPTOR_HANDLE environmentMapHandle_ = { 0 };
 
 	Transform transform_{};
 
+	// このオブジェクトを0番、モデルのノードをその子として並べた座標変換
+	TransformHierarchy hierarchy_;
+	// hierarchy_を作ったときのモデル
+	const Model* hierarchyModel_ = nullptr;
+	// モデルのルートノードの番号(ワールド行列に使う)
+	static const uint32_t kModelRootNodeIndex_ = 1;
+	// Transformかモデルが変わってワールド行列を作り直す必要があるか
+	bool isTransformDirty_ = true;
+	// WVPを作り直す必要があるか
+	bool isWvpDirty_ = true;
+	// 最後にWVPを作ったときのカメラと、その行列を作り直した回数
+	const Camera* lastCamera_ = nullptr;
+	uint32_t lastCameraVersion_ = 0;
+
+	// 描画する詳細度の段(Updateで画面上の大きさから選ぶ)
+	uint32_t lodIndex_ = 0;
+
+	// 視錐台カリングの枠の番号(Updateでワールド空間のAABBを書き込む)
+	uint32_t cullIndex_ = UINT32_MAX;
+
+	// 半透明として描くか
+	bool isTransparent_ = false;
+
 	//ライトのオンオフ
 	bool enableLighting = false;
+	bool enableDirectionalLight_ = false;
+	bool enablePointLight_ = false;
+	bool enableSpotLight_ = false;
+
+	// 環境マップ
+	bool enableEnvironment_ = false;
+	float environmentStrength_ = 0.5f;
 
 	std::string modelFilePath_;
 };
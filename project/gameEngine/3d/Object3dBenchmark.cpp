@@ -0,0 +1,227 @@
+#include "Object3dBenchmark.h"
+
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+
+#include "TransformHierarchy.h"
+#include "FrustumCuller.h"
+
+#include "json/json.hpp"
+
+const Vector3 Object3dBenchmark::kCameraPosition_ = { 0.0f, 5.0f, -30.0f };
+
+namespace
+{
+	struct ObjectTransform
+	{
+		Vector3 scale;
+		Vector3 rotate;
+		Vector3 translate;
+	};
+
+	// 動かすオブジェクトの1フレームの回転量
+	const float kRotateSpeed = 0.01f;
+	// 格子に並べるときの1列の数と間隔
+	const uint32_t kGridWidth = 25;
+	const float kGridSpacing = 4.0f;
+	// モデルの範囲(原点中心の一辺2の立方体)
+	const Vector3 kBoundsMin = { -1.0f,-1.0f,-1.0f };
+	const Vector3 kBoundsMax = { 1.0f,1.0f,1.0f };
+	// Object3dの階層で、モデルのルートノードの番号(0番はオブジェクト自身)
+	const uint32_t kModelRootNodeIndex = 1;
+}
+
+bool Object3dBenchmark::Run(const Setting& setting, const std::string& outputFilePath)
+{
+	const ModelData modelData = MakeModelData(setting);
+	const Matrix4x4 viewProjectionMatrix = MakeViewProjectionMatrix();
+	const uint32_t objectCount = setting.objectCount;
+	const uint32_t movingCount = objectCount * (std::min)(setting.movingPercent, 100u) / 100;
+
+	// カメラの前に格子状に並べる
+	std::vector<ObjectTransform> initialTransforms(objectCount);
+	for (uint32_t i = 0; i < objectCount; ++i)
+	{
+		const float column = static_cast<float>(i % kGridWidth) - static_cast<float>(kGridWidth / 2);
+		const float row = static_cast<float>(i / kGridWidth);
+		initialTransforms[i] = { { 1.0f,1.0f,1.0f }, { 0.0f,0.1f * static_cast<float>(i),0.0f }, { column * kGridSpacing,0.0f,row * kGridSpacing } };
+	}
+
+	nlohmann::json results = nlohmann::json::array();
+
+	// 全オブジェクトの1フレーム分の更新を計測して結果に足す
+	auto measure = [&](const std::string& pathName, const std::function<void()>& updateFrame)
+		{
+			float totalMs = 0.0f;
+			float minMs = 0.0f;
+			float maxMs = 0.0f;
+			for (uint32_t frame = 0; frame < setting.warmupFrames + setting.frames; ++frame)
+			{
+				const auto start = std::chrono::steady_clock::now();
+				updateFrame();
+				const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				if (frame < setting.warmupFrames)
+				{
+					continue;
+				}
+
+				minMs = totalMs == 0.0f ? ms : (std::min)(minMs, ms);
+				maxMs = (std::max)(maxMs, ms);
+				totalMs += ms;
+			}
+
+			const float averageMs = totalMs / static_cast<float>((std::max)(setting.frames, 1u));
+			results.push_back({
+				{ "path", pathName },
+				{ "averageMs", averageMs },
+				{ "minMs", minMs },
+				{ "maxMs", maxMs },
+				{ "usPerObject", objectCount > 0 ? averageMs * 1000.0f / static_cast<float>(objectCount) : 0.0f },
+				});
+		};
+
+	std::vector<Matrix4x4> worldMatrices(objectCount);
+	std::vector<Matrix4x4> wvpMatrices(objectCount);
+
+	// 以前のModel::GetModelDataは値で返していたので、ルート行列を読むたびにモデル全体をコピーしていた
+	// (呼び出しを間接にして、コピーが最適化で消えないようにする)
+	const std::function<ModelData()> getModelData = [&modelData]() { return modelData; };
+	{
+		std::vector<ObjectTransform> transforms = initialTransforms;
+		measure("copyModelData", [&]()
+			{
+				for (uint32_t i = 0; i < objectCount; ++i)
+				{
+					if (i < movingCount)
+					{
+						transforms[i].rotate.y += kRotateSpeed;
+					}
+					const Matrix4x4 worldMatrix = MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+					const Matrix4x4 worldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+					wvpMatrices[i] = getModelData().rootNode.localMatrix * worldViewProjectionMatrix;
+					worldMatrices[i] = getModelData().rootNode.localMatrix * worldMatrix;
+				}
+			});
+	}
+
+	// ルート行列を参照するだけにしたもの
+	{
+		std::vector<ObjectTransform> transforms = initialTransforms;
+		measure("rootMatrixReference", [&]()
+			{
+				const Matrix4x4& rootMatrix = modelData.rootNode.localMatrix;
+				for (uint32_t i = 0; i < objectCount; ++i)
+				{
+					if (i < movingCount)
+					{
+						transforms[i].rotate.y += kRotateSpeed;
+					}
+					const Matrix4x4 worldMatrix = MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate);
+					const Matrix4x4 worldViewProjectionMatrix = worldMatrix * viewProjectionMatrix;
+					wvpMatrices[i] = rootMatrix * worldViewProjectionMatrix;
+					worldMatrices[i] = rootMatrix * worldMatrix;
+				}
+			});
+	}
+
+	// 今のObject3d::Update(動いたものだけ階層を伝播し、WVPとカリングの範囲を作り直してまとめて判定する)
+	{
+		std::vector<ObjectTransform> transforms = initialTransforms;
+		std::vector<TransformHierarchy> hierarchies(objectCount);
+		std::vector<uint32_t> cullIndices(objectCount);
+		std::vector<bool> isWvpDirty(objectCount, false);
+		FrustumCuller culler;
+		for (uint32_t i = 0; i < objectCount; ++i)
+		{
+			TransformHierarchy& hierarchy = hierarchies[i];
+			hierarchy.AddNode(TransformHierarchy::kNoParent, MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate));
+			hierarchy.AddNode(0, modelData.rootNode.localMatrix);
+			for (const Node& child : modelData.rootNode.children)
+			{
+				hierarchy.AddNode(static_cast<int32_t>(kModelRootNodeIndex), child.localMatrix);
+			}
+			cullIndices[i] = culler.Register();
+		}
+
+		measure("hierarchy", [&]()
+			{
+				for (uint32_t i = 0; i < objectCount; ++i)
+				{
+					TransformHierarchy& hierarchy = hierarchies[i];
+					if (i < movingCount)
+					{
+						transforms[i].rotate.y += kRotateSpeed;
+						hierarchy.SetLocalMatrix(0, MakeAffineMatrix(transforms[i].scale, transforms[i].rotate, transforms[i].translate));
+					}
+					if (hierarchy.Propagate() and hierarchy.IsChanged(kModelRootNodeIndex))
+					{
+						worldMatrices[i] = hierarchy.GetWorldMatrix(kModelRootNodeIndex);
+						isWvpDirty[i] = true;
+					}
+					if (!isWvpDirty[i])
+					{
+						continue;
+					}
+					isWvpDirty[i] = false;
+
+					wvpMatrices[i] = worldMatrices[i] * viewProjectionMatrix;
+					Vector3 center;
+					Vector3 extent;
+					FrustumCuller::TransformBounds(kBoundsMin, kBoundsMax, worldMatrices[i], center, extent);
+					culler.SetBounds(cullIndices[i], center, extent);
+				}
+				culler.Cull(viewProjectionMatrix);
+			});
+	}
+
+	nlohmann::json json;
+	json["objectCount"] = objectCount;
+	json["vertexCount"] = setting.vertexCount;
+	json["nodeCount"] = setting.nodeCount;
+	json["movingPercent"] = setting.movingPercent;
+	json["warmupFrames"] = setting.warmupFrames;
+	json["frames"] = setting.frames;
+	json["results"] = std::move(results);
+
+	std::ofstream file(outputFilePath);
+	if (file.fail())
+	{
+		return false;
+	}
+	file << json.dump(1, '\t');
+	return true;
+}
+
+Object3dBenchmark::ModelData Object3dBenchmark::MakeModelData(const Setting& setting)
+{
+	// 読み込んだobjと同じく、頂点を面の順に並べてインデックスは頂点の番号そのまま
+	ModelData modelData;
+	modelData.vertices.resize(setting.vertexCount);
+	modelData.indices.resize(setting.vertexCount);
+	for (uint32_t i = 0; i < setting.vertexCount; ++i)
+	{
+		const float t = static_cast<float>(i) / static_cast<float>((std::max)(setting.vertexCount, 1u));
+		modelData.vertices[i] = { { t * 2.0f - 1.0f,0.0f,0.0f,1.0f }, { t,0.0f }, { 0.0f,1.0f,0.0f } };
+		modelData.indices[i] = i;
+	}
+
+	modelData.rootNode.localMatrix = MakeIdentity4x4();
+	modelData.rootNode.name = "root";
+	modelData.rootNode.children.resize(setting.nodeCount);
+	for (uint32_t i = 0; i < setting.nodeCount; ++i)
+	{
+		Node& child = modelData.rootNode.children[i];
+		child.localMatrix = MakeAffineMatrix({ 1.0f,1.0f,1.0f }, { 0.0f,0.0f,0.0f }, { 0.0f,static_cast<float>(i),0.0f });
+		child.name = "node" + std::to_string(i);
+	}
+	return modelData;
+}
+
+Matrix4x4 Object3dBenchmark::MakeViewProjectionMatrix()
+{
+	const Matrix4x4 viewMatrix = Inverse(MakeAffineMatrix({ 1.0f,1.0f,1.0f }, { 0.15f,0.0f,0.0f }, kCameraPosition_));
+	return viewMatrix * MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MyMath.h"
+
+/// <summary>
+/// 3Dオブジェクトの更新の計測
+/// Object3d::Updateの行列計算を、ModelDataを毎回コピーしていた頃のもの・ルート行列を参照するもの・
+/// 今の階層とカリングを使うものの3通りで同じオブジェクト数だけ回し、結果をJSONに書き出す
+/// 行列計算と視錐台カリングだけを使うので描画デバイスが無くても動く
+/// </summary>
+class Object3dBenchmark
+{
+public:
+
+	// 計測設定
+	struct Setting
+	{
+		// オブジェクト数
+		uint32_t objectCount = 500;
+		// 1モデルの頂点数(ModelDataのコピーの量)
+		uint32_t vertexCount = 4096;
+		// モデルのルート以外のノード数
+		uint32_t nodeCount = 8;
+		// 毎フレーム動かすオブジェクトの割合(%)
+		uint32_t movingPercent = 100;
+		// 計測前に回すフレーム数
+		uint32_t warmupFrames = 30;
+		// 計測するフレーム数
+		uint32_t frames = 240;
+	};
+
+	/// <summary>
+	/// 計測を実行してJSONに書き出す
+	/// </summary>
+	/// <param name="setting">計測設定</param>
+	/// <param name="outputFilePath">出力先</param>
+	/// <returns>書き出せたか</returns>
+	static bool Run(const Setting& setting, const std::string& outputFilePath);
+
+private:
+
+	// Model::ModelDataと同じ並び(Model.hはDirectX12に依存するので、コピーの量が同じになるように写している)
+	struct VertexData
+	{
+		Vector4 position;
+		Vector2 texcoord;
+		Vector3 normal;
+	};
+	struct Node
+	{
+		Matrix4x4 localMatrix;
+		std::string name;
+		std::vector<Node> children;
+	};
+	struct ModelData
+	{
+		std::vector<VertexData> vertices;
+		std::vector<uint32_t> indices;
+		Node rootNode;
+	};
+
+	/// <summary>
+	/// 計測に使うモデルを作る
+	/// </summary>
+	/// <param name="setting">計測設定</param>
+	/// <returns>モデルデータ</returns>
+	static ModelData MakeModelData(const Setting& setting);
+
+	// 固定カメラ(ParticleBenchmarkと同じく原点を少し引いた位置から見る)
+	static const Vector3 kCameraPosition_;
+	static Matrix4x4 MakeViewProjectionMatrix();
+};
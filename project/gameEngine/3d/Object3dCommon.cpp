@@ -1,4 +1,9 @@
 #include "Object3dCommon.h"
+#include "Object3d.h"
+
+#include <cstring>
+#include <cmath>
+#include <numbers>
 
 Object3dCommon* Object3dCommon::GetInstance()
 {
@@ -18,6 +23,8 @@ void Object3dCommon::Initialize(DirectXCommon* dxCommon)
 	
 
 	CreateGraphicsPipeline();
+
+	InitializeSceneLights();
 }
 
 void Object3dCommon::CreateRootSignature()
@@ -82,6 +89,17 @@ void Object3dCommon::CreateRootSignature()
 	rootParameters_[8].DescriptorTable.pDescriptorRanges = &descriptorRange_[1]; 				//Tableの中身の配列を指定
 	rootParameters_[8].DescriptorTable.NumDescriptorRanges = 1;		//Tableで利用する数
 
+	// 圧縮頂点を戻すための範囲(圧縮形式のモデルだけが設定する)
+	rootParameters_[9].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootParameters_[9].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters_[9].Descriptor.ShaderRegister = 1;
+
+	// インスタンスごとの座標変換行列(インスタンス描画のときだけ設定する)
+	rootParameters_[10].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	rootParameters_[10].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	rootParameters_[10].Descriptor.ShaderRegister = 0;
+	rootParameters_[10].Descriptor.RegisterSpace = 1;
+
 	descriptionRootSignature_.pParameters = rootParameters_;					//ルートパラメータ配列へのポインタ
 	descriptionRootSignature_.NumParameters = _countof(rootParameters_);		//配列の長さ
 
@@ -132,6 +150,25 @@ void Object3dCommon::CreateRootSignature()
 	inputLayoutDesc_.pInputElementDescs = inputElementDescs_;
 	inputLayoutDesc_.NumElements = _countof(inputElementDescs_);
 
+	// 圧縮頂点のInputLayout(位置とUVは範囲内の16bit、法線は八面体で2成分に詰めた16bit)
+	compactInputElementDescs_[0].SemanticName = "POSITION";
+	compactInputElementDescs_[0].SemanticIndex = 0;
+	compactInputElementDescs_[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+	compactInputElementDescs_[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	compactInputElementDescs_[1].SemanticName = "TEXCOORD";
+	compactInputElementDescs_[1].SemanticIndex = 0;
+	compactInputElementDescs_[1].Format = DXGI_FORMAT_R16G16_UNORM;
+	compactInputElementDescs_[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	compactInputElementDescs_[2].SemanticName = "NORMAL";
+	compactInputElementDescs_[2].SemanticIndex = 0;
+	compactInputElementDescs_[2].Format = DXGI_FORMAT_R16G16_SNORM;
+	compactInputElementDescs_[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	compactInputLayoutDesc_.pInputElementDescs = compactInputElementDescs_;
+	compactInputLayoutDesc_.NumElements = _countof(compactInputElementDescs_);
+
 	// BlendStateの設定
 	// 全ての色要素を書き込む
 	blendDesc_.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
@@ -154,6 +191,12 @@ void Object3dCommon::CreateRootSignature()
 	// Shaderをコンパイル 
 	vertexShaderBlob_ = dxCommon_->CompileShader(L"resources/shaders/Object3d.VS.hlsl", L"vs_6_0");
 	assert(vertexShaderBlob_ != nullptr);
+	compactVertexShaderBlob_ = dxCommon_->CompileShader(L"resources/shaders/Object3dCompact.VS.hlsl", L"vs_6_0");
+	assert(compactVertexShaderBlob_ != nullptr);
+	instancedVertexShaderBlob_ = dxCommon_->CompileShader(L"resources/shaders/Object3dInstanced.VS.hlsl", L"vs_6_0");
+	assert(instancedVertexShaderBlob_ != nullptr);
+	compactInstancedVertexShaderBlob_ = dxCommon_->CompileShader(L"resources/shaders/Object3dCompactInstanced.VS.hlsl", L"vs_6_0");
+	assert(compactInstancedVertexShaderBlob_ != nullptr);
 	pixelShaderBlob_ = dxCommon_->CompileShader(L"resources/shaders/Object3d.PS.hlsl", L"ps_6_0");
 	assert(pixelShaderBlob_ != nullptr);
 
@@ -198,16 +241,207 @@ void Object3dCommon::CreateGraphicsPipeline()
 	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&graphicsPipelineState_));
 	assert(SUCCEEDED(result));
 
+	// 圧縮頂点用は入力と頂点シェーダーだけを差し替える
+	graphicsPipelineStateDesc.InputLayout = compactInputLayoutDesc_;
+	graphicsPipelineStateDesc.VS = { compactVertexShaderBlob_->GetBufferPointer(),compactVertexShaderBlob_->GetBufferSize() };
+	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&compactPipelineState_));
+	assert(SUCCEEDED(result));
+
+	// インスタンス描画用も頂点シェーダーだけを差し替える
+	graphicsPipelineStateDesc.VS = { compactInstancedVertexShaderBlob_->GetBufferPointer(),compactInstancedVertexShaderBlob_->GetBufferSize() };
+	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&compactInstancedPipelineState_));
+	assert(SUCCEEDED(result));
+
+	graphicsPipelineStateDesc.InputLayout = inputLayoutDesc_;
+	graphicsPipelineStateDesc.VS = { instancedVertexShaderBlob_->GetBufferPointer(),instancedVertexShaderBlob_->GetBufferSize() };
+	result = device_->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&instancedPipelineState_));
+	assert(SUCCEEDED(result));
+
 	// カリングしない（裏面も表示させる）
 	rasterizerDesc_.CullMode = D3D12_CULL_MODE_NONE;
 }
 
 void Object3dCommon::CommonDrawSetting()
+{
+	// ライトとカメラは全オブジェクトで共通なのでここで1回だけ書き込む
+	isSceneConstantsWritten_ = WriteSceneConstants();
+	if (isSceneConstantsWritten_)
+	{
+		// パイプラインの設定は不透明の層で一番小さいキーにして、3Dオブジェクトの描画より先に実行させる
+		dxCommon_->GetRenderQueue().Submit(RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0, 0, 0, 0), [this]()
+			{
+				BindPipeline();
+			});
+	}
+
+	// このフレームで描くものを決める(見えないものはObject3d::Drawで飛ばす)
+	if (defaultCamera_)
+	{
+		frustumCuller_.Cull(defaultCamera_->GetViewProjectionMatrix());
+	}
+}
+
+void Object3dCommon::BindPipeline()
 {
 	//RootSignatureを設定。PSOに設定しているけど別途設定が必要
 	commandList_->SetGraphicsRootSignature(rootSignature_.Get());
 	commandList_->SetPipelineState(graphicsPipelineState_.Get());
+	currentVertexFormat_ = Model::VertexFormat::Full;
+	currentIsInstanced_ = false;
 
 	//形状を設定。PSOに設定しているものとはまた別。同じものを設定すると考えておけばよい
 	commandList_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-}
\ No newline at end of file
+
+	// 平行光源・カメラ・ポイントライト・スポットライトのCBufferの場所を設定
+	commandList_->SetGraphicsRootConstantBufferView(3, sceneConstantsAddress_);
+	commandList_->SetGraphicsRootConstantBufferView(4, sceneConstantsAddress_ + kSceneConstantStride_);
+	commandList_->SetGraphicsRootConstantBufferView(5, sceneConstantsAddress_ + kSceneConstantStride_ * 2);
+	commandList_->SetGraphicsRootConstantBufferView(6, sceneConstantsAddress_ + kSceneConstantStride_ * 3);
+}
+
+void Object3dCommon::SetVertexFormat(Model::VertexFormat vertexFormat, bool isInstanced)
+{
+	if (currentVertexFormat_ == vertexFormat && currentIsInstanced_ == isInstanced)
+	{
+		return;
+	}
+
+	ID3D12PipelineState* pipelineState = nullptr;
+	if (vertexFormat == Model::VertexFormat::Compact)
+	{
+		pipelineState = isInstanced ? compactInstancedPipelineState_.Get() : compactPipelineState_.Get();
+	}
+	else
+	{
+		pipelineState = isInstanced ? instancedPipelineState_.Get() : graphicsPipelineState_.Get();
+	}
+	commandList_->SetPipelineState(pipelineState);
+	currentVertexFormat_ = vertexFormat;
+	currentIsInstanced_ = isInstanced;
+}
+
+void Object3dCommon::SubmitDraw(const Model* model, uint32_t lodIndex, bool isInstanced, bool isTransparent, const Vector3& worldPosition, std::function<void(uint32_t)> draw)
+{
+	// シーン共通の定数を書き込めなかったフレームは何も描かない
+	if (!isSceneConstantsWritten_)
+	{
+		return;
+	}
+
+	// パイプラインは頂点形式とインスタンス描画かどうかで決まる
+	const uint32_t pipeline = static_cast<uint32_t>(model->GetVertexFormat()) * 2 + (isInstanced ? 1 : 0);
+
+	// マテリアルのCBufferはモデルごとに持っているので、モデルが作ったときに振られた番号を使う
+	const uint32_t material = model->GetMaterialId();
+
+	// 不透明なものは手前から描いて、奥のピクセルを深度テストで落とす
+	// 半透明なものは奥の色に混ぜるので、不透明なものの後に奥から描く
+	const RenderQueue::Layer layer = isTransparent ? RenderQueue::Layer::Transparent : RenderQueue::Layer::Opaque;
+	uint32_t depth = 0;
+	if (defaultCamera_)
+	{
+		const Matrix4x4& cameraWorld = defaultCamera_->GetWorldMatrix();
+		const Vector3 offset = { worldPosition.x - cameraWorld.m[3][0], worldPosition.y - cameraWorld.m[3][1], worldPosition.z - cameraWorld.m[3][2] };
+		const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+		depth = RenderQueue::QuantizeDepth(distance, defaultCamera_->GetFarClip(), isTransparent);
+	}
+
+	// テクスチャはサブメッシュごとに違うので、サブメッシュごとに積む
+	uint32_t subMeshStart = 0;
+	uint32_t subMeshCount = 0;
+	model->GetSubMeshRange(lodIndex, subMeshStart, subMeshCount);
+	for (uint32_t subMeshIndex = subMeshStart; subMeshIndex < subMeshStart + subMeshCount; ++subMeshIndex)
+	{
+		const uint32_t texture = model->GetSubMeshTextureIndex(subMeshIndex);
+		dxCommon_->GetRenderQueue().Submit(RenderQueue::MakeKey(layer, pipeline, material, texture, depth), [draw, subMeshIndex]()
+			{
+				draw(subMeshIndex);
+			});
+	}
+}
+
+void Object3dCommon::AddInstance(Model* model, uint32_t lodIndex, const Object3d* object, const InstanceBatcher::InstanceData& instance)
+{
+	instanceBatcher_.Add(model, lodIndex, object, instance);
+}
+
+void Object3dCommon::FlushDraws()
+{
+	// インスタンス描画のグループも1つの描画として列に積む
+	if (instanceBatcher_.GetInstanceCount() != 0)
+	{
+		instanceBatcher_.Build();
+		const std::vector<InstanceBatcher::InstanceData>& instances = instanceBatcher_.GetInstances();
+		for (const InstanceBatcher::Group& group : instanceBatcher_.GetGroups())
+		{
+			// このグループの座標変換行列をフレームごとのアップロード領域に書き込んでおく
+			const size_t instanceSize = sizeof(InstanceBatcher::InstanceData) * group.instanceCount;
+			DirectXCommon::UploadAllocation allocation = dxCommon_->AllocateUpload(instanceSize);
+			if (!allocation.cpuAddress)
+			{
+				// 書き込み先が無いので、このグループはこのフレームは描かない
+				continue;
+			}
+			std::memcpy(allocation.cpuAddress, instances.data() + group.instanceStart, instanceSize);
+
+			// グループは広がっているので、距離は最初のオブジェクトで測る
+			SubmitDraw(group.model, group.lodIndex, true, false, group.firstObject->GetPosition(), [this, group, address = allocation.gpuAddress](uint32_t subMeshIndex)
+				{
+					SetVertexFormat(group.model->GetVertexFormat(), true);
+					commandList_->SetGraphicsRootShaderResourceView(10, address);
+
+					// 環境マップはグループの最初のオブジェクトのものを使う
+					group.firstObject->BindEnvironmentMap();
+					group.model->DrawSubMesh(subMeshIndex, group.instanceCount);
+				});
+		}
+		instanceBatcher_.Clear();
+	}
+}
+
+void Object3dCommon::InitializeSceneLights()
+{
+	//デフォルト値は以下のようにしておく
+	directionalLight_.color = { 1.0f,1.0f,1.0f,1.0f };
+	directionalLight_.direction = Normalize({ 0.0f,-1.0f,0.0f });
+	directionalLight_.intensity = 1.0f;
+
+	pointLight_.color = { 1.0f,1.0f,1.0f,1.0f };
+	pointLight_.position = { 0.0f,0.0f,0.0f };
+	pointLight_.intensity = 1.0f;
+	pointLight_.radius = 10.0f;
+	pointLight_.decay = 1.0f;
+
+	spotLight_.color = { 1.0f,1.0f,1.0f,1.0f };
+	spotLight_.position = { 2.0f,1.25f,0.0f };
+	spotLight_.intensity = 4.0f;
+	spotLight_.direction = Normalize({ 0.0f,-1.0f,0.0f });
+	spotLight_.distance = 7.0f;
+	spotLight_.decay = 2.0f;
+	spotLight_.consAngle = std::cos(std::numbers::pi_v<float> / 3.0f);
+	spotLight_.cosFalloffStart = 1.0f;
+}
+
+bool Object3dCommon::WriteSceneConstants()
+{
+	CameraForGPU camera{};
+	if (defaultCamera_)
+	{
+		camera.worldPosition = defaultCamera_->GetPosition();
+	}
+
+	DirectXCommon::UploadAllocation allocation = dxCommon_->AllocateUpload(kSceneConstantStride_ * 4);
+	if (!allocation.cpuAddress)
+	{
+		return false;
+	}
+	uint8_t* slot = static_cast<uint8_t*>(allocation.cpuAddress);
+	std::memcpy(slot, &directionalLight_, sizeof(DirectionalLight));
+	std::memcpy(slot + kSceneConstantStride_, &camera, sizeof(CameraForGPU));
+	std::memcpy(slot + kSceneConstantStride_ * 2, &pointLight_, sizeof(PointLight));
+	std::memcpy(slot + kSceneConstantStride_ * 3, &spotLight_, sizeof(SpotLight));
+
+	// 設定は並べ替えた後のBindPipelineで行う
+	sceneConstantsAddress_ = allocation.gpuAddress;
+	return true;
+}
@@ -6,6 +6,12 @@
 #include "DirectXCommon.h"
 #include "Logger.h"
 #include "CameraManager.h"
+#include "Model.h"
+#include "InstanceBatcher.h"
+#include "FrustumCuller.h"
+#include "RenderQueue.h"
+
+#include <functional>
 
 /// <summary>
 /// 3Dオブジェクト共通機能
@@ -29,6 +35,41 @@ public:
 
 #pragma endregion シングルトンインスタンス
 
+public: // シーン共通の定数(Object3d.PS.hlslと同じ並び)
+
+	struct DirectionalLight
+	{
+		Vector4 color;
+		Vector3 direction;
+		float intensity;
+	};
+
+	struct CameraForGPU
+	{
+		Vector3 worldPosition;
+	};
+
+	struct PointLight
+	{
+		Vector4 color;
+		Vector3 position;
+		float intensity;
+		float radius;
+		float decay;
+	};
+
+	struct SpotLight
+	{
+		Vector4 color;
+		Vector3 position;
+		float intensity;
+		Vector3 direction;
+		float distance;
+		float decay;
+		float consAngle;
+		float cosFalloffStart;
+	};
+
 public:
 
 	/// <summary>
@@ -39,9 +80,49 @@ public:
 
 	/// <summary>
 	/// 描画共通設定
+	/// ライトとカメラの定数はここで1回だけ書き込み、パイプラインの設定を並べ替えの列に積んで、デフォルトカメラで視錐台カリングを行う
 	/// </summary>
 	void CommonDrawSetting();
 
+	/// <summary>
+	/// ルートシグネイチャ・パイプライン・シーン共通の定数を設定する(並べ替えた列の中から呼ぶ)
+	/// </summary>
+	void BindPipeline();
+
+	/// <summary>
+	/// 描画するモデルの頂点形式に合わせてパイプラインを切り替える(形式が変わったときだけ積む)
+	/// </summary>
+	/// <param name="vertexFormat">頂点の形式</param>
+	/// <param name="isInstanced">インスタンス描画用のパイプラインにするか</param>
+	void SetVertexFormat(Model::VertexFormat vertexFormat, bool isInstanced = false);
+
+	/// <summary>
+	/// 描画をサブメッシュごとに並べ替えの列に積む
+	/// 不透明なものはパイプライン・マテリアル・テクスチャ・手前からの順、半透明なものはその後に奥からの順に実行される
+	/// </summary>
+	/// <param name="model">描画するモデル</param>
+	/// <param name="lodIndex">詳細度の段</param>
+	/// <param name="isInstanced">インスタンス描画用のパイプラインを使うか</param>
+	/// <param name="isTransparent">半透明として描くか</param>
+	/// <param name="worldPosition">カメラからの距離を測る位置</param>
+	/// <param name="draw">サブメッシュの番号を受け取ってコマンドを積む処理(MyGame::Drawで列を実行するまで呼ばれないので、使うものは値で持たせる)</param>
+	void SubmitDraw(const Model* model, uint32_t lodIndex, bool isInstanced, bool isTransparent, const Vector3& worldPosition, std::function<void(uint32_t)> draw);
+
+	/// <summary>
+	/// インスタンス描画に積む(FlushDrawsでモデルごとにまとめて描画する)
+	/// </summary>
+	/// <param name="model">モデル</param>
+	/// <param name="lodIndex">詳細度の段</param>
+	/// <param name="object">積むオブジェクト(グループの最初のもののライト等を使う)</param>
+	/// <param name="instance">座標変換行列</param>
+	void AddInstance(Model* model, uint32_t lodIndex, const Object3d* object, const InstanceBatcher::InstanceData& instance);
+
+	/// <summary>
+	/// 積んだインスタンスをモデルと詳細度の段ごとにまとめ、並べ替えの列に積む
+	/// シーンの3Dオブジェクトを積み終えたら1回呼ぶ(列はMyGame::Drawで他の描画と一緒に実行する)
+	/// </summary>
+	void FlushDraws();
+
 public: // セッター
 
 	/// <summary>
@@ -50,6 +131,24 @@ public: // セッター
 	/// <param name="camera">カメラ</param>
 	void SetDefaultCamera(std::shared_ptr<Camera> camera) { defaultCamera_ = camera; }
 
+	/// <summary>
+	/// 平行光源設定
+	/// </summary>
+	/// <param name="directionalLight">平行光源データ</param>
+	void SetDirectionalLight(const DirectionalLight& directionalLight) { directionalLight_ = directionalLight; }
+
+	/// <summary>
+	/// ポイントライト設定
+	/// </summary>
+	/// <param name="pointLight">ポイントライトデータ</param>
+	void SetPointLight(const PointLight& pointLight) { pointLight_ = pointLight; }
+
+	/// <summary>
+	/// スポットライト設定
+	/// </summary>
+	/// <param name="spotLight">スポットライトデータ</param>
+	void SetSpotLight(const SpotLight& spotLight) { spotLight_ = spotLight; }
+
 public: // ゲッター
 
 	/// <summary>
@@ -64,6 +163,30 @@ public: // ゲッター
 	/// <returns>カメラ</returns>
 	std::shared_ptr<Camera> GetDefaultCamera() const { return defaultCamera_; }
 
+	/// <summary>
+	/// 平行光源の取得
+	/// </summary>
+	/// <returns>平行光源データ</returns>
+	const DirectionalLight& GetDirectionalLight() const { return directionalLight_; }
+
+	/// <summary>
+	/// ポイントライトの取得
+	/// </summary>
+	/// <returns>ポイントライトデータ</returns>
+	const PointLight& GetPointLight() const { return pointLight_; }
+
+	/// <summary>
+	/// スポットライトの取得
+	/// </summary>
+	/// <returns>スポットライトデータ</returns>
+	const SpotLight& GetSpotLight() const { return spotLight_; }
+
+	/// <summary>
+	/// 視錐台カリングの取得
+	/// </summary>
+	/// <returns>視錐台カリング</returns>
+	FrustumCuller& GetFrustumCuller() { return frustumCuller_; }
+
 private:
 
 	/// <summary>
@@ -76,11 +199,27 @@ private:
 	/// </summary>
 	void CreateGraphicsPipeline();
 
+	/// <summary>
+	/// シーン共通の光源の初期値設定
+	/// </summary>
+	void InitializeSceneLights();
+
+	/// <summary>
+	/// シーン共通の定数をフレームごとのアップロード領域に書き込む
+	/// </summary>
+	/// <returns>書き込めたか(アップロード領域が埋まっているときはfalse)</returns>
+	bool WriteSceneConstants();
+
 private:
 
 	DirectXCommon* dxCommon_;
 
 	std::shared_ptr<Camera> defaultCamera_ = nullptr;
+
+	// シーン共通の光源(CommonDrawSettingで書き込む)
+	DirectionalLight directionalLight_{};
+	PointLight pointLight_{};
+	SpotLight spotLight_{};
 	
 	// デバイス
 	Microsoft::WRL::ComPtr<ID3D12Device> device_ = nullptr;
@@ -93,6 +232,8 @@ private:
 	D3D12_DEPTH_STENCIL_DESC depthStencilDesc_{};
 	//InputLayout
 	D3D12_INPUT_LAYOUT_DESC inputLayoutDesc_{};
+	//圧縮頂点用のInputLayout
+	D3D12_INPUT_LAYOUT_DESC compactInputLayoutDesc_{};
 	//BlendStateの設定
 	D3D12_BLEND_DESC blendDesc_{};
 	//RasterizerStateの設定
@@ -100,6 +241,9 @@ private:
 
 	//shaderをコンパイルする
 	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob_ = nullptr;
+	Microsoft::WRL::ComPtr<IDxcBlob> compactVertexShaderBlob_ = nullptr;
+	Microsoft::WRL::ComPtr<IDxcBlob> instancedVertexShaderBlob_ = nullptr;
+	Microsoft::WRL::ComPtr<IDxcBlob> compactInstancedVertexShaderBlob_ = nullptr;
 	Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob_ = nullptr;
 	
 
@@ -108,11 +252,35 @@ private:
 
 	//PSOを生成する
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState_ = nullptr;
+	//圧縮頂点用のPSO
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> compactPipelineState_ = nullptr;
+	//インスタンス描画用のPSO
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> instancedPipelineState_ = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> compactInstancedPipelineState_ = nullptr;
+
+	// 今積んでいるPSOの頂点形式
+	Model::VertexFormat currentVertexFormat_ = Model::VertexFormat::Full;
+	// 今積んでいるPSOがインスタンス描画用か
+	bool currentIsInstanced_ = false;
+	// このフレームのシーン共通の定数を書き込めたか(できなければ何も積まない)
+	bool isSceneConstantsWritten_ = false;
+	// このフレームのシーン共通の定数の場所
+	D3D12_GPU_VIRTUAL_ADDRESS sceneConstantsAddress_ = 0;
+
+	// インスタンス描画に積まれたもの
+	InstanceBatcher instanceBatcher_;
+
+	// 視錐台カリング(各Object3dがUpdateで範囲を書き込み、CommonDrawSettingでまとめて判定する)
+	FrustumCuller frustumCuller_;
+
+	// シーン共通の定数の並び(平行光源・カメラ・ポイントライト・スポットライトをCBVの256byte境界ごとに置く)
+	static const uint32_t kSceneConstantStride_ = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
 
 
 	D3D12_ROOT_SIGNATURE_DESC descriptionRootSignature_{};
-	D3D12_ROOT_PARAMETER rootParameters_[9] = {};
+	D3D12_ROOT_PARAMETER rootParameters_[11] = {};
 	D3D12_STATIC_SAMPLER_DESC staticSamplers_[1] = {};
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs_[3] = {};
+	D3D12_INPUT_ELEMENT_DESC compactInputElementDescs_[3] = {};
 };
 
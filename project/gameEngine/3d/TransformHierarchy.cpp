@@ -0,0 +1,72 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cassert>
+
+uint32_t TransformHierarchy::AddNode(int32_t parentIndex, const Matrix4x4& localMatrix)
+{
+	const uint32_t index = GetNodeCount();
+	// 親が前にいなければ1回の走査で伝播できない
+	assert(parentIndex == kNoParent || (parentIndex >= 0 && static_cast<uint32_t>(parentIndex) < index));
+
+	parents_.push_back(parentIndex);
+	localMatrices_.push_back(localMatrix);
+	worldMatrices_.push_back(localMatrix);
+	isDirty_.push_back(1);
+	isChanged_.push_back(0);
+	hasDirty_ = true;
+	return index;
+}
+
+void TransformHierarchy::SetLocalMatrix(uint32_t index, const Matrix4x4& localMatrix)
+{
+	localMatrices_[index] = localMatrix;
+	isDirty_[index] = 1;
+	hasDirty_ = true;
+}
+
+bool TransformHierarchy::Propagate()
+{
+	if (!hasDirty_)
+	{
+		// 前回作り直した印だけ消しておく
+		if (hasChanged_)
+		{
+			std::fill(isChanged_.begin(), isChanged_.end(), uint8_t(0));
+			hasChanged_ = false;
+		}
+		return false;
+	}
+
+	// 親は必ず前にいるので、親の結果はもう決まっている
+	const uint32_t count = GetNodeCount();
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		const int32_t parent = parents_[i];
+		const bool isChanged = isDirty_[i] || (parent != kNoParent && isChanged_[parent]);
+		isChanged_[i] = isChanged ? 1 : 0;
+		isDirty_[i] = 0;
+		if (!isChanged)
+		{
+			continue;
+		}
+
+		// 行ベクトルに掛けるので、自分のローカル行列の後に親のワールド行列を掛ける
+		worldMatrices_[i] = parent == kNoParent ? localMatrices_[i] : localMatrices_[i] * worldMatrices_[parent];
+	}
+
+	hasDirty_ = false;
+	hasChanged_ = true;
+	return true;
+}
+
+void TransformHierarchy::Clear()
+{
+	parents_.clear();
+	localMatrices_.clear();
+	worldMatrices_.clear();
+	isDirty_.clear();
+	isChanged_.clear();
+	hasDirty_ = false;
+	hasChanged_ = false;
+}
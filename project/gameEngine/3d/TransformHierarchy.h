@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Matrix4x4.h"
+
+/// <summary>
+/// 親子関係のある座標変換を平らな配列で持つ
+/// 親は必ず子より前に並べるので、前から1回なめるだけで親のワールド行列が先に決まる
+/// ローカル行列が変わったノードとその子孫だけワールド行列を作り直す
+/// デバイスを使わないので、伝播の結果だけを取り出して確かめられる
+/// </summary>
+class TransformHierarchy
+{
+public:
+
+	// 親がいないときの番号
+	static const int32_t kNoParent = -1;
+
+public:
+
+	/// <summary>
+	/// ノードを足す(親は先に足しておくこと)
+	/// </summary>
+	/// <param name="parentIndex">親の番号(いなければkNoParent)</param>
+	/// <param name="localMatrix">親から見た行列</param>
+	/// <returns>足したノードの番号</returns>
+	uint32_t AddNode(int32_t parentIndex, const Matrix4x4& localMatrix);
+
+	/// <summary>
+	/// ローカル行列を設定する(次のPropagateで子孫まで反映する)
+	/// </summary>
+	/// <param name="index">ノードの番号</param>
+	/// <param name="localMatrix">親から見た行列</param>
+	void SetLocalMatrix(uint32_t index, const Matrix4x4& localMatrix);
+
+	/// <summary>
+	/// ローカル行列が変わったノードとその子孫のワールド行列を作り直す
+	/// </summary>
+	/// <returns>作り直したノードがあったか</returns>
+	bool Propagate();
+
+	/// <summary>
+	/// すべてのノードを捨てる
+	/// </summary>
+	void Clear();
+
+public: // ゲッター
+
+	// ノードの数
+	uint32_t GetNodeCount() const { return static_cast<uint32_t>(parents_.size()); }
+
+	// 親の番号
+	int32_t GetParent(uint32_t index) const { return parents_[index]; }
+
+	// 親から見た行列
+	const Matrix4x4& GetLocalMatrix(uint32_t index) const { return localMatrices_[index]; }
+
+	// ワールド行列(Propagateの後で有効)
+	const Matrix4x4& GetWorldMatrix(uint32_t index) const { return worldMatrices_[index]; }
+
+	// 最後のPropagateでワールド行列が作り直されたか
+	bool IsChanged(uint32_t index) const { return isChanged_[index] != 0; }
+
+private:
+
+	// 親の番号、ローカル行列、ワールド行列をそれぞれ別の配列に並べる
+	std::vector<int32_t> parents_;
+	std::vector<Matrix4x4> localMatrices_;
+	std::vector<Matrix4x4> worldMatrices_;
+	// ローカル行列が変わったか
+	std::vector<uint8_t> isDirty_;
+	// 最後のPropagateで作り直したか
+	std::vector<uint8_t> isChanged_;
+
+	// 変わったノードが1つでもあるか
+	bool hasDirty_ = false;
+	// isChanged_に立っているものがあるか
+	bool hasChanged_ = false;
+};
@@ -106,6 +106,10 @@ public: // ゲッター
     const bool IsRegisteredCollidingPtr(const Collider* _ptr) const;
 	// あたっているコライダーリストから指定されたポインタを削除
     void EraseCollidingPtr(const Collider* _ptr);
+	// あたっているコライダーがあるか
+    inline bool HasCollidingPtr() const { return !collidingPtrList_.empty(); }
+	// あたっているコライダーリストを空にする
+    void ClearCollidingPtr() { collidingPtrList_.clear(); }
 
 
 public: // セッター
@@ -18,11 +18,32 @@ void ColliderManager::CheckAllCollision()
     countWithoutFilter_ = 0ui32;
     countWithoutLighter = 0ui32;
 
-    auto itrA = colliders_.begin();
-    for (; itrA != colliders_.end(); ++itrA)
+    // 判定を切っているコライダーは総当たりの前に外す
+    enabledColliders_.clear();
+    for (Collider* collider : colliders_)
+    {
+        if (collider->GetEnable())
+        {
+            enabledColliders_.push_back(collider);
+            continue;
+        }
+
+        // 切られたばかりのものだけ、当たっていた相手の記録から1度で外す
+        if (collider->HasCollidingPtr())
+        {
+            for (Collider* other : colliders_)
+            {
+                other->EraseCollidingPtr(collider);
+            }
+            collider->ClearCollidingPtr();
+        }
+    }
+
+    auto itrA = enabledColliders_.begin();
+    for (; itrA != enabledColliders_.end(); ++itrA)
     {
         auto itrB = itrA + 1;
-        for (; itrB != colliders_.end(); ++itrB)
+        for (; itrB != enabledColliders_.end(); ++itrB)
         {
             CheckCollisionPair(*itrA, *itrB);
         }
@@ -78,12 +99,7 @@ void ColliderManager::CheckCollisionPair(Collider* _colA, Collider* _colB)
     // 衝突しているかどうか
     bool isCollide = true;
 
-    if (!_colA->GetEnable() || !_colB->GetEnable())
-    {
-        _colA->EraseCollidingPtr(_colB);
-        _colB->EraseCollidingPtr(_colA);
-        return;
-    }
+    // 判定を切っているものはCheckAllCollisionで外してある
     countWithoutFilter_++;
 
     // 衝突フィルタリング
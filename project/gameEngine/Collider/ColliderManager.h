@@ -189,6 +189,8 @@ private:
 private:
 
     std::vector<Collider*> colliders_;
+    // 判定が有効なコライダー(毎フレーム作り直すが、確保した領域は使い回す)
+    std::vector<Collider*> enabledColliders_;
     std::vector<std::pair<std::string, std::string>> collisionNames_;
     std::vector<std::pair<std::string, uint32_t>> attributeList_;
     std::list<std::pair<std::string, uint32_t>> maskList_;
@@ -56,6 +56,9 @@ void DirectXCommon::Initialize(WinApp* winApp)
 	// フェンス生成
 	CreateFence();
 
+	// フレームごとのアップロード領域の生成
+	CreateUploadRing();
+
 	// ビューポート矩形の初期化
 	InitializeViewPort();
 
@@ -556,6 +559,9 @@ void DirectXCommon::PostDraw()
 		WaitForSingleObject(fenceEvent_, INFINITE);
 	}
 
+	// 実行し終えたフレームのアップロード領域を返す
+	AdvanceUploadRing();
+
 	//次フレーム用のコマンドリストを準備
 	result = commandAllocator_->Reset();
 	assert(SUCCEEDED(result));
@@ -789,6 +795,32 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateDepthStencilTextureR
 	return resource;
 }
 
+DirectXCommon::UploadAllocation DirectXCommon::AllocateUpload(size_t sizeInBytes, size_t alignment)
+{
+	const uint64_t offset = uploadRing_.Allocate(sizeInBytes, alignment);
+	if (offset == LinearRingAllocator::kInvalidOffset)
+	{
+		// 1フレームで使う量がリングを超えている
+		Logger::Log(std::format("DirectXCommon : upload ring is full ({} bytes requested, {} of {} bytes in use)\n",
+			sizeInBytes, uploadRing_.GetUsedSize(), uploadRing_.GetCapacity()));
+		return { nullptr, 0 };
+	}
+	return { uploadRingData_ + offset, uploadRingResource_->GetGPUVirtualAddress() + offset };
+}
+
+void DirectXCommon::CreateUploadRing()
+{
+	uploadRingResource_ = CreateBufferResource(kUploadRingSize_);
+	uploadRingResource_->Map(0, nullptr, reinterpret_cast<void**>(&uploadRingData_));
+	uploadRing_.Initialize(kUploadRingSize_);
+}
+
+void DirectXCommon::AdvanceUploadRing()
+{
+	uploadRing_.FinishFrame(fenceValue_);
+	uploadRing_.Retire(fence_->GetCompletedValue());
+}
+
 void DirectXCommon::CommandPass()
 {
 	HRESULT result = S_FALSE;
@@ -820,6 +852,9 @@ void DirectXCommon::CommandPass()
 		WaitForSingleObject(fenceEvent_, INFINITE);
 	}
 
+	// 実行し終えたフレームのアップロード領域を返す
+	AdvanceUploadRing();
+
 	//次フレーム用のコマンドリストを準備
 	result = commandAllocator_->Reset();
 	assert(SUCCEEDED(result));
@@ -21,6 +21,8 @@
 #include "WinApp.h"
 #include "StringUtility.h"
 #include "Logger.h"
+#include "LinearRingAllocator.h"
+#include "RenderQueue.h"
 
 /// <summary>
 /// DirectX共通機能
@@ -32,6 +34,15 @@ public:
 	// 最大SRV数（最大テクスチャ枚数）
 	static const uint32_t kMaxSRVCount;
 
+	// フレームごとに使い捨てるアップロード領域の割り当て結果
+	struct UploadAllocation
+	{
+		// 書き込み先
+		void* cpuAddress;
+		// CBVやルートSRVに渡すアドレス
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress;
+	};
+
 	// 初期化
 	void Initialize(WinApp* winApp);
 
@@ -212,6 +223,15 @@ public:
 	/// <returns>アップロードバッファリソース</returns>
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateUploadBuffer(size_t sizeInBytes);
 
+	/// <summary>
+	/// 今記録しているコマンドだけで使うアップロード領域の割り当て
+	/// 毎フレーム書き換える定数用。GPUがこのフレームを実行し終えたら自動で再利用される
+	/// </summary>
+	/// <param name="sizeInBytes">サイズ(バイト単位)</param>
+	/// <param name="alignment">境界(既定はCBVの256byte)</param>
+	/// <returns>書き込み先とGPUアドレス(リングが埋まっているときは書き込み先がnullptr)</returns>
+	UploadAllocation AllocateUpload(size_t sizeInBytes, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
 public: // ゲッター
 
 	// デバイス
@@ -220,6 +240,12 @@ public: // ゲッター
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> GetCommandAllocator() { return commandAllocator_; }
 	// コマンドリスト
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> GetCommandList() { return commandList_; }
+	// 今記録しているコマンドの実行が終わったときにフェンスに入る値
+	uint64_t GetPendingFenceValue() const { return fenceValue_ + 1; }
+	// GPUが実行し終えたフェンスの値
+	uint64_t GetCompletedFenceValue() const { return fence_->GetCompletedValue(); }
+	// このフレームの描画の並べ替え(各描画共通クラスが積み、MyGame::Drawでまとめて実行する)
+	RenderQueue& GetRenderQueue() { return renderQueue_; }
 	// DescriptorHeap
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> GetSrvDescriptorHeap() { return srvDescriptorHeap_; }
 	// descriptorSizeSRV
@@ -256,6 +282,16 @@ public: // ゲッター
 
 private:
 
+	/// <summary>
+	/// フレームごとのアップロード領域の生成
+	/// </summary>
+	void CreateUploadRing();
+
+	/// <summary>
+	/// コマンドを送った後、フレームごとのアップロード領域を区切ってGPUが使い終えた分を返す
+	/// </summary>
+	void AdvanceUploadRing();
+
 	// FPS固定初期化
 	void InitializeFixFPS();
 
@@ -317,6 +353,16 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence_ = nullptr;
 	uint64_t fenceValue_ = 0;
 
+	// フレームごとのアップロード領域(永続的にMapしておく)
+	Microsoft::WRL::ComPtr<ID3D12Resource> uploadRingResource_ = nullptr;
+	uint8_t* uploadRingData_ = nullptr;
+	LinearRingAllocator uploadRing_;
+
+	// このフレームの描画の並べ替え
+	RenderQueue renderQueue_;
+	// フレームごとのアップロード領域の大きさ
+	static const uint64_t kUploadRingSize_ = 8 * 1024 * 1024;
+
 	// DXC
 	IDxcUtils* dxcUtils_ = nullptr;
 	IDxcCompiler3* dxcCompiler_ = nullptr;
@@ -1,5 +1,7 @@
 #include "Framework.h"
 
+#include "JobSystem.h"
+
 void Framework::Run()
 {
 	Initialize();
@@ -44,6 +46,9 @@ void Framework::Initialize()
 	winApp = std::make_unique<WinApp>();
 	winApp->Initialize();
 
+	// 読み込みの並列処理に使うワーカースレッド(終了まで使い回す)
+	JobSystem::Initialize();
+
 	// DirectXの初期化
 	dxCommon = std::make_unique<DirectXCommon>();
 	dxCommon->Initialize(winApp.get());
@@ -129,6 +134,10 @@ void Framework::Initialize()
 
 void Framework::Finalize()
 {
+	// シーンの終了(SRVやテクスチャの参照を手放すので、SrvManagerより先に行う)
+	sceneManager_->Finalize();
+	sceneFactory_.reset();
+
 	// WindowsAPIの終了処理
 	winApp->Finalize();
 	// WindowsAPI解放
@@ -141,9 +150,6 @@ void Framework::Finalize()
 	// SRVマネージャー解放
 	srvManager.reset();
 
-	sceneManager_->Finalize();
-	sceneFactory_.reset();
-
 	input->Finalize();
 
 	audio->Finalize();
@@ -153,6 +159,9 @@ void Framework::Finalize()
 
 	textureManager->Finalize();
 
+	// ワーカースレッドの終了
+	JobSystem::Finalize();
+
 	object3dCommon->Finalize();
 
 	modelManager->Finalize();
@@ -177,6 +186,9 @@ void Framework::Finalize()
 
 void Framework::Update()
 {
+	// 読み込みが終わったテクスチャの転送
+	textureManager->Update();
+
 	// シーンマネージャーの更新
 	sceneManager_->Update();
 	
@@ -0,0 +1,40 @@
+#include "ImageLoader.h"
+
+#include <filesystem>
+
+#ifndef _WIN32
+#include <cstring>
+#include <png.h>
+#endif
+
+bool ImageLoader::Load(const std::string& filePath, DirectX::ScratchImage& image)
+{
+#ifdef _WIN32
+	// ゲームでの読み込みと同じくsRGBとして読む
+	const std::wstring filePathW = std::filesystem::path(filePath).wstring();
+	return SUCCEEDED(DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image));
+#else
+	png_image png;
+	std::memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_file(&png, filePath.c_str()))
+	{
+		return false;
+	}
+
+	// 元の形式に関係なくRGBA8に揃え、WICのFORCE_SRGBと同じくsRGBとして扱う
+	png.format = PNG_FORMAT_RGBA;
+	if (FAILED(image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, png.width, png.height, 1, 1)))
+	{
+		png_image_free(&png);
+		return false;
+	}
+	const DirectX::Image* destination = image.GetImage(0, 0, 0);
+	if (!png_image_finish_read(&png, nullptr, destination->pixels, static_cast<png_int_32>(destination->rowPitch), nullptr))
+	{
+		image.Release();
+		return false;
+	}
+	return true;
+#endif
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+#include "../../externals/DirectXTex/DirectXTex.h"
+
+/// <summary>
+/// 画像ファイルの読み込み
+/// WindowsではWIC(png/jpg/bmp等)、それ以外ではlibpng(pngのみ)で読み、どちらもsRGBとして扱う
+/// テクスチャの事前変換をWindows以外でも動かすために、読み込みだけをここに分けている
+/// </summary>
+class ImageLoader
+{
+public:
+
+	/// <summary>
+	/// 画像ファイルを読み込む(WindowsではCOMを初期化したスレッドから呼ぶこと)
+	/// </summary>
+	/// <param name="filePath">画像ファイルのパス</param>
+	/// <param name="image">読み込み先(ミップマップ無し)</param>
+	/// <returns>読み込めたか</returns>
+	static bool Load(const std::string& filePath, DirectX::ScratchImage& image);
+};
@@ -0,0 +1,63 @@
+#include "LinearRingAllocator.h"
+
+#include <cassert>
+
+void LinearRingAllocator::Initialize(uint64_t capacity)
+{
+	capacity_ = capacity;
+	head_ = 0;
+	tail_ = 0;
+	frames_.clear();
+}
+
+uint64_t LinearRingAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	assert(capacity_ % alignment == 0);
+	if (size > capacity_)
+	{
+		return kInvalidOffset;
+	}
+
+	// 周回の先頭と、その中での境界に合わせた位置
+	const uint64_t lapStart = head_ - head_ % capacity_;
+	uint64_t offset = (head_ % capacity_ + alignment - 1) & ~(alignment - 1);
+	uint64_t start = lapStart + offset;
+
+	// 終端に収まらなければ残りを捨てて次の周回の先頭から
+	if (offset + size > capacity_)
+	{
+		offset = 0;
+		start = lapStart + capacity_;
+	}
+
+	// GPUが使っている所に追いつくなら割り当てられない
+	const uint64_t end = start + size;
+	if (end - tail_ > capacity_)
+	{
+		return kInvalidOffset;
+	}
+
+	head_ = end;
+	return offset;
+}
+
+void LinearRingAllocator::FinishFrame(uint64_t fenceValue)
+{
+	// 前の区切りから何も割り当てていなければ区切る必要はない
+	const uint64_t lastEnd = frames_.empty() ? tail_ : frames_.back().end;
+	if (lastEnd == head_)
+	{
+		return;
+	}
+	frames_.push_back({ fenceValue, head_ });
+}
+
+void LinearRingAllocator::Retire(uint64_t completedFenceValue)
+{
+	while (!frames_.empty() && frames_.front().fenceValue <= completedFenceValue)
+	{
+		tail_ = frames_.front().end;
+		frames_.pop_front();
+	}
+}
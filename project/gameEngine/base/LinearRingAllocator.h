@@ -0,0 +1,73 @@
+#pragma once
+
+#include <deque>
+#include <cstdint>
+
+/// <summary>
+/// リングバッファ上で前から順に切り出す割り当ての管理
+/// フレームの終わりにフェンス値で区切り、GPUがそのフェンスを越えたら区切りまでをまとめて返す
+/// バッファ自体は持たずオフセットだけを扱うので、デバイスがなくても動かせる
+/// </summary>
+class LinearRingAllocator
+{
+public:
+
+	// 割り当てられなかったときのオフセット
+	static const uint64_t kInvalidOffset = UINT64_MAX;
+
+public:
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="capacity">リングの大きさ(バイト単位)</param>
+	void Initialize(uint64_t capacity);
+
+	/// <summary>
+	/// 割り当て
+	/// 終端に収まらなければ先頭に回り込む
+	/// </summary>
+	/// <param name="size">大きさ(バイト単位)</param>
+	/// <param name="alignment">境界(2のべき乗で、リングの大きさを割り切ること)</param>
+	/// <returns>リングの先頭からのオフセット(空きがなければkInvalidOffset)</returns>
+	uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+	/// <summary>
+	/// ここまでの割り当てをフェンス値で区切る(コマンドを送ってSignalした後に呼ぶ)
+	/// </summary>
+	/// <param name="fenceValue">区切りのフェンス値</param>
+	void FinishFrame(uint64_t fenceValue);
+
+	/// <summary>
+	/// GPUが使い終えた区切りまでを空きに戻す
+	/// </summary>
+	/// <param name="completedFenceValue">GPUが実行し終えたフェンスの値</param>
+	void Retire(uint64_t completedFenceValue);
+
+public: // ゲッター
+
+	// リングの大きさ
+	uint64_t GetCapacity() const { return capacity_; }
+
+	// 使用中の大きさ(回り込みで捨てた終端の隙間を含む)
+	uint64_t GetUsedSize() const { return head_ - tail_; }
+
+private:
+
+	// フレームの区切り
+	struct FrameMarker
+	{
+		uint64_t fenceValue;
+		// 区切りまでの割り当ての終わり(通算のバイト数)
+		uint64_t end;
+	};
+
+private:
+
+	uint64_t capacity_ = 0;
+	// 次に割り当てる位置と、使用中の先頭(どちらも回り込みを含めた通算のバイト数)
+	uint64_t head_ = 0;
+	uint64_t tail_ = 0;
+	// GPUが使い終えるのを待っている区切り(古い順)
+	std::deque<FrameMarker> frames_;
+};
@@ -0,0 +1,102 @@
+#include "RenderQueue.h"
+
+#include <cassert>
+
+void RenderQueue::Submit(uint64_t key, std::function<void()> draw)
+{
+	keys_.push_back(key);
+	draws_.push_back(std::move(draw));
+}
+
+void RenderQueue::Sort()
+{
+	const uint32_t count = GetCount();
+	sortedKeys_.assign(keys_.begin(), keys_.end());
+	sortedOrder_.resize(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		sortedOrder_[i] = i;
+	}
+	scratchKeys_.resize(count);
+	scratchOrder_.resize(count);
+
+	// 下の桁から8bitずつ安定に振り分ける(LSD基数ソート)
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		uint32_t offsets[256] = {};
+		for (uint64_t key : sortedKeys_)
+		{
+			++offsets[(key >> shift) & 0xFF];
+		}
+
+		// すべて同じ値の桁は並びが変わらないので飛ばす(使っていない欄の分)
+		if (count == 0 || offsets[(sortedKeys_[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32_t sum = 0;
+		for (uint32_t& offset : offsets)
+		{
+			const uint32_t bucketCount = offset;
+			offset = sum;
+			sum += bucketCount;
+		}
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t destination = offsets[(sortedKeys_[i] >> shift) & 0xFF]++;
+			scratchKeys_[destination] = sortedKeys_[i];
+			scratchOrder_[destination] = sortedOrder_[i];
+		}
+		sortedKeys_.swap(scratchKeys_);
+		sortedOrder_.swap(scratchOrder_);
+	}
+}
+
+void RenderQueue::Execute()
+{
+	Sort();
+	for (uint32_t index : sortedOrder_)
+	{
+		draws_[index]();
+	}
+	Clear();
+}
+
+void RenderQueue::Clear()
+{
+	keys_.clear();
+	draws_.clear();
+}
+
+uint64_t RenderQueue::MakeKey(Layer layer, uint32_t pipeline, uint32_t material, uint32_t texture, uint32_t depth)
+{
+	uint64_t key = static_cast<uint64_t>(layer) & ((1ull << kLayerBits) - 1);
+	if (layer == Layer::Transparent)
+	{
+		// 重なった半透明は奥から描かないと正しく混ざらないので、切り替えの少なさより深度を優先する
+		key = (key << kDepthBits) | (depth & ((1ull << kDepthBits) - 1));
+		key = (key << kPipelineBits) | (pipeline & ((1ull << kPipelineBits) - 1));
+		key = (key << kMaterialBits) | (material & ((1ull << kMaterialBits) - 1));
+		key = (key << kTextureBits) | (texture & ((1ull << kTextureBits) - 1));
+		return key;
+	}
+	key = (key << kPipelineBits) | (pipeline & ((1ull << kPipelineBits) - 1));
+	key = (key << kMaterialBits) | (material & ((1ull << kMaterialBits) - 1));
+	key = (key << kTextureBits) | (texture & ((1ull << kTextureBits) - 1));
+	key = (key << kDepthBits) | (depth & ((1ull << kDepthBits) - 1));
+	return key;
+}
+
+uint32_t RenderQueue::QuantizeDepth(float distance, float maxDistance, bool isBackToFront)
+{
+	assert(maxDistance > 0.0f);
+	const uint32_t maxValue = (1u << kDepthBits) - 1;
+
+	// 0から1に収めてから欄の幅に広げる
+	float normalized = distance / maxDistance;
+	normalized = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+	const uint32_t value = static_cast<uint32_t>(normalized * static_cast<float>(maxValue));
+	return isBackToFront ? maxValue - value : value;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+/// <summary>
+/// 描画の並べ替え
+/// 描画ごとに64bitのキー(上位から 層・パイプライン・マテリアル・テクスチャ・深度)を付けて積み、
+/// フレームに1回基数ソートしてから実行することで、PSOやテクスチャの切り替えをまとめる
+/// 半透明の層だけは奥からの順を崩せないので、深度を層のすぐ下に置く
+/// デバイスを使わないので、並べ替えの結果だけを取り出して確かめられる
+/// </summary>
+class RenderQueue
+{
+public:
+
+	// 描画の層(小さいものから描く)
+	enum class Layer : uint8_t
+	{
+		Background,	// スカイボックス等
+		Opaque,		// 不透明なもの(手前から描く)
+		Transparent,// 半透明なもの(奥から描く)
+		Particle,	// パーティクル
+		Overlay,	// スプライト等
+	};
+
+	// キーの各欄の幅(bit)
+	static const uint32_t kLayerBits = 4;
+	static const uint32_t kPipelineBits = 4;
+	static const uint32_t kMaterialBits = 16;
+	static const uint32_t kTextureBits = 16;
+	static const uint32_t kDepthBits = 24;
+
+public:
+
+	/// <summary>
+	/// 描画を積む
+	/// </summary>
+	/// <param name="key">並べ替えのキー(MakeKeyで作る)</param>
+	/// <param name="draw">コマンドを積む処理</param>
+	void Submit(uint64_t key, std::function<void()> draw);
+
+	/// <summary>
+	/// 積んだ描画をキーの小さい順に並べる(同じキーは積んだ順のまま)
+	/// </summary>
+	void Sort();
+
+	/// <summary>
+	/// 並べ替えてキーの小さい順に実行し、空にする
+	/// </summary>
+	void Execute();
+
+	/// <summary>
+	/// 積んだ描画をすべて捨てる
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// キーを作る(各欄は幅に収まらない分を切り捨てる)
+	/// Transparentの層では 層・深度・パイプライン・マテリアル・テクスチャ の順に詰める
+	/// </summary>
+	/// <param name="layer">層</param>
+	/// <param name="pipeline">パイプラインの番号</param>
+	/// <param name="material">マテリアルの番号</param>
+	/// <param name="texture">テクスチャの番号</param>
+	/// <param name="depth">量子化した深度(QuantizeDepthで作る)</param>
+	/// <returns>キー</returns>
+	static uint64_t MakeKey(Layer layer, uint32_t pipeline, uint32_t material, uint32_t texture, uint32_t depth);
+
+	/// <summary>
+	/// カメラからの距離をキーの深度の欄に収まる整数にする
+	/// </summary>
+	/// <param name="distance">カメラからの距離</param>
+	/// <param name="maxDistance">これより遠いものは同じ値にする</param>
+	/// <param name="isBackToFront">奥から描くか(遠いほど小さい値になる)</param>
+	/// <returns>量子化した深度</returns>
+	static uint32_t QuantizeDepth(float distance, float maxDistance, bool isBackToFront = false);
+
+public: // ゲッター
+
+	// 積んだ描画の数
+	uint32_t GetCount() const { return static_cast<uint32_t>(keys_.size()); }
+
+	// 並べ替えた後のキー(Sortの後で有効)
+	const std::vector<uint64_t>& GetSortedKeys() const { return sortedKeys_; }
+
+	// 並べ替えた後の並び(積んだ順の番号。Sortの後で有効)
+	const std::vector<uint32_t>& GetSortedOrder() const { return sortedOrder_; }
+
+private:
+
+	// 積んだ順のキーと描画
+	std::vector<uint64_t> keys_;
+	std::vector<std::function<void()>> draws_;
+
+	// 並べ替えの結果と作業用の領域(毎フレーム使い回す)
+	std::vector<uint64_t> sortedKeys_;
+	std::vector<uint32_t> sortedOrder_;
+	std::vector<uint64_t> scratchKeys_;
+	std::vector<uint32_t> scratchOrder_;
+};
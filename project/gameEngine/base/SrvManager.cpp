@@ -1,6 +1,7 @@
 #include "SrvManager.h"
 
 #include <cassert>
+#include <algorithm>
 #include <comdef.h>
 #include <iostream>
 
@@ -24,6 +25,14 @@ void SrvManager::Initialize(DirectXCommon* dxCommon)
 
 uint32_t SrvManager::Allocate()
 {
+    // 解放済みの番号があればそれを使う
+    if (!freeIndices_.empty())
+    {
+        uint32_t index = freeIndices_.back();
+        freeIndices_.pop_back();
+        return index;
+    }
+
     // 上限に達していないかチェック assert
     assert(kMaxSRVCount_ > useIndex_);
 
@@ -37,13 +46,22 @@ uint32_t SrvManager::Allocate()
 
 bool SrvManager::IsAllocate()
 {
-    if (kMaxSRVCount_ > useIndex_) {
+    if (kMaxSRVCount_ > useIndex_ || !freeIndices_.empty()) {
         return true;
     } else {
         return false;
     }
 }
 
+void SrvManager::Free(uint32_t srvIndex)
+{
+    // 確保していない番号や二重解放は不正
+    assert(srvIndex < useIndex_);
+    assert(std::find(freeIndices_.begin(), freeIndices_.end(), srvIndex) == freeIndices_.end());
+
+    freeIndices_.push_back(srvIndex);
+}
+
 D3D12_CPU_DESCRIPTOR_HANDLE SrvManager::GetCPUDescriptorHandle(uint32_t index)
 {
     D3D12_CPU_DESCRIPTOR_HANDLE handleCPU = descriptorHeap_->GetCPUDescriptorHandleForHeapStart();
@@ -27,6 +27,12 @@ public:
 	/// </summary>
 	/// <returns>確保済みか</returns>
 	bool IsAllocate();
+	/// <summary>
+	/// SRV解放
+	/// 解放した番号は次のAllocateで再利用する(GPUが参照し終わってから呼ぶこと)
+	/// </summary>
+	/// <param name="srvIndex">解放するSRVインデックス</param>
+	void Free(uint32_t srvIndex);
 
 	// 計算用関数
 	/// <summary>
@@ -97,6 +103,12 @@ public: // ゲッター
 		return descriptorHeap_;
 	}
 
+	// 使用中のSRV数
+	uint32_t GetUsedCount() const { return useIndex_ - static_cast<uint32_t>(freeIndices_.size()); }
+
+	// 最大SRV数
+	uint32_t GetMaxCount() const { return kMaxSRVCount_; }
+
 public: // セッター
 
 	/// <summary>
@@ -120,6 +132,9 @@ private:
 	// 次に使用するSRVインデックス
 	uint32_t useIndex_ = 0;
 
+	// 解放されて再利用を待っているSRVインデックス
+	std::vector<uint32_t> freeIndices_;
+
 	// テクスチャキャッシュ
 	std::unordered_map<std::string, uint32_t> textureIndices_;
 
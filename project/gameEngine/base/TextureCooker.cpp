@@ -0,0 +1,206 @@
+#include "TextureCooker.h"
+
+#include "ImageLoader.h"
+
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <thread>
+#include <functional>
+
+namespace
+{
+	// 一時ファイルに書いてから置き換える(同じテクスチャを2つのスレッドが書き出しても壊れないように)
+	std::string MakeTemporaryPath(const std::string& filePath)
+	{
+		return filePath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+	}
+}
+
+bool TextureCooker::Load(const std::string& sourceFilePath, DirectX::ScratchImage& image)
+{
+	if (!IsUpToDate(sourceFilePath))
+	{
+		return false;
+	}
+
+	const std::wstring cookedFilePath = std::filesystem::path(GetCookedFilePath(sourceFilePath)).wstring();
+	return SUCCEEDED(DirectX::LoadFromDDSFile(cookedFilePath.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image));
+}
+
+bool TextureCooker::IsUpToDate(const std::string& sourceFilePath)
+{
+	SourceInfo current{};
+	if (!GetSourceInfo(sourceFilePath, current, false))
+	{
+		return false;
+	}
+
+	SourceInfo cooked{};
+	{
+		std::ifstream hashFile(GetHashFilePath(sourceFilePath), std::ios::binary);
+		if (!hashFile.read(reinterpret_cast<char*>(&cooked), sizeof(SourceInfo)))
+		{
+			return false;
+		}
+	}
+
+	if (std::memcmp(cooked.magic, kMagic_, sizeof(kMagic_)) != 0 ||
+		cooked.version != kVersion_ ||
+		cooked.sourceSize != current.sourceSize)
+	{
+		return false;
+	}
+	if (cooked.sourceWriteTime == current.sourceWriteTime)
+	{
+		return true;
+	}
+
+	// 更新時刻だけが変わっている(チェックアウトし直した等)なら中身で確かめ、
+	// 同じなら次から中身を読まずに済むよう更新時刻を書き直す
+	if (cooked.sourceHash != HashFile(sourceFilePath))
+	{
+		return false;
+	}
+	cooked.sourceWriteTime = current.sourceWriteTime;
+	WriteSourceInfo(sourceFilePath, cooked);
+	return true;
+}
+
+bool TextureCooker::Cook(const std::string& sourceFilePath, bool useCompression)
+{
+	SourceInfo info{};
+	if (!GetSourceInfo(sourceFilePath, info, true))
+	{
+		return false;
+	}
+
+	// ゲームでの読み込みと同じくsRGBとして読み、ミップマップを作る
+	DirectX::ScratchImage image{};
+	if (!ImageLoader::Load(sourceFilePath, image))
+	{
+		return false;
+	}
+	DirectX::ScratchImage mipImages{};
+	HRESULT hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
+	if (FAILED(hr))
+	{
+		return false;
+	}
+
+	// ブロック圧縮(BC7は一番よく使うモードだけを試して時間を抑える)
+	DirectX::ScratchImage compressed;
+	const DXGI_FORMAT format = useCompression ? SelectFormat(mipImages) : DXGI_FORMAT_UNKNOWN;
+	if (format != DXGI_FORMAT_UNKNOWN)
+	{
+		DirectX::TEX_COMPRESS_FLAGS flags = DirectX::TEX_COMPRESS_PARALLEL;
+		if (format == DXGI_FORMAT_BC7_UNORM || format == DXGI_FORMAT_BC7_UNORM_SRGB)
+		{
+			flags |= DirectX::TEX_COMPRESS_BC7_QUICK;
+		}
+		hr = DirectX::Compress(mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), format, flags, DirectX::TEX_THRESHOLD_DEFAULT, compressed);
+		if (FAILED(hr))
+		{
+			compressed.Release();
+		}
+	}
+	const DirectX::ScratchImage& output = compressed.GetImageCount() > 0 ? compressed : mipImages;
+
+	// DDSを書き出してから、それが有効であることを示すハッシュファイルを書き出す
+	std::error_code ec;
+	const std::string cookedFilePath = GetCookedFilePath(sourceFilePath);
+	const std::string cookedTemporaryPath = MakeTemporaryPath(cookedFilePath);
+	hr = DirectX::SaveToDDSFile(output.GetImages(), output.GetImageCount(), output.GetMetadata(), DirectX::DDS_FLAGS_NONE,
+		std::filesystem::path(cookedTemporaryPath).wstring().c_str());
+	if (FAILED(hr))
+	{
+		std::filesystem::remove(cookedTemporaryPath, ec);
+		return false;
+	}
+	std::filesystem::rename(cookedTemporaryPath, cookedFilePath, ec);
+	if (ec)
+	{
+		std::filesystem::remove(cookedTemporaryPath, ec);
+		return false;
+	}
+
+	return WriteSourceInfo(sourceFilePath, info);
+}
+
+bool TextureCooker::WriteSourceInfo(const std::string& sourceFilePath, const SourceInfo& info)
+{
+	std::error_code ec;
+	const std::string hashFilePath = GetHashFilePath(sourceFilePath);
+	const std::string hashTemporaryPath = MakeTemporaryPath(hashFilePath);
+	{
+		std::ofstream hashFile(hashTemporaryPath, std::ios::binary | std::ios::trunc);
+		hashFile.write(reinterpret_cast<const char*>(&info), sizeof(SourceInfo));
+		if (hashFile.fail())
+		{
+			return false;
+		}
+	}
+	std::filesystem::rename(hashTemporaryPath, hashFilePath, ec);
+	if (ec)
+	{
+		std::filesystem::remove(hashTemporaryPath, ec);
+		return false;
+	}
+	return true;
+}
+
+bool TextureCooker::GetSourceInfo(const std::string& sourceFilePath, SourceInfo& info, bool withHash)
+{
+	std::error_code ec;
+	std::memcpy(info.magic, kMagic_, sizeof(kMagic_));
+	info.version = kVersion_;
+	info.sourceSize = std::filesystem::file_size(sourceFilePath, ec);
+	if (ec)
+	{
+		return false;
+	}
+	info.sourceWriteTime = static_cast<int64_t>(std::filesystem::last_write_time(sourceFilePath, ec).time_since_epoch().count());
+	if (ec)
+	{
+		return false;
+	}
+	info.sourceHash = withHash ? HashFile(sourceFilePath) : 0;
+	return true;
+}
+
+uint64_t TextureCooker::HashFile(const std::string& filePath)
+{
+	std::ifstream file(filePath, std::ios::binary);
+	uint64_t hash = 14695981039346656037ull;
+	char chunk[4096];
+	while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+	{
+		for (std::streamsize i = 0; i < file.gcount(); ++i)
+		{
+			hash ^= static_cast<uint8_t>(chunk[i]);
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+DXGI_FORMAT TextureCooker::SelectFormat(const DirectX::ScratchImage& mipImages)
+{
+	// ブロック圧縮は最上位の大きさが4の倍数の2Dテクスチャだけ
+	const DirectX::TexMetadata& metadata = mipImages.GetMetadata();
+	if (DirectX::IsCompressed(metadata.format) ||
+		metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D ||
+		metadata.IsCubemap() ||
+		metadata.width % 4 != 0 || metadata.height % 4 != 0)
+	{
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	// 不透明なら4bpp、透明部分があれば8bppで品質の良いBC7
+	const bool isSrgb = DirectX::IsSRGB(metadata.format);
+	if (mipImages.IsAlphaAllOpaque())
+	{
+		return isSrgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+	}
+	return isSrgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "../../externals/DirectXTex/DirectXTex.h"
+
+/// <summary>
+/// テクスチャの変換済みファイル(.dds)の書き出しと読み込み
+/// ミップマップ付きでブロック圧縮したDDSと、元ファイルの確認用のハッシュファイルを元ファイルの隣に置く
+/// 書き出しはTextureCookツール(tools/textureCook)で事前に行い、ゲームは読み込みだけを行う
+/// </summary>
+class TextureCooker
+{
+public:
+
+	/// <summary>
+	/// 変換済みファイルの読み込み
+	/// 元ファイルが更新されていれば失敗扱いにする(呼び出し側は元ファイルを読む)
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <param name="image">読み込み先(ミップマップ付き)</param>
+	/// <returns>読み込めたか</returns>
+	static bool Load(const std::string& sourceFilePath, DirectX::ScratchImage& image);
+
+	/// <summary>
+	/// 変換済みファイルが元ファイルと一致しているか
+	/// 更新時刻だけが変わっていて中身が同じなら、ハッシュファイルの更新時刻を書き直して一致扱いにする
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <returns>一致しているか</returns>
+	static bool IsUpToDate(const std::string& sourceFilePath);
+
+	/// <summary>
+	/// 画像ファイルを読み込み、ミップマップを作って書き出す(WindowsではCOMを初期化したスレッドから呼ぶこと)
+	/// 圧縮するなら不透明はBC1、透明部分があればBC7にする(最上位の大きさが4の倍数でなければ圧縮しない)
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <param name="useCompression">ブロック圧縮するか(UIのように劣化させたくないものはfalse)</param>
+	/// <returns>書き出せたか</returns>
+	static bool Cook(const std::string& sourceFilePath, bool useCompression);
+
+	/// <summary>
+	/// 変換済みファイルのパス
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <returns>変換済みファイルのパス</returns>
+	static std::string GetCookedFilePath(const std::string& sourceFilePath) { return sourceFilePath + ".dds"; }
+
+	/// <summary>
+	/// 元ファイルの確認用のハッシュファイルのパス
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <returns>ハッシュファイルのパス</returns>
+	static std::string GetHashFilePath(const std::string& sourceFilePath) { return sourceFilePath + ".dds.hash"; }
+
+private:
+
+	// ハッシュファイルの中身
+	struct SourceInfo
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceWriteTime;
+		uint64_t sourceHash;
+	};
+
+	/// <summary>
+	/// 元ファイルの情報を集める
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <param name="info">書き込み先</param>
+	/// <param name="withHash">中身のハッシュも求めるか</param>
+	/// <returns>元ファイルがあったか</returns>
+	static bool GetSourceInfo(const std::string& sourceFilePath, SourceInfo& info, bool withHash);
+
+	/// <summary>
+	/// ハッシュファイルの書き出し(一時ファイルに書いてから置き換える)
+	/// </summary>
+	/// <param name="sourceFilePath">元の画像ファイルのパス</param>
+	/// <param name="info">元ファイルの情報</param>
+	/// <returns>書き出せたか</returns>
+	static bool WriteSourceInfo(const std::string& sourceFilePath, const SourceInfo& info);
+
+	/// <summary>
+	/// ファイルの中身のハッシュ(FNV-1a)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>ハッシュ値</returns>
+	static uint64_t HashFile(const std::string& filePath);
+
+	/// <summary>
+	/// 圧縮形式を選ぶ
+	/// </summary>
+	/// <param name="mipImages">ミップマップ付きのイメージ</param>
+	/// <returns>圧縮形式(圧縮しないならDXGI_FORMAT_UNKNOWN)</returns>
+	static DXGI_FORMAT SelectFormat(const DirectX::ScratchImage& mipImages);
+
+private:
+
+	static constexpr char kMagic_[4] = { 'T', 'X', 'C', 'K' };
+	static const uint32_t kVersion_ = 2;
+};
@@ -1,8 +1,12 @@
 #include "TextureManager.h"
 
 #include <cassert>
+#include <algorithm>
 #include <d3d12.h>
 
+#include "JobSystem.h"
+#include "TextureCooker.h"
+
 uint32_t TextureManager::kSRVIndexTop = 1;
 
 TextureManager* TextureManager::GetInstance()
@@ -11,7 +15,10 @@ TextureManager* TextureManager::GetInstance()
 	return &instance;
 }
 
-void TextureManager::Finalize(){}
+void TextureManager::Finalize()
+{
+	StopStreaming();
+}
 
 void TextureManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 {
@@ -20,18 +27,280 @@ void TextureManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager)
 
 	// SRVの数と同数
 	textureDatas.reserve(DirectXCommon::kMaxSRVCount);
+
+	// 読み込みワーカースレッドを立てる
+	isStreamingStopped_ = false;
+	for (uint32_t i = 0; i < kStreamingThreadCount_; ++i)
+	{
+		streamingThreads_.emplace_back(&TextureManager::StreamingWorker, this);
+	}
 }
 
 void TextureManager::LoadTexture(const std::string& filePath, bool forceCubeMap)
 {
 	// 読み込み済みテクスチャを検索
-	if (textureDatas.contains(filePath)) {
+	auto it = textureDatas.find(filePath);
+	if (it != textureDatas.end()) {
+		// 読み込み待ちなら中身が要るので、ここで読み込み終える
+		if (it->second.isStreaming)
+		{
+			FinishStreaming(filePath, it->second);
+		}
+		// 参照カウントで先に取得されていても、LoadTextureした以上は最後のReleaseTextureで消さない
+		it->second.isResident = true;
 		// 読み込み済みなら早期return
 		return;
 	}
 	// テクスチャ枚数上限チェック
 	assert(srvManager_->IsAllocate());
 
+	// 転送はフレームのコマンドリストに積むだけにして、GPUの完了は待たない
+	DirectX::ScratchImage mipImages = DecodeTexture(filePath, forceCubeMap);
+	CreateTexture(filePath, mipImages);
+	textureDatas.at(filePath).isResident = true;
+}
+
+void TextureManager::LoadTextures(const std::vector<std::string>& filePaths)
+{
+	LoadMissingTextures(filePaths, true);
+}
+
+void TextureManager::AcquireTexture(const std::string& filePath)
+{
+	LoadMissingTextures({ filePath }, false);
+	textureDatas.at(filePath).refCount++;
+}
+
+void TextureManager::AcquireTextures(const std::vector<std::string>& filePaths)
+{
+	LoadMissingTextures(filePaths, false);
+	for (const std::string& filePath : filePaths)
+	{
+		textureDatas.at(filePath).refCount++;
+	}
+}
+
+void TextureManager::AcquireTextureAsync(const std::string& filePath)
+{
+	if (!textureDatas.contains(filePath))
+	{
+		// 仮テクスチャは常駐させておく
+		LoadTexture(kPlaceholderFilePath_);
+		const TextureData& placeholder = textureDatas.at(kPlaceholderFilePath_);
+
+		// テクスチャ枚数上限チェック
+		assert(srvManager_->IsAllocate());
+
+		// SRVの番号を先に決め、読み込みが終わるまでは仮テクスチャを指しておく
+		TextureData& textureData = textureDatas[filePath];
+		textureData.metadata = placeholder.metadata;
+		textureData.resource = placeholder.resource;
+		textureData.srvIndex = srvManager_->Allocate();
+		textureData.srvHandleCPU = srvManager_->GetCPUDescriptorHandle(textureData.srvIndex);
+		textureData.srvHandleGPU = srvManager_->GetGPUDescriptorHandle(textureData.srvIndex);
+		textureData.isStreaming = true;
+		CreateShaderResourceView(filePath, textureData);
+
+		// デコードはワーカースレッドに任せる
+		{
+			std::lock_guard<std::mutex> lock(streamingMutex_);
+			decodeQueue_.push_back(filePath);
+		}
+		streamingCondition_.notify_one();
+	}
+	textureDatas.at(filePath).refCount++;
+}
+
+void TextureManager::AcquireTexturesAsync(const std::vector<std::string>& filePaths)
+{
+	for (const std::string& filePath : filePaths)
+	{
+		AcquireTextureAsync(filePath);
+	}
+}
+
+void TextureManager::Update()
+{
+	ReleaseCompletedUploads();
+
+	std::vector<DecodedTexture> decodedTextures;
+	{
+		std::lock_guard<std::mutex> lock(streamingMutex_);
+		decodedTextures.swap(decodedTextures_);
+	}
+
+	// デコードが終わったものの転送をこのフレームのコマンドリストにまとめて積む
+	// 前のフレームはPostDrawで完了を待っているので、SRVを書き換えてもGPUが読んでいる途中のものは無い
+	for (DecodedTexture& decoded : decodedTextures)
+	{
+		auto it = textureDatas.find(decoded.filePath);
+		// 読み込み中に手放されたものと、先に同期で読み込み終えたものは捨てる
+		if (it == textureDatas.end() || !it->second.isStreaming)
+		{
+			continue;
+		}
+
+		UploadTexture(it->second, decoded.mipImages);
+		CreateShaderResourceView(decoded.filePath, it->second);
+		it->second.isStreaming = false;
+	}
+}
+
+bool TextureManager::IsStreaming(const std::string& filePath) const
+{
+	auto it = textureDatas.find(filePath);
+	return it != textureDatas.end() && it->second.isStreaming;
+}
+
+void TextureManager::ReleaseTexture(const std::string& filePath)
+{
+	auto it = textureDatas.find(filePath);
+	if (it == textureDatas.end()) {
+		Logger::Log("Error: Texture not found for filePath: " + filePath);
+		return;
+	}
+
+	TextureData& textureData = it->second;
+	assert(textureData.refCount > 0);
+	textureData.refCount--;
+
+	// 常駐テクスチャと、まだ参照があるものは残す
+	if (textureData.refCount > 0 || textureData.isResident)
+	{
+		return;
+	}
+
+	// 描画は毎フレームGPUの完了を待っているので、ここで解放しても参照中のものは無い
+	// (転送待ちのリソースはPendingUploadが持っているので、実行前に消えることはない)
+	srvManager_->Free(textureData.srvIndex);
+	textureDatas.erase(it);
+}
+
+uint64_t TextureManager::GetMemorySize() const
+{
+	uint64_t size = 0;
+	for (const auto& [filePath, textureData] : textureDatas)
+	{
+		size += textureData.sizeInBytes;
+	}
+	return size;
+}
+
+void TextureManager::LoadMissingTextures(const std::vector<std::string>& filePaths, bool isResident)
+{
+	// 未読み込みのものと読み込み待ちのものを重複なく集める
+	std::vector<std::string> targets;
+	for (const std::string& filePath : filePaths)
+	{
+		auto it = textureDatas.find(filePath);
+		// 取得済みのものも常駐の指定があれば常駐扱いにする
+		if (isResident && it != textureDatas.end())
+		{
+			it->second.isResident = true;
+		}
+		const bool isMissing = it == textureDatas.end() || it->second.isStreaming;
+		if (isMissing && std::find(targets.begin(), targets.end(), filePath) == targets.end())
+		{
+			targets.push_back(filePath);
+		}
+	}
+	if (targets.empty())
+	{
+		return;
+	}
+
+	// デコードとミップマップ生成はワーカースレッドで並列に行う
+	std::vector<DirectX::ScratchImage> images(targets.size());
+	JobSystem::ParallelFor(targets.size(), [&](size_t index)
+		{
+			images[index] = DecodeTexture(targets[index], false);
+		});
+
+	// GPUリソースの生成と転送の記録はメインスレッドでまとめて行い、フレームのコマンドリストで1回で実行する
+	for (size_t i = 0; i < targets.size(); ++i)
+	{
+		auto it = textureDatas.find(targets[i]);
+		if (it != textureDatas.end())
+		{
+			// 読み込み待ちのものは確保済みのSRVに書き込む
+			UploadTexture(it->second, images[i]);
+			CreateShaderResourceView(targets[i], it->second);
+			it->second.isStreaming = false;
+			continue;
+		}
+
+		// テクスチャ枚数上限チェック
+		assert(srvManager_->IsAllocate());
+		CreateTexture(targets[i], images[i]);
+		textureDatas.at(targets[i]).isResident = isResident;
+	}
+}
+
+void TextureManager::FinishStreaming(const std::string& filePath, TextureData& textureData)
+{
+	DirectX::ScratchImage mipImages = DecodeTexture(filePath, false);
+	UploadTexture(textureData, mipImages);
+	CreateShaderResourceView(filePath, textureData);
+	textureData.isStreaming = false;
+}
+
+void TextureManager::StreamingWorker()
+{
+	// WICでデコードするので、スレッドごとに1回だけCOMを初期化する
+	HRESULT coInitialize = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	while (true)
+	{
+		std::string filePath;
+		{
+			std::unique_lock<std::mutex> lock(streamingMutex_);
+			streamingCondition_.wait(lock, [this]() { return isStreamingStopped_ || !decodeQueue_.empty(); });
+			if (isStreamingStopped_)
+			{
+				break;
+			}
+			filePath = std::move(decodeQueue_.front());
+			decodeQueue_.pop_front();
+		}
+
+		DirectX::ScratchImage mipImages = DecodeTexture(filePath, false);
+
+		std::lock_guard<std::mutex> lock(streamingMutex_);
+		decodedTextures_.push_back({ std::move(filePath), std::move(mipImages) });
+	}
+
+	if (SUCCEEDED(coInitialize))
+	{
+		CoUninitialize();
+	}
+}
+
+void TextureManager::StopStreaming()
+{
+	{
+		std::lock_guard<std::mutex> lock(streamingMutex_);
+		isStreamingStopped_ = true;
+		decodeQueue_.clear();
+	}
+	streamingCondition_.notify_all();
+	for (std::thread& thread : streamingThreads_)
+	{
+		thread.join();
+	}
+	streamingThreads_.clear();
+	decodedTextures_.clear();
+}
+
+void TextureManager::ReleaseCompletedUploads()
+{
+	// フェンスが進んだ転送は実行済みなので、転送元のバッファはもう要らない
+	const uint64_t completedFenceValue = dxCommon_->GetCompletedFenceValue();
+	std::erase_if(pendingUploads_, [completedFenceValue](const PendingUpload& upload) { return upload.fenceValue <= completedFenceValue; });
+}
+
+DirectX::ScratchImage TextureManager::DecodeTexture(const std::string& filePath, bool forceCubeMap)
+{
+	// COMは呼び出し元のスレッドで初期化済み(メインはWinApp、ワーカーはスレッド開始時)
 	//テクスチャファイルを読んでプログラムで扱えるようにする
 	DirectX::ScratchImage image{};
 	std::wstring filePathW = StringUtility::ConvertString(filePath);
@@ -43,6 +312,14 @@ void TextureManager::LoadTexture(const std::string& filePath, bool forceCubeMap)
 	}
 	else
 	{
+		// TextureCookで変換済みのDDSが古くなければ、デコードとミップマップ生成を飛ばしてそちらを使う
+		// 無ければ元の画像を読む(ここでは書き出さない)
+		DirectX::ScratchImage cookedImage{};
+		if (TextureCooker::Load(filePath, cookedImage))
+		{
+			return cookedImage;
+		}
+
 		hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
 		assert(SUCCEEDED(hr));
 	}
@@ -76,20 +353,41 @@ void TextureManager::LoadTexture(const std::string& filePath, bool forceCubeMap)
 		meta2.IsCubemap(), meta2.arraySize, meta2.mipLevels
 	).c_str());
 
+	return mipImages;
+}
+
+void TextureManager::CreateTexture(const std::string& filePath, const DirectX::ScratchImage& mipImages)
+{
 	// テクスチャデータを追加
 	// 追加したテクスチャデータの参照を取得する
 	TextureData& textureData = textureDatas[filePath];
 
-	textureData.metadata = mipImages.GetMetadata();
-	textureData.resource = dxCommon_->CreateTextureResource(textureData.metadata);
-	textureData.intermediate = dxCommon_->UploadTextureData(textureData.resource, mipImages);
-	dxCommon_->CommandPass();
+	UploadTexture(textureData, mipImages);
 
 	// テクスチャデータの要素番号をSRVのインデックスをする
 	textureData.srvIndex = srvManager_->Allocate();
 	textureData.srvHandleCPU = srvManager_->GetCPUDescriptorHandle(textureData.srvIndex);
 	textureData.srvHandleGPU = srvManager_->GetGPUDescriptorHandle(textureData.srvIndex);
 
+	CreateShaderResourceView(filePath, textureData);
+}
+
+void TextureManager::UploadTexture(TextureData& textureData, const DirectX::ScratchImage& mipImages)
+{
+	textureData.metadata = mipImages.GetMetadata();
+	textureData.resource = dxCommon_->CreateTextureResource(textureData.metadata);
+
+	// 転送は今のフレームのコマンドリストに積み、実行が終わるまで中間リソースを残しておく
+	Microsoft::WRL::ComPtr<ID3D12Resource> intermediate = dxCommon_->UploadTextureData(textureData.resource, mipImages);
+	pendingUploads_.push_back({ intermediate, textureData.resource, dxCommon_->GetPendingFenceValue() });
+
+	// 使用メモリ量を記録
+	D3D12_RESOURCE_DESC resourceDesc = textureData.resource->GetDesc();
+	textureData.sizeInBytes = dxCommon_->GetDevice()->GetResourceAllocationInfo(0, 1, &resourceDesc).SizeInBytes;
+}
+
+void TextureManager::CreateShaderResourceView(const std::string& filePath, const TextureData& textureData)
+{
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
 	// SRVの設定
 	srvDesc.Format = textureData.metadata.format;
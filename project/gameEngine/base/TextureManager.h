@@ -1,6 +1,11 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include "DirectXCommon.h"
 #include "SrvManager.h"
@@ -37,15 +42,63 @@ public:
 
 	/// <summary>
 	/// テクスチャファイルの読み込み
+	/// 常駐扱いになる(先にAcquireTextureで取得済みのものも常駐に切り替える)
 	/// </summary>
 	/// <param name="filePath">ファイルパス</param>
 	/// <param name="forceCubeMap">強制的にキューブマップとして読み込むか</param>
 	void LoadTexture(const std::string& filePath, bool forceCubeMap = false);
 
+	/// <summary>
+	/// 複数のテクスチャファイルをまとめて読み込み
+	/// デコードは並列に行い、GPUへの転送は1回にまとめる(メインスレッドから呼ぶこと)
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	void LoadTextures(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// テクスチャの参照を取得(無ければ読み込む)
+	/// LoadTextureで読み込んだテクスチャは常駐扱いになり、参照が0になっても破棄しない
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	void AcquireTexture(const std::string& filePath);
+
+	/// <summary>
+	/// 複数のテクスチャの参照をまとめて取得(無いものはLoadTexturesと同様にまとめて読み込む)
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	void AcquireTextures(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// テクスチャの参照を取得し、未読み込みならワーカースレッドでの読み込みを予約する
+	/// 読み込みが終わるまでは仮テクスチャを指すSRVになる(SRVの番号は読み込み後も変わらない)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	void AcquireTextureAsync(const std::string& filePath);
+
+	/// <summary>
+	/// 複数のテクスチャの参照をまとめて取得し、未読み込みのものは読み込みを予約する
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	void AcquireTexturesAsync(const std::vector<std::string>& filePaths);
+
+	/// <summary>
+	/// 毎フレームの更新(描画コマンドを積む前にメインスレッドから呼ぶ)
+	/// デコードが終わったテクスチャの転送をまとめて記録し、転送が終わった中間リソースを解放する
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// テクスチャの参照を1つ手放す
+	/// 参照が0になった常駐でないテクスチャはリソースとSRVを解放する(GPUが参照し終わってから呼ぶこと)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	void ReleaseTexture(const std::string& filePath);
+
 public: // ゲッター
 
 	/// <summary>
 	/// メタデータを取得
+	/// 読み込み待ちのテクスチャは仮テクスチャのメタデータを返す
 	/// </summary>
 	/// <param name="filePath">ファイルパス</param>
 	/// <returns>メタデータ</returns>
@@ -71,6 +124,22 @@ public: // ゲッター
 	/// <returns>SRV管理クラス</returns>
 	SrvManager* GetSrvManager() const { return srvManager_; }
 
+	// 読み込み済みテクスチャ数
+	size_t GetTextureCount() const { return textureDatas.size(); }
+
+	/// <summary>
+	/// 読み込み待ちか(まだ仮テクスチャを指しているか)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>読み込み待ちならtrue</returns>
+	bool IsStreaming(const std::string& filePath) const;
+
+	/// <summary>
+	/// 読み込み済みテクスチャが使っているGPUメモリ量を取得
+	/// </summary>
+	/// <returns>バイト数</returns>
+	uint64_t GetMemorySize() const;
+
 
 private: // 構造体
 
@@ -79,12 +148,85 @@ private: // 構造体
 	{
 		DirectX::TexMetadata metadata;
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
-		Microsoft::WRL::ComPtr<ID3D12Resource> intermediate;
 		uint32_t srvIndex;
 		D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU;
 		D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU;
+		uint64_t sizeInBytes = 0;
+		uint32_t refCount = 0;
+		bool isResident = false;
+		bool isStreaming = false; // ワーカースレッドで読み込み中
+	};
+
+	// GPUの実行待ちの転送(フェンスが進むまで転送元と転送先を生かしておく)
+	struct PendingUpload
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> intermediate;
+		Microsoft::WRL::ComPtr<ID3D12Resource> texture;
+		uint64_t fenceValue;
 	};
 
+	// ワーカースレッドでデコードし終えたテクスチャ
+	struct DecodedTexture
+	{
+		std::string filePath;
+		DirectX::ScratchImage mipImages;
+	};
+
+private:
+
+	/// <summary>
+	/// テクスチャファイルのデコードとミップマップ生成(デバイスを使わないのでどのスレッドからでも呼べる)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="forceCubeMap">強制的にキューブマップとして読み込むか</param>
+	/// <returns>ミップマップ付きのイメージ</returns>
+	static DirectX::ScratchImage DecodeTexture(const std::string& filePath, bool forceCubeMap);
+
+	/// <summary>
+	/// GPUリソースとSRVの生成、転送コマンドの記録
+	/// 転送はフレームのコマンドリストに積むので、同じフレームの描画より先に実行される
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="mipImages">ミップマップ付きのイメージ</param>
+	void CreateTexture(const std::string& filePath, const DirectX::ScratchImage& mipImages);
+
+	/// <summary>
+	/// GPUリソースの生成と転送コマンドの記録
+	/// </summary>
+	/// <param name="textureData">テクスチャデータ</param>
+	/// <param name="mipImages">ミップマップ付きのイメージ</param>
+	void UploadTexture(TextureData& textureData, const DirectX::ScratchImage& mipImages);
+
+	/// <summary>
+	/// テクスチャデータのSRV番号にSRVを書き込む
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="textureData">テクスチャデータ</param>
+	void CreateShaderResourceView(const std::string& filePath, const TextureData& textureData);
+
+	/// <summary>
+	/// 読み込み待ちのテクスチャをこのスレッドで読み込み終える(すぐに中身が必要になったとき)
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <param name="textureData">テクスチャデータ</param>
+	void FinishStreaming(const std::string& filePath, TextureData& textureData);
+
+	// 読み込みワーカースレッドの処理
+	void StreamingWorker();
+
+	// ワーカースレッドを止める
+	void StopStreaming();
+
+	/// <summary>
+	/// 未読み込みのテクスチャをまとめて読み込む
+	/// </summary>
+	/// <param name="filePaths">ファイルパス一覧</param>
+	/// <param name="isResident">常駐扱いにするか</param>
+	void LoadMissingTextures(const std::vector<std::string>& filePaths, bool isResident);
+
+	// GPUが実行し終えた転送の中間リソースを解放する
+	void ReleaseCompletedUploads();
+
 private:
 
 	// テクスチャデータ
@@ -94,6 +236,24 @@ private:
 
 	SrvManager* srvManager_ = nullptr;
 
+	// GPUの実行待ちの転送
+	std::vector<PendingUpload> pendingUploads_;
+
+	// 読み込みワーカースレッド
+	std::vector<std::thread> streamingThreads_;
+	// 以下はstreamingMutex_で守る
+	std::mutex streamingMutex_;
+	std::condition_variable streamingCondition_;
+	std::deque<std::string> decodeQueue_;
+	std::vector<DecodedTexture> decodedTextures_;
+	bool isStreamingStopped_ = false;
+
 	// SRVインデックスの開始番号
 	static uint32_t kSRVIndexTop;
+
+	// 読み込み待ちの間に使う仮テクスチャ
+	static inline const std::string kPlaceholderFilePath_ = "resources/images/white.png";
+
+	// 読み込みワーカースレッドの数
+	static const uint32_t kStreamingThreadCount_ = 2;
 };
\ No newline at end of file
@@ -14,12 +14,12 @@ void MyGame::Initialize()
 	SceneManager::GetInstance()->ChangeScene("TITLE");
 
 
-	// モデルの読み込み処理をスレッドで実行
-	std::thread loadModelThread(&MyGame::LoadModel, this);
+	// 音声の読み込みは別スレッドで行い、その間にモデルを読み込む
+	// (モデルは内部で解析を並列化し、GPUへの転送はこのスレッドでまとめて行う)
 	std::thread loadAudioThread(&MyGame::LoadSound, this);
+	LoadModel();
 
 	// スレッドの終了を待つ
-	loadModelThread.join(); 
 	loadAudioThread.join();
 
 	// パーティクルグループの生成
@@ -44,6 +44,14 @@ void MyGame::Initialize()
 	particleManager->CreateParticleGroup("HitReaction", "resources/images/white.png", "plane.obj", "Cube", "HitReaction");
 	particleManager->CreateParticleGroup("BltReaction", "resources/images/gradationLine.png", "plane.obj", "Ring", "BltReaction");
 
+	// 負荷が高いときの間引き優先度(足元の土埃から先に削り、被弾の反応は残す)
+	particleManager->SetGroupPriority("walk", 0.0f);
+	particleManager->SetGroupPriority("enemyWalk", 0.0f);
+	particleManager->SetGroupPriority("rupture", 0.3f);
+	particleManager->SetGroupPriority("explosionGroup", 0.3f);
+	particleManager->SetGroupPriority("HitReaction", 1.0f);
+	particleManager->SetGroupPriority("BltReaction", 1.0f);
+
 	// Cylinderを出すときに向き指定する
 	ParticleMotion::SetDirection("UP");
 
@@ -313,6 +321,9 @@ void MyGame::Draw()
 
 	particleManager->Draw();
 
+	// 積んだ描画を 背景・不透明・半透明・パーティクル・スプライト の層の順に並べ替えてまとめて描画
+	dxCommon->GetRenderQueue().Execute();
+
 	renderTexture->EndRender();
 
 
@@ -333,23 +344,22 @@ void MyGame::Draw()
 
 void MyGame::LoadModel()
 {
-	ModelManager::GetInstance()->LoadModel("cube.obj");
-	ModelManager::GetInstance()->LoadModel("plane.obj");
-	ModelManager::GetInstance()->LoadModel("sphere.obj");
-	ModelManager::GetInstance()->LoadModel("terrain.obj");
-	ModelManager::GetInstance()->LoadModel("player/player.obj");
-	ModelManager::GetInstance()->LoadModel("player/bullet/playerBullet.obj");
-	ModelManager::GetInstance()->LoadModel("enemy/normal/normalEnemy.obj");
-	ModelManager::GetInstance()->LoadModel("enemy/normal/bullet/enemyBullet.obj");
-	ModelManager::GetInstance()->LoadModel("enemy/trap/trapEnemy.obj");
-	ModelManager::GetInstance()->LoadModel("enemy/trap/timeBomb/bomb.obj");
-	ModelManager::GetInstance()->LoadModel("enemy/trap/vignette/vignette.obj");
-	ModelManager::GetInstance()->LoadModel("wall/wall.obj");
-	ModelManager::GetInstance()->LoadModel("field/field.obj");
-	ModelManager::GetInstance()->LoadModel("goal/goal.obj");
-	ModelManager::GetInstance()->LoadModel("logo/logo.obj");
-	ModelManager::GetInstance()->LoadModel("barrie/barrie.obj");
-	
+	// 全シーンで使うモデルだけを常駐させる(シーン固有のものはresources/scenes/assetManifest.jsonで読み込む)
+	ModelManager::GetInstance()->LoadModels({
+		"cube.obj",
+		"plane.obj",
+		"sphere.obj",
+		"terrain.obj",
+		"player/player.obj",
+		"player/bullet/playerBullet.obj",
+		"enemy/normal/normalEnemy.obj",
+		"enemy/normal/bullet/enemyBullet.obj",
+		"enemy/trap/trapEnemy.obj",
+		"enemy/trap/timeBomb/bomb.obj",
+		"enemy/trap/vignette/vignette.obj",
+		"field/field.obj",
+		"logo/logo.obj",
+		});
 }
 
 void MyGame::LoadSound()
@@ -0,0 +1,96 @@
+#include "SceneAssetManifest.h"
+
+#include <fstream>
+#include <utility>
+
+#include "../../externals/json/json.hpp"
+
+#include "ModelManager.h"
+#include "TextureManager.h"
+#include "Logger.h"
+
+SceneAssetManifest::~SceneAssetManifest()
+{
+	Release();
+}
+
+SceneAssetManifest::SceneAssetManifest(SceneAssetManifest&& other) noexcept
+	: sceneName_(std::move(other.sceneName_)),
+	modelPaths_(std::move(other.modelPaths_)),
+	texturePaths_(std::move(other.texturePaths_)),
+	isAcquired_(std::exchange(other.isAcquired_, false))
+{
+}
+
+SceneAssetManifest& SceneAssetManifest::operator=(SceneAssetManifest&& other) noexcept
+{
+	if (this != &other)
+	{
+		// 今持っている参照は新しい一覧を受け取る前に手放す
+		Release();
+		sceneName_ = std::move(other.sceneName_);
+		modelPaths_ = std::move(other.modelPaths_);
+		texturePaths_ = std::move(other.texturePaths_);
+		isAcquired_ = std::exchange(other.isAcquired_, false);
+	}
+	return *this;
+}
+
+bool SceneAssetManifest::Load(const std::string& filePath, const std::string& sceneName)
+{
+	Release();
+	sceneName_ = sceneName;
+	modelPaths_.clear();
+	texturePaths_.clear();
+
+	std::ifstream file(filePath);
+	if (file.fail())
+	{
+		Logger::Log("SceneAssetManifest : failed to open " + filePath + "\n");
+		return false;
+	}
+
+	nlohmann::json json;
+	file >> json;
+	if (!json.is_object() or !json.contains(sceneName))
+	{
+		Logger::Log("SceneAssetManifest : no entry for scene " + sceneName + "\n");
+		return false;
+	}
+
+	const nlohmann::json& scene = json[sceneName];
+	modelPaths_ = scene.value("models", std::vector<std::string>{});
+	texturePaths_ = scene.value("textures", std::vector<std::string>{});
+	return true;
+}
+
+void SceneAssetManifest::Acquire()
+{
+	if (isAcquired_)
+	{
+		return;
+	}
+
+	// モデルとテクスチャはそれぞれまとめて読み込む(読み込み済みなら参照が増えるだけ)
+	ModelManager::GetInstance()->LoadModels(modelPaths_);
+	TextureManager::GetInstance()->AcquireTextures(texturePaths_);
+	isAcquired_ = true;
+}
+
+void SceneAssetManifest::Release()
+{
+	if (!isAcquired_)
+	{
+		return;
+	}
+
+	for (const std::string& modelPath : modelPaths_)
+	{
+		ModelManager::GetInstance()->ReleaseModel(modelPath);
+	}
+	for (const std::string& texturePath : texturePaths_)
+	{
+		TextureManager::GetInstance()->ReleaseTexture(texturePath);
+	}
+	isAcquired_ = false;
+}
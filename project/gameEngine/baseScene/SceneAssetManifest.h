@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/// <summary>
+/// シーンごとの資産一覧
+/// 一覧にあるモデルとテクスチャの参照を持ち、手放すと他で使われていないものは解放される
+/// </summary>
+class SceneAssetManifest
+{
+public:
+
+	SceneAssetManifest() = default;
+	// 参照を手放す
+	~SceneAssetManifest();
+	SceneAssetManifest(const SceneAssetManifest&) = delete;
+	SceneAssetManifest& operator=(const SceneAssetManifest&) = delete;
+	SceneAssetManifest(SceneAssetManifest&& other) noexcept;
+	SceneAssetManifest& operator=(SceneAssetManifest&& other) noexcept;
+
+	/// <summary>
+	/// 一覧ファイルからシーンの資産一覧を読み込む
+	/// </summary>
+	/// <param name="filePath">一覧ファイルのパス</param>
+	/// <param name="sceneName">シーン名</param>
+	/// <returns>シーンの記述があったか</returns>
+	bool Load(const std::string& filePath, const std::string& sceneName);
+
+	/// <summary>
+	/// 一覧にある資産の参照を取得する(未読み込みのものはまとめて読み込む)
+	/// </summary>
+	void Acquire();
+
+	/// <summary>
+	/// 取得した参照を手放す
+	/// </summary>
+	void Release();
+
+public: // ゲッター
+
+	// シーン名
+	const std::string& GetSceneName() const { return sceneName_; }
+
+	// モデルのパス一覧
+	const std::vector<std::string>& GetModelPaths() const { return modelPaths_; }
+
+	// テクスチャのパス一覧
+	const std::vector<std::string>& GetTexturePaths() const { return texturePaths_; }
+
+private:
+
+	// シーン名
+	std::string sceneName_;
+
+	// モデルのパス("resources/models/"からの相対パス)
+	std::vector<std::string> modelPaths_;
+
+	// テクスチャのパス
+	std::vector<std::string> texturePaths_;
+
+	// 参照を取得しているか
+	bool isAcquired_ = false;
+};
@@ -1,5 +1,11 @@
 #include "SceneManager.h"
 #include <cassert>
+#include <format>
+
+#include "ModelManager.h"
+#include "TextureManager.h"
+#include "../particle/ParticleManager.h"
+#include "Logger.h"
 
 SceneManager* SceneManager::GetInstance()
 {
@@ -14,12 +20,24 @@ void SceneManager::Finalize()
         scene_->Finalize();
         scene_.reset();
     }
+
+    // シーンで作ったパーティクルグループを破棄する
+    ParticleManager::GetInstance()->DestroySceneParticleGroups();
+
+    // シーンの資産の参照を手放す
+    sceneAssets_.Release();
+    ModelManager::GetInstance()->CollectReleasedModels();
 }
 
 void SceneManager::Update()
 {
     if (nextScene_)
     {
+        // 次のシーンの資産を先に取得する(両方のシーンで使うものを読み直さないため)
+        SceneAssetManifest nextAssets;
+        nextAssets.Load(kAssetManifestPath_, nextSceneName_);
+        nextAssets.Acquire();
+
         // 旧シーン終了
         if (scene_)
         {
@@ -27,6 +45,14 @@ void SceneManager::Update()
             scene_.reset();
         }
 
+        // 旧シーンで作ったパーティクルグループを破棄する(モデル、SRV、テクスチャの参照を手放す)
+        ParticleManager::GetInstance()->DestroySceneParticleGroups();
+
+        // 旧シーンの資産を手放す(次のシーンで使わないものはここで解放される)
+        sceneAssets_ = std::move(nextAssets);
+        // 破棄を遅らせていたモデルのうち、使い終わったものを破棄する
+        ModelManager::GetInstance()->CollectReleasedModels();
+
         // シーン切り替え
         scene_ = std::move(nextScene_);
         nextScene_.reset();
@@ -34,8 +60,11 @@ void SceneManager::Update()
         // シーンマネージャをセット
         scene_->SetSceneManager(this);
 
-        // 次のシーンを初期化
+        // 次のシーンを初期化(ここで作られたパーティクルグループはシーンの終了で破棄する)
+        ParticleManager::GetInstance()->BeginSceneParticleGroups();
         scene_->Initialize();
+
+        ReportMemoryUsage(nextSceneName_);
     }
 
     // 実行中シーンを更新する
@@ -61,4 +90,18 @@ void SceneManager::ChangeScene(const std::string& sceneName)
 
     // 次のシーンを生成
     nextScene_ = sceneFactory_->CreateScene(sceneName);
+    nextSceneName_ = sceneName;
+}
+
+void SceneManager::ReportMemoryUsage(const std::string& sceneName) const
+{
+    const ModelManager* modelManager = ModelManager::GetInstance();
+    const TextureManager* textureManager = TextureManager::GetInstance();
+    const SrvManager* srvManager = textureManager->GetSrvManager();
+
+    Logger::Log(std::format("Scene {} : models {} ({:.1f} KB), textures {} ({:.1f} MB), SRV {} / {}\n",
+        sceneName,
+        modelManager->GetModelCount(), static_cast<double>(modelManager->GetMemorySize()) / 1024.0,
+        textureManager->GetTextureCount(), static_cast<double>(textureManager->GetMemorySize()) / (1024.0 * 1024.0),
+        srvManager->GetUsedCount(), srvManager->GetMaxCount()));
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "BaseScene.h"
 #include "AbstractSceneFactory.h"
+#include "SceneAssetManifest.h"
 
 /// <summary>
 /// シーンマネージャ
@@ -48,12 +49,29 @@ public:
 
 private:
 
+	/// <summary>
+	/// 資産のメモリ使用量をログに出す
+	/// </summary>
+	/// <param name="sceneName">シーン名</param>
+	void ReportMemoryUsage(const std::string& sceneName) const;
+
+private:
+
+	// シーンごとの資産一覧のファイル
+	static inline const std::string kAssetManifestPath_ = "resources/scenes/assetManifest.json";
+
 	// 今のシーン
 	std::unique_ptr<BaseScene> scene_ = nullptr;
 
 	// 次のシーン
 	std::unique_ptr<BaseScene> nextScene_ = nullptr;
 
+	// 次のシーン名
+	std::string nextSceneName_;
+
+	// 今のシーンの資産
+	SceneAssetManifest sceneAssets_;
+
 	// シーンファクトリー
 	AbstractSceneFactory* sceneFactory_ = nullptr;
 };
@@ -36,10 +36,10 @@ Matrix4x4 Matrix4x4::RotateXMatrix(float _radian)
     Matrix4x4 result{};
 
     result.m[0][0] = 1.0f;
-    result.m[1][1] = std::cosf(_radian);
-    result.m[1][2] = std::sinf(_radian);
-    result.m[2][1] = -std::sinf(_radian);
-    result.m[2][2] = std::cosf(_radian);
+    result.m[1][1] = std::cos(_radian);
+    result.m[1][2] = std::sin(_radian);
+    result.m[2][1] = -std::sin(_radian);
+    result.m[2][2] = std::cos(_radian);
     result.m[3][3] = 1.0f;
 
     return result;
@@ -51,10 +51,10 @@ Matrix4x4 Matrix4x4::RotateYMatrix(float _radian)
 
     result.m[1][1] = 1.0f;
     result.m[3][3] = 1.0f;
-    result.m[0][0] = std::cosf(_radian);
-    result.m[0][2] = -std::sinf(_radian);
-    result.m[2][0] = std::sinf(_radian);
-    result.m[2][2] = std::cosf(_radian);
+    result.m[0][0] = std::cos(_radian);
+    result.m[0][2] = -std::sin(_radian);
+    result.m[2][0] = std::sin(_radian);
+    result.m[2][2] = std::cos(_radian);
 
     return result;
 }
@@ -17,7 +17,7 @@ float Vector2::Cross(const Vector2& _v) const
 
 float Vector2::Length() const
 {
-    return std::sqrtf(x * x + y * y);
+    return std::sqrt(x * x + y * y);
 }
 
 float Vector2::LengthWithoutRoot() const
@@ -67,8 +67,8 @@ float Vector2::Theta(const Vector2& _origin) const
 Vector2 Vector2::Rotated(float _theta) const
 {
     Vector2 result = {};
-    result.x = x * std::cosf(_theta) - y * std::sinf(_theta);
-    result.y = x * std::sinf(_theta) + y * std::cosf(_theta);
+    result.x = x * std::cos(_theta) - y * std::sin(_theta);
+    result.y = x * std::sin(_theta) + y * std::cos(_theta);
     return result;
 }
 
@@ -28,7 +28,7 @@ Vector3 Vector3::Cross(const Vector3& _v) const
 
 float Vector3::Length() const
 {
-    return std::sqrtf(x * x + y * y + z * z);
+    return std::sqrt(x * x + y * y + z * z);
 }
 
 float Vector3::LengthWithoutRoot() const
@@ -1,6 +1,56 @@
 #include "MeshBuilder.h"
 
 #include <numbers>
+#include <functional>
+
+std::unordered_map<std::string, std::unique_ptr<Model>> MeshBuilder::meshCache_;
+
+bool MeshBuilder::Build(const std::string& shape, Model* model)
+{
+    // 作成済みならバッファを共有するだけ
+    auto cached = meshCache_.find(shape);
+    if (cached != meshCache_.end())
+    {
+        model->ShareMesh(*cached->second);
+        return true;
+    }
+
+    using BuildFunc = std::function<void(Model*)>;
+
+    static const std::unordered_map<std::string, BuildFunc> shapeBuilders = {
+        { "Ring",     BuildRing },
+        { "Cylinder", BuildCylinder },
+        { "Cone",     BuildCone },
+        { "Spiral",   BuildSpiral },
+        { "Torus",    BuildTorus },
+        { "Helix",    BuildHelix },
+        { "Sphere",   BuildSphere },
+        { "Triangle", BuildTriangle },
+        { "Petal",    BuildPetal },
+        { "Cube",     BuildCube },
+        { "Line",     BuildLine },
+    };
+
+    auto it = shapeBuilders.find(shape);
+    if (it == shapeBuilders.end())
+    {
+        return false;
+    }
+
+    it->second(model);
+
+    // 次回以降のために共有元として残す
+    std::unique_ptr<Model> mesh = std::make_unique<Model>();
+    mesh->ShareMesh(*model);
+    meshCache_[shape] = std::move(mesh);
+
+    return true;
+}
+
+void MeshBuilder::ClearCache()
+{
+    meshCache_.clear();
+}
 
 void MeshBuilder::BuildRing(Model* model)
 {
@@ -10,6 +60,7 @@ void MeshBuilder::BuildRing(Model* model)
     const float kOuterRadius = 1.0f;
     const float kInnerRadius = 0.2f;
     const float radianPerDivide = 2.0f * std::numbers::pi_v<float> / float(kRingDivide);
+    model->ReserveMesh(kRingDivide * 6, kRingDivide * 6);
 
     for (uint32_t index = 0; index < kRingDivide; ++index)
     {
@@ -51,6 +102,7 @@ void MeshBuilder::BuildCylinder(Model* model)
     const float kRadius = 1.0f;
     const float kHeight = 3.0f;
     const float radianPerDivide = 2.0f * std::numbers::pi_v<float> / float(kDivide);
+    model->ReserveMesh(kDivide * 6, kDivide * 6);
 
     for (uint32_t i = 0; i < kDivide; ++i)
     {
@@ -96,6 +148,7 @@ void MeshBuilder::BuildCone(Model* model)
     const float kRadius = 1.0f;
     const float kHeight = 3.0f;
     const float radianPerDivide = 2.0f * std::numbers::pi_v<float> / float(kDivide);
+    model->ReserveMesh(1 + kDivide * 2, kDivide * 3);
 
     Vector3 apex = { 0.0f, +kHeight * 0.5f, 0.0f };     // 頂点：上に1.5
     uint32_t apexIndex = model->GetVertexCount();
@@ -133,6 +186,7 @@ void MeshBuilder::BuildSpiral(Model* model)
     const float kWidth = 1.0f;            // 長方形の幅（X方向）
     const float kHeight = 5.0f;           // 長方形の高さ（Z方向）
     const float kTwist = 3.0f * std::numbers::pi_v<float>; // ねじれ量（ラジアン）
+    model->ReserveMesh((kDivisions + 1) * 2, kDivisions * 6);
 
     for (uint32_t i = 0; i <= kDivisions; ++i) 
     {
@@ -178,6 +232,7 @@ void MeshBuilder::BuildTorus(Model* model)
     const uint32_t kCircleDiv = 32;
     const float kOuterR = 1.5f;
     const float kInnerR = 0.4f;
+    model->ReserveMesh(kCircleDiv * kTubeDiv * 4, kCircleDiv * kTubeDiv * 6);
 
     for (uint32_t i = 0; i < kCircleDiv; ++i)
     {
@@ -230,6 +285,7 @@ void MeshBuilder::BuildHelix(Model* model)
     const float kHeight = 5.0f;
     const uint32_t kTurns = 5;
     const float kWidth = 0.05f;
+    model->ReserveMesh(kSegments * 4, kSegments * 6);
 
     for (uint32_t i = 0; i < kSegments; ++i)
     {
@@ -282,6 +338,7 @@ void MeshBuilder::BuildSphere(Model* model)
     const uint32_t kLatitude = 16;   // 緯度分割数
     const uint32_t kLongitude = 32;  // 経度分割数
     const float kRadius = 0.1f;
+    model->ReserveMesh((kLatitude + 1) * (kLongitude + 1), kLatitude * kLongitude * 6);
 
     for (uint32_t lat = 0; lat <= kLatitude; ++lat)
     {
@@ -335,9 +392,11 @@ void MeshBuilder::BuildPetal(Model* model)
     const float bulge = 0.18f;      // 側面のふくらみ
     const float tipSplit = 0.08f;   // 先端の割れ
     const float tipBulge = 0.10f;   // 先端のふくらみ
+    model->ReserveMesh(1 + (kDiv + 1), kDiv * 3);
 
     // 頂点リスト
     std::vector<uint32_t> edgeIndices;
+    edgeIndices.reserve(kDiv + 1);
 
     // 根元の中心
     uint32_t centerIdx = model->GetVertexCount();
@@ -398,6 +457,7 @@ void MeshBuilder::BuildPetal(Model* model)
 void MeshBuilder::BuildTriangle(Model* model)
 {
     model->ClearVertexData();
+    model->ReserveMesh(3, 3);
 
     // XY平面上の正三角形
     float scale = 1.0f; // 拡大率
@@ -422,6 +482,7 @@ void MeshBuilder::BuildTriangle(Model* model)
 void MeshBuilder::BuildCube(Model* model)
 {
     model->ClearVertexData();
+    model->ReserveMesh(6 * 4, 6 * 6);
 
     // 1辺0.2fの立方体（中心原点）
     const float h = 1.0f;
@@ -495,6 +556,7 @@ void MeshBuilder::BuildCube(Model* model)
 void MeshBuilder::BuildLine(Model* model)
 {
 	model->ClearVertexData();
+	model->ReserveMesh(2, 2);
 
 	// 原点からY軸方向に1.0fの線分
 	Vector3 start = { 0.0f, 0.0f, 0.0f };
@@ -2,6 +2,10 @@
 
 #include <Model.h>
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 /// <summary>
 /// メッシュ作成クラス
 /// メッシュを頂点とインデックスで作成する
@@ -10,6 +14,20 @@ class MeshBuilder
 {
 public:
 
+	/// <summary>
+	/// 形状名からメッシュを作成
+	/// 同じ形状は一度だけ作り、以降は作成済みのバッファを共有する
+	/// </summary>
+	/// <param name="shape">形状名("Ring", "Cylinder"など)</param>
+	/// <param name="model">モデルポインタ</param>
+	/// <returns>形状名が登録されていたか</returns>
+	static bool Build(const std::string& shape, Model* model);
+
+	/// <summary>
+	/// 作成済みメッシュの破棄
+	/// </summary>
+	static void ClearCache();
+
 	/// <summary>
 	/// Ring作成(円状)
 	/// </summary>
@@ -76,5 +94,10 @@ public:
 	/// <param name="model">モデルポインタ</param>
 	static void BuildLine(Model* model);
 
+private:
+
+	// 作成済みメッシュ(形状ごとのパラメータは固定なので形状名で引く)
+	static std::unordered_map<std::string, std::unique_ptr<Model>> meshCache_;
+
 };
 
@@ -0,0 +1,142 @@
+#include "ParticleBenchmark.h"
+
+#include <chrono>
+#include <fstream>
+#include <algorithm>
+
+#include "ParticleSystem.h"
+#include "ParticleMotion.h"
+#include "ParticleEmitLog.h"
+
+#include "json/json.hpp"
+
+const Vector3 ParticleBenchmark::kCameraPosition_ = { 0.0f, 5.0f, -30.0f };
+
+bool ParticleBenchmark::Run(const Setting& setting, const std::string& outputFilePath)
+{
+	// モーションが未登録なら登録する
+	if (ParticleMotion::GetAll().empty())
+	{
+		ParticleMotion::Initialize();
+	}
+
+	const Vector3& cameraPosition = kCameraPosition_;
+	const Matrix4x4 viewMatrix = MakeViewMatrix();
+	const Matrix4x4 projectionMatrix = MakeProjectionMatrix();
+	const float deltaTime = ParticleSystem::GetFixedDeltaTime();
+
+	nlohmann::json results = nlohmann::json::array();
+
+	// 指定が無ければ全モーションを、出力順を固定するため名前順に回す
+	std::vector<std::string> motionNames = setting.motionNames;
+	if (motionNames.empty())
+	{
+		for (const auto& [name, func] : ParticleMotion::GetAll())
+		{
+			motionNames.push_back(name);
+		}
+		std::sort(motionNames.begin(), motionNames.end());
+	}
+	for (const std::string& motionName : motionNames)
+	{
+		if (!ParticleMotion::GetAll().contains(motionName))
+		{
+			return false;
+		}
+	}
+
+	for (const std::string& motionName : motionNames)
+	{
+		for (uint32_t particleCount : setting.particleCounts)
+		{
+			ParticleSystem system;
+			system.Seed(setting.seed);
+			system.SetAdaptiveLoad(false);
+			system.SetParticleBudget(particleCount);
+			system.CreateGroup(motionName, motionName, particleCount);
+
+			float totalMs = 0.0f;
+			float minMs = 0.0f;
+			float maxMs = 0.0f;
+			uint64_t totalParticles = 0;
+			uint64_t totalInstances = 0;
+
+			for (uint32_t frame = 0; frame < setting.warmupFrames + setting.frames; ++frame)
+			{
+				// 寿命で減った分を補充して粒子数を保つ
+				system.Emit(motionName, { 0.0f,0.0f,0.0f }, particleCount - system.GetTotalParticleCount());
+
+				const auto start = std::chrono::steady_clock::now();
+				system.Update(deltaTime, viewMatrix, projectionMatrix, cameraPosition);
+				const float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+				if (frame < setting.warmupFrames)
+				{
+					continue;
+				}
+
+				minMs = totalMs == 0.0f ? ms : std::min(minMs, ms);
+				maxMs = std::max(maxMs, ms);
+				totalMs += ms;
+				totalParticles += system.GetTotalParticleCount();
+				totalInstances += system.GetTotalInstanceCount();
+			}
+
+			const float frames = static_cast<float>(std::max(setting.frames, 1u));
+			const float averageMs = totalMs / frames;
+			const float averageParticles = static_cast<float>(totalParticles) / frames;
+
+			results.push_back({
+				{ "motion", motionName },
+				{ "particleCount", particleCount },
+				{ "averageMs", averageMs },
+				{ "minMs", minMs },
+				{ "maxMs", maxMs },
+				{ "averageParticles", averageParticles },
+				{ "averageInstances", static_cast<float>(totalInstances) / frames },
+				{ "nsPerParticle", averageParticles > 0.0f ? averageMs * 1000000.0f / averageParticles : 0.0f },
+				});
+		}
+	}
+
+	nlohmann::json json;
+	json["seed"] = setting.seed;
+	json["warmupFrames"] = setting.warmupFrames;
+	json["frames"] = setting.frames;
+	json["results"] = std::move(results);
+
+	std::ofstream file(outputFilePath);
+	if (file.fail())
+	{
+		return false;
+	}
+	file << json.dump(1, '\t');
+	return true;
+}
+
+bool ParticleBenchmark::Replay(const std::string& logFilePath, const std::string& reportFilePath)
+{
+	// モーションが未登録なら登録する
+	if (ParticleMotion::GetAll().empty())
+	{
+		ParticleMotion::Initialize();
+	}
+
+	ParticleEmitLog log;
+	if (!log.Load(logFilePath))
+	{
+		return false;
+	}
+
+	return ParticleSystem::Replay(log, MakeViewMatrix(), MakeProjectionMatrix(), kCameraPosition_, reportFilePath);
+}
+
+Matrix4x4 ParticleBenchmark::MakeViewMatrix()
+{
+	return Inverse(MakeAffineMatrix({ 1.0f,1.0f,1.0f }, { 0.15f,0.0f,0.0f }, kCameraPosition_));
+}
+
+Matrix4x4 ParticleBenchmark::MakeProjectionMatrix()
+{
+	return MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 1000.0f);
+}
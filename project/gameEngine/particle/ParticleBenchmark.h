@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MyMath.h"
+
+/// <summary>
+/// パーティクルシミュレーションの計測
+/// 登録済みの全モーションを複数の粒子数で回し、結果をJSONに書き出す
+/// 記録したエミットの再生も同じ固定カメラで行う
+/// ParticleSystemだけを使うので描画デバイスが無くても動く
+/// </summary>
+class ParticleBenchmark
+{
+public:
+
+	// 計測設定
+	struct Setting
+	{
+		// 計測するモーション(空なら登録済みの全モーション)
+		std::vector<std::string> motionNames;
+		// 計測する粒子数
+		std::vector<uint32_t> particleCounts = { 256, 1024, 4096, 16384 };
+		// 計測前に回すフレーム数
+		uint32_t warmupFrames = 30;
+		// 計測するフレーム数
+		uint32_t frames = 240;
+		// 乱数シード
+		uint32_t seed = 0;
+	};
+
+	/// <summary>
+	/// 計測を実行してJSONに書き出す
+	/// </summary>
+	/// <param name="setting">計測設定</param>
+	/// <param name="outputFilePath">出力先</param>
+	/// <returns>書き出せたか(未登録のモーションを指定した場合もfalse)</returns>
+	static bool Run(const Setting& setting, const std::string& outputFilePath);
+
+	/// <summary>
+	/// 記録したエミットを固定カメラで再生し、結果をJSONに書き出す
+	/// </summary>
+	/// <param name="logFilePath">エミット記録(ParticleEmitLog)</param>
+	/// <param name="reportFilePath">出力先</param>
+	/// <returns>読み込みと書き出しができたか</returns>
+	static bool Replay(const std::string& logFilePath, const std::string& reportFilePath);
+
+private:
+
+	// 固定カメラ(原点を少し引いた位置から見る)
+	static const Vector3 kCameraPosition_;
+	static Matrix4x4 MakeViewMatrix();
+	static Matrix4x4 MakeProjectionMatrix();
+};
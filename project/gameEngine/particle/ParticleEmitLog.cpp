@@ -0,0 +1,111 @@
+#include "ParticleEmitLog.h"
+
+#include <fstream>
+#include <algorithm>
+
+#include "json/json.hpp"
+
+void ParticleEmitLog::Clear()
+{
+	seed_ = 0;
+	frameCount_ = 0;
+	particleBudget_ = 4096;
+	records_.clear();
+	groups_.clear();
+}
+
+void ParticleEmitLog::Add(uint32_t frame, const std::string& groupName, const Vector3& position, uint32_t count)
+{
+	records_.push_back({ frame, groupName, position, count });
+
+	if (frame + 1 > frameCount_)
+	{
+		frameCount_ = frame + 1;
+	}
+}
+
+void ParticleEmitLog::AddGroup(const EmitGroupRecord& group)
+{
+	auto it = std::find_if(groups_.begin(), groups_.end(), [&](const EmitGroupRecord& g) { return g.groupName == group.groupName; });
+	if (it != groups_.end())
+	{
+		*it = group;
+		return;
+	}
+
+	groups_.push_back(group);
+}
+
+bool ParticleEmitLog::Save(const std::string& filePath) const
+{
+	std::ofstream file(filePath);
+	if (file.fail())
+	{
+		return false;
+	}
+
+	nlohmann::json json;
+	json["seed"] = seed_;
+	json["frameCount"] = frameCount_;
+	json["particleBudget"] = particleBudget_;
+	json["groups"] = nlohmann::json::array();
+	for (const auto& group : groups_)
+	{
+		json["groups"].push_back({
+			{ "group", group.groupName },
+			{ "motion", group.motionName },
+			{ "maxInstanceCount", group.maxInstanceCount },
+			{ "priority", group.priority },
+			});
+	}
+	json["records"] = nlohmann::json::array();
+	for (const auto& record : records_)
+	{
+		json["records"].push_back({
+			{ "frame", record.frame },
+			{ "group", record.groupName },
+			{ "position", { record.position.x, record.position.y, record.position.z } },
+			{ "count", record.count },
+			});
+	}
+
+	file << json.dump(1, '\t');
+	return true;
+}
+
+bool ParticleEmitLog::Load(const std::string& filePath)
+{
+	std::ifstream file(filePath);
+	if (file.fail())
+	{
+		return false;
+	}
+
+	nlohmann::json json;
+	file >> json;
+	if (!json.is_object() or !json.contains("records"))
+	{
+		return false;
+	}
+
+	Clear();
+	seed_ = json.value("seed", 0u);
+	particleBudget_ = json.value("particleBudget", particleBudget_);
+	if (json.contains("groups"))
+	{
+		for (const auto& group : json["groups"])
+		{
+			AddGroup({ group["group"].get<std::string>(), group["motion"].get<std::string>(),
+				group.value("maxInstanceCount", 1024u), group.value("priority", 0.5f) });
+		}
+	}
+	for (const auto& record : json["records"])
+	{
+		const auto& p = record["position"];
+		Add(record["frame"].get<uint32_t>(), record["group"].get<std::string>(),
+			Vector3(p[0].get<float>(), p[1].get<float>(), p[2].get<float>()), record["count"].get<uint32_t>());
+	}
+	frameCount_ = std::max(frameCount_, json.value("frameCount", 0u));
+
+	return true;
+}
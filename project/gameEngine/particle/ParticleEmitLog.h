@@ -0,0 +1,104 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "MyMath.h"
+
+// 記録したエミット1回分
+struct EmitRecord
+{
+	uint32_t frame = 0;
+	std::string groupName;
+	Vector3 position;
+	uint32_t count = 0;
+};
+
+// 記録したグループ1つ分(再生側で同じグループを作るため)
+struct EmitGroupRecord
+{
+	std::string groupName;
+	std::string motionName;
+	uint32_t maxInstanceCount = 0;
+	float priority = 0.5f;
+};
+
+/// <summary>
+/// パーティクルのエミット記録
+/// 記録、保存、読み込みを行う(再生はParticleSystemで行う)
+/// </summary>
+class ParticleEmitLog
+{
+public:
+
+	/// <summary>
+	/// 記録を全て消す
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// エミットを記録
+	/// </summary>
+	/// <param name="frame">フレーム番号</param>
+	/// <param name="groupName">グループ名</param>
+	/// <param name="position">発生位置</param>
+	/// <param name="count">発生数</param>
+	void Add(uint32_t frame, const std::string& groupName, const Vector3& position, uint32_t count);
+
+	/// <summary>
+	/// グループを記録(既にあれば上書き)
+	/// </summary>
+	/// <param name="group">グループ</param>
+	void AddGroup(const EmitGroupRecord& group);
+
+	/// <summary>
+	/// JSONに保存
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>成功したか</returns>
+	bool Save(const std::string& filePath) const;
+
+	/// <summary>
+	/// JSONから読み込み
+	/// </summary>
+	/// <param name="filePath">ファイルパス</param>
+	/// <returns>成功したか</returns>
+	bool Load(const std::string& filePath);
+
+public: // セッター
+
+	// 乱数シード
+	void SetSeed(uint32_t seed) { seed_ = seed; }
+
+	// 記録したフレーム数
+	void SetFrameCount(uint32_t frameCount) { frameCount_ = frameCount; }
+
+	// 全体のパーティクル上限
+	void SetParticleBudget(uint32_t budget) { particleBudget_ = budget; }
+
+public: // ゲッター
+
+	// 乱数シード
+	uint32_t GetSeed() const { return seed_; }
+
+	// 記録したフレーム数
+	uint32_t GetFrameCount() const { return frameCount_; }
+
+	// 全体のパーティクル上限
+	uint32_t GetParticleBudget() const { return particleBudget_; }
+
+	// 記録一覧(フレーム順)
+	const std::vector<EmitRecord>& GetRecords() const { return records_; }
+
+	// グループ一覧
+	const std::vector<EmitGroupRecord>& GetGroups() const { return groups_; }
+
+private:
+
+	uint32_t seed_ = 0;
+	uint32_t frameCount_ = 0;
+	uint32_t particleBudget_ = 4096;
+	std::vector<EmitRecord> records_;
+	std::vector<EmitGroupRecord> groups_;
+};
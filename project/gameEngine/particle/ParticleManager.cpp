@@ -5,11 +5,17 @@
 #include <vector>
 #include <random>
 #include <numbers>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
 #include <MyMath.h>
 
 #include "Object3dCommon.h"
 #include "ModelManager.h"
 #include "TimeManager.h"
+#include "ParticleBenchmark.h"
+
+#include "../../externals/json/json.hpp"
 
 ParticleManager* ParticleManager::GetInstance()
 {
@@ -24,7 +30,7 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     modelCommon_ = modelCommon;
     object3dCommon_ = Object3dCommon::GetInstance();
     // ランダムエンジンの初期化
-    randomEngine_ = std::mt19937{ std::random_device{}() };
+    system_.Seed(std::random_device{}());
 
     // モーション登録
 	ParticleMotion::Initialize();
@@ -37,9 +43,6 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
 
     transform_ = { {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f},{0.0f,0.0f,0.0f} };
 
-    // ビルボード行列の作成
-    backToFrontMatrix_ = MakeRotateYMatrix(std::numbers::pi_v<float>);
-
     //マテリアル
     //modelマテリアる用のリソースを作る。今回color1つ分のサイズを用意する
     materialResource_ = dxCommon_->CreateBufferResource(sizeof(Material));
@@ -52,9 +55,21 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
     materialData_->uvTransform = MakeIdentity4x4();
 
     camera_ = object3dCommon_->GetDefaultCamera();
+
+    // 起動時からエミットを記録する設定(再生はツールのParticleBenchmarkで行う)
+    LoadRecordingSetting("resources/configs/particleRecording.json");
 }
 
-void ParticleManager::Finalize(){}
+void ParticleManager::Finalize()
+{
+    // 指定フレーム数に届く前に終了した場合も、そこまでの記録は残す
+    if (recordingSetting_.isEnabled && system_.IsRecording())
+    {
+        FinishRecording();
+    }
+
+    MeshBuilder::ClearCache();
+}
 
 void ParticleManager::CreatePipeline()
 {
@@ -202,30 +217,31 @@ void ParticleManager::CreateRootSignature()
 
 void ParticleManager::CreateParticleGroup(const std::string& name, const std::string& textureFilePath, const std::string& modelFilePath, const std::string& type, const std::string& motionName)
 {
-    ModelManager::GetInstance()->LoadModel(modelFilePath);
-
-    std::unique_ptr<Model> model = std::make_unique<Model>();
-    model->Initialize(modelCommon_, "resources/models", modelFilePath);
-    models_[name] = std::move(model);
-
+    // 作成済みなら何もしない(モデルやSRVを作り直して増やさない)
     if (particleGroups.contains(name))
     {
         return;
     }
 
+    // グループ専用のモデル(頂点はMeshBuilderで形状ごとのものに差し替える)
+    std::unique_ptr<Model> model = std::make_unique<Model>();
+    model->Initialize(modelCommon_, "resources/models", modelFilePath);
+    models_[name] = std::move(model);
+
     // パーティクルグループを作成、コンテナに登録
     ParticleGroup newGroup = {};
-    newGroup.motionName = motionName;
+    system_.CreateGroup(name, motionName, kMaxInstanceCount_);
     particleGroups.insert(std::make_pair(name, std::move(newGroup)));
 
     // テクスチャファイルパスを登録
     particleGroups.at(name).materialData.textureFilePath = textureFilePath;
-    // テクスチャを読み込んでSRVを生成
-    TextureManager::GetInstance()->LoadTexture(textureFilePath);
+    // テクスチャの参照を取得(グループの破棄で手放す)
+    TextureManager::GetInstance()->AcquireTexture(textureFilePath);
+    particleGroups.at(name).isSceneGroup = isSceneScope_;
     // SRVインデックスを登録
     particleGroups.at(name).materialData.textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
     // 最大数インスタンス
-    uint32_t MaxInstanceCount = 1024;
+    uint32_t MaxInstanceCount = kMaxInstanceCount_;
     // インスタンス数を初期化
     particleGroups.at(name).instanceCount = 0;
     // インスタンス用リソースを生成
@@ -252,107 +268,73 @@ void ParticleManager::CreateParticleGroup(const std::string& name, const std::st
     // srvを生成
     srvManager_->CreateSRVforStructuredBuffer(particleGroups.at(name).srvIndex, particleGroups.at(name).instancingResource.Get(), MaxInstanceCount, sizeof(ParticleForGPU));
 
-    // モデルの頂点を構築
-    using BuildFunc = std::function<void(Model*)>;
-
-    static const std::unordered_map<std::string, BuildFunc> shapeBuilders = {
-        { "Ring",     MeshBuilder::BuildRing },
-        { "Cylinder", MeshBuilder::BuildCylinder },
-        { "Cone",     MeshBuilder::BuildCone },
-        { "Spiral",   MeshBuilder::BuildSpiral },
-        { "Torus",    MeshBuilder::BuildTorus },
-        { "Helix",    MeshBuilder::BuildHelix },
-        { "Sphere",   MeshBuilder::BuildSphere },
-        { "Triangle", MeshBuilder::BuildTriangle },
-        { "Petal",    MeshBuilder::BuildPetal},
-		{ "Cube",     MeshBuilder::BuildCube },
-		{ "Line",     MeshBuilder::BuildLine },
-    };
-
-    // モデル構築後に呼ぶ
-    auto it = shapeBuilders.find(type);
-    if (it != shapeBuilders.end())
+    // モデルの頂点を構築(同じ形状は作成済みのバッファを共有する)
+    MeshBuilder::Build(type, models_[name].get());
+}
+
+void ParticleManager::DestroyParticleGroup(const std::string& name)
+{
+    auto it = particleGroups.find(name);
+    if (it == particleGroups.end())
     {
-        it->second(models_[name].get());
+        return;
     }
+
+    // 描画は毎フレームGPUの完了を待っているので、ここで解放しても参照中のものは無い
+    srvManager_->Free(it->second.srvIndex);
+    TextureManager::GetInstance()->ReleaseTexture(it->second.materialData.textureFilePath);
+    particleGroups.erase(it);
+    models_.erase(name);
+    system_.DestroyGroup(name);
+
+    // このグループへのループエミットも止める
+    std::erase_if(emitSettings_, [&name](const EmitSetting& setting) { return setting.groupName == name; });
+}
+
+void ParticleManager::DestroySceneParticleGroups()
+{
+    std::vector<std::string> sceneGroupNames;
+    for (const auto& [name, group] : particleGroups)
+    {
+        if (group.isSceneGroup)
+        {
+            sceneGroupNames.push_back(name);
+        }
+    }
+
+    for (const std::string& name : sceneGroupNames)
+    {
+        DestroyParticleGroup(name);
+    }
+
+    isSceneScope_ = false;
 }
 
 void ParticleManager::Update()
 {
-	// TimeManagerからデルタタイムを取得
-	const float dt = TimeManager::Instance().GetDeltaTime();
+	// TimeManagerからデルタタイムを取得(決定論モードは固定値)
+	const float dt = system_.IsDeterministic() ? ParticleSystem::GetFixedDeltaTime() : TimeManager::Instance().GetDeltaTime();
 	
     camera_ = object3dCommon_->GetDefaultCamera();
 
-    Matrix4x4 viewMatrix = camera_->GetViewMatrix();
-    Matrix4x4 projectionMatrix = camera_->GetProjectionMatrix();
-    Matrix4x4 billboardMatrix = backToFrontMatrix_ * viewMatrix;
-    billboardMatrix.m[3][0] = 0.0f;
-    billboardMatrix.m[3][1] = 0.0f;
-    billboardMatrix.m[3][2] = 0.0f;
-
-    if (std::isnan(billboardMatrix.m[0][0]) || std::isinf(billboardMatrix.m[0][0])) {
-        Logger::Log("billboardMatrix に異常な値が含まれています！");
-    }
+    // シミュレーション
+    system_.Update(dt, camera_->GetViewMatrix(), camera_->GetProjectionMatrix(), camera_->GetPosition());
 
-    for (auto& [name, Particlegroup] : particleGroups)
+    // 描画するインスタンスだけをGPUのバッファに書き込む
+    for (auto& [name, particleGroup] : particleGroups)
     {
-        uint32_t count = 0;
-        // 各パーティクルの処理
-        for (auto it = Particlegroup.particleList.begin(); it != Particlegroup.particleList.end();)
+        const ParticleSystem::Group* group = system_.FindGroup(name);
+        particleGroup.instanceCount = group ? group->instanceCount : 0;
+        if (particleGroup.instanceCount > 0)
         {
-            // 寿命が終わったパーティクルを削除
-            if ((*it).currentTime >= (*it).lifeTime)
-            {
-                it = Particlegroup.particleList.erase(it);
-                continue;
-            }
-
-            // パーティクルの位置を更新
-            (*it).transform.translate += (*it).velocity * dt;
-            // パーティクルの回転を更新
-            (*it).transform.rotate += (*it).angularVelocity * dt;
-            // パーティクルのスケールを更新
-            (*it).transform.scale += (*it).scaleVelocity * dt;
-            // パーティクルの寿命
-            (*it).currentTime += dt;
-            float alpha = 1.0f - ((*it).currentTime / (*it).lifeTime);
-
-            // アルファ値をパーティクルの色に適用
-            (*it).color.w = alpha;
-
-
-            // SRTからTranslateを分離
-            Matrix4x4 SR =
-                MakeScaleMatrix((*it).transform.scale) *
-                MakeRotateXMatrix((*it).transform.rotate.x) *
-                MakeRotateYMatrix((*it).transform.rotate.y) *
-                MakeRotateZMatrix((*it).transform.rotate.z);
-
-            // ビルボード行列をSRに掛ける
-            Matrix4x4 billboardSR = SR * billboardMatrix;
-
-            // 最後にTranslateを掛ける
-            Matrix4x4 worldMatrix = billboardSR * MakeTranslateMatrix((*it).transform.translate);
-
-            Matrix4x4 wVPMatrix = worldMatrix * viewMatrix * projectionMatrix;
-
-            // SRVバッファの最大数に安全チェック
-            if (count < 1024)
-            { 
-                Particlegroup.instancingData[count].WVP = wVPMatrix;
-                Particlegroup.instancingData[count].world = worldMatrix;
-                Particlegroup.instancingData[count].color = it->color;
-                ++count;
-            }
-
-
-            // 次のパーティクルへ
-            ++it;
+            std::memcpy(particleGroup.instancingData, group->instances.data(), sizeof(ParticleForGPU) * particleGroup.instanceCount);
         }
+    }
 
-        Particlegroup.instanceCount = count;
-
+    // 設定したフレーム数を記録したら書き出す
+    if (recordingSetting_.isEnabled && system_.IsRecording() && system_.GetRecordedFrameCount() >= recordingSetting_.frameCount)
+    {
+        FinishRecording();
     }
 
     for (auto& setting : emitSettings_)
@@ -373,43 +355,46 @@ void ParticleManager::Draw()
         return;
     }
 
-    // 共通設定
-    dxCommon_->GetCommandList()->SetGraphicsRootSignature(rootSignature_.Get());
-    dxCommon_->GetCommandList()->SetPipelineState(pipelineState_.Get());
-    dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-    for (const auto& [name, ParticleGroup] : particleGroups)
-    {
-        if (ParticleGroup.instanceCount == 0) continue;
-
-        // ---- グループごとのモデルを取得 ----
-        Model* model = models_[name].get();
-        assert(model != nullptr);
-        UINT indexCount = static_cast<UINT>(model->GetModelData().indices.size());
-        assert(indexCount < 10000);
-        indexCount;
-
-        // ---- モデルに合わせて Vertex/Index Buffer を設定 ----
-        D3D12_VERTEX_BUFFER_VIEW vbv = model->GetVertexBufferView();
-        D3D12_INDEX_BUFFER_VIEW ibv = model->GetIndexBufferView();
-
-        dxCommon_->GetCommandList()->IASetVertexBuffers(0, 1, &vbv);
-        dxCommon_->GetCommandList()->IASetIndexBuffer(&ibv);
-
-        // ---- マテリアルは共通でも良い（必要なら個別対応可能） ----
-        dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
-
-        // ---- テクスチャとインスタンスSRV（逆にしているかも）----
-        srvManager_->SetGraphicsRootDescriptorTable(1, ParticleGroup.srvIndex); // StructuredBuffer (instancing)
-        srvManager_->SetGraphicsRootDescriptorTable(2, ParticleGroup.materialData.textureIndex); // Texture SRV
-
-        // ---- 描画 ----
-        dxCommon_->GetCommandList()->DrawIndexedInstanced(
-            static_cast<UINT>(model->GetModelData().indices.size()),
-            ParticleGroup.instanceCount,
-            0, 0, 0);
-    }
+    // 3Dオブジェクトの後、スプライトの前に描くようにパーティクルの層に積む
+    dxCommon_->GetRenderQueue().Submit(RenderQueue::MakeKey(RenderQueue::Layer::Particle, 0, 0, 0, 0), [this]()
+        {
+            // 共通設定
+            dxCommon_->GetCommandList()->SetGraphicsRootSignature(rootSignature_.Get());
+            dxCommon_->GetCommandList()->SetPipelineState(pipelineState_.Get());
+            dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
+            for (const auto& [name, ParticleGroup] : particleGroups)
+            {
+                if (ParticleGroup.instanceCount == 0) continue;
+
+                // ---- グループごとのモデルを取得 ----
+                auto modelIt = models_.find(name);
+                assert(modelIt != models_.end());
+                const Model* model = modelIt->second.get();
+                const UINT indexCount = model->GetIndexCount();
+                assert(indexCount < 10000);
+
+                // ---- モデルに合わせて Vertex/Index Buffer を設定 ----
+                D3D12_VERTEX_BUFFER_VIEW vbv = model->GetVertexBufferView();
+                D3D12_INDEX_BUFFER_VIEW ibv = model->GetIndexBufferView();
+
+                dxCommon_->GetCommandList()->IASetVertexBuffers(0, 1, &vbv);
+                dxCommon_->GetCommandList()->IASetIndexBuffer(&ibv);
+
+                // ---- マテリアルは共通でも良い（必要なら個別対応可能） ----
+                dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource_->GetGPUVirtualAddress());
+
+                // ---- テクスチャとインスタンスSRV（逆にしているかも）----
+                srvManager_->SetGraphicsRootDescriptorTable(1, ParticleGroup.srvIndex); // StructuredBuffer (instancing)
+                srvManager_->SetGraphicsRootDescriptorTable(2, ParticleGroup.materialData.textureIndex); // Texture SRV
+
+                // ---- 描画 ----
+                dxCommon_->GetCommandList()->DrawIndexedInstanced(
+                    indexCount,
+                    ParticleGroup.instanceCount,
+                    0, 0, 0);
+            }
+        });
 }
 
 void ParticleManager::Emit(const std::string groupName, const Vector3& position, uint32_t count)
@@ -421,26 +406,60 @@ void ParticleManager::Emit(const std::string groupName, const Vector3& position,
         return;
     }
 
-    EmitSetting newSetting;
-    newSetting.groupName = groupName;
-    newSetting.motionName = it->second.motionName;
-    newSetting.emitCount = count;
-    newSetting.emitPosition = position;
-    newSetting.isLooping = false; // 初期状態はループ無し
-    emitSettings_.push_back(newSetting);
+    // パーティクル生成(間引き、上限、記録はParticleSystem側で行う)
+    system_.Emit(groupName, position, count);
+}
 
+void ParticleManager::ClearParticles()
+{
+    system_.Clear();
+    for (auto& [name, group] : particleGroups)
+    {
+        group.instanceCount = 0;
+    }
+}
+
+void ParticleManager::StartRecording(uint32_t seed)
+{
+    ClearParticles();
+    system_.StartRecording(seed);
+}
 
-    // パーティクル生成
-    ParticleGroup& group = it->second;
-    for (uint32_t i = 0; i < count; ++i)
+void ParticleManager::LoadRecordingSetting(const std::string& filePath)
+{
+    std::ifstream file(filePath);
+    if (file.fail())
     {
-        Particle p = ParticleMotion::Create(group.motionName, randomEngine_, position);
-        p.motionName = group.motionName;
-        group.particleList.push_back(p);
+        return;
     }
 
-    group.instanceCount = static_cast<uint32_t>(group.particleList.size());
+    nlohmann::json json;
+    file >> json;
+    if (!json.is_object())
+    {
+        return;
+    }
+
+    recordingSetting_.isEnabled = json.value("enable", false);
+    recordingSetting_.seed = json.value("seed", 0u);
+    recordingSetting_.frameCount = json.value("frameCount", recordingSetting_.frameCount);
+    recordingSetting_.outputFilePath = json.value("output", recordingSetting_.outputFilePath);
+
+    if (recordingSetting_.isEnabled)
+    {
+        StartRecording(recordingSetting_.seed);
+    }
+}
+
+void ParticleManager::FinishRecording()
+{
+    system_.StopRecording();
+    recordingSetting_.isEnabled = false;
 
+    if (!system_.GetEmitLog().Save(recordingSetting_.outputFilePath))
+    {
+        Logger::Log("パーティクルの記録を書き込めません: " + recordingSetting_.outputFilePath + "\n");
+    }
 }
 
 void ParticleManager::AddEmitterSetting(const EmitSetting& setting)
@@ -507,6 +526,10 @@ void ParticleManager::DebugUI()
             CreateParticleGroup(newGroupName, "resources/images/monsterBall.png", "plane.obj", selectedShape, selectedMotion);
 
         }
+        ImGui::SameLine();
+        if (ImGui::Button("Destroy Group")) {
+            DestroyParticleGroup(newGroupName);
+        }
 
         // --- モーション選択 ---
         if (ImGui::Combo("Motion", &currentMotion, [](void* data, int idx, const char** out_text) {
@@ -520,6 +543,53 @@ void ParticleManager::DebugUI()
 
         ImGui::Separator();
 
+        // 負荷状況
+        ImGui::Text("Particles : %u / %u", system_.GetTotalParticleCount(), system_.GetParticleBudget());
+        ImGui::Text("Update    : %.3f ms (budget %.3f ms)", system_.GetUpdateTimeMs(), system_.GetUpdateTimeBudget());
+        ImGui::Text("LoadScale : %.2f", system_.GetLoadScale());
+
+        ImGui::Separator();
+
+        // 決定論モードとエミット記録
+        static int seed = 0;
+        ImGui::InputInt("Seed", &seed);
+        bool deterministic = system_.IsDeterministic();
+        if (ImGui::Checkbox("Deterministic", &deterministic))
+        {
+            SetDeterministic(deterministic, static_cast<uint32_t>(seed));
+        }
+
+        if (!system_.IsRecording())
+        {
+            if (ImGui::Button("Start Record"))
+            {
+                StartRecording(static_cast<uint32_t>(seed));
+            }
+        }
+        else
+        {
+            ImGui::Text("Recording : %zu emits", system_.GetEmitLog().GetRecords().size());
+            if (ImGui::Button("Stop Record"))
+            {
+                StopRecording();
+                system_.GetEmitLog().Save("particleEmitLog.json");
+            }
+        }
+
+        // 再生は別のParticleSystemで行うので、今出ているパーティクルには影響しない
+        if (ImGui::Button("Replay Log"))
+        {
+            ParticleBenchmark::Replay("particleEmitLog.json", "particleReplayReport.json");
+        }
+
+        // 描画を含まないシミュレーション単体の計測
+        if (ImGui::Button("Run Benchmark"))
+        {
+            ParticleBenchmark::Run(ParticleBenchmark::Setting{}, "particleBenchmark.json");
+        }
+
+        ImGui::Separator();
+
         ImGui::SliderInt("Emit Count", &emitCount, 1, 100);
         ImGui::InputFloat3("Emit Position", reinterpret_cast<float*>(&emitPosition));
 
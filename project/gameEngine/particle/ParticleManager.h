@@ -12,6 +12,8 @@
 
 #include "Particle.h"
 #include "ParticleMotion.h"
+#include "ParticleEmitLog.h"
+#include "ParticleSystem.h"
 #include "MeshBuilder.h"
 #include "ModelCommon.h"
 
@@ -24,24 +26,16 @@ struct MaterialData
 	std::string textureFilePath;
 	uint32_t textureIndex = 0;
 };
-// GPU用パーティクル構造体
-struct ParticleForGPU
-{
-	Matrix4x4 WVP;
-	Matrix4x4 world;
-	Vector4 color;
-};
-
-// パーティクルグループ構造体
+// パーティクルグループ構造体(描画用。シミュレーションはParticleSystem側)
 struct ParticleGroup
 {
 	MaterialData materialData;
-	std::list<Particle> particleList;
 	uint32_t srvIndex;
 	Microsoft::WRL::ComPtr<ID3D12Resource> instancingResource;
 	uint32_t instanceCount = 0;
 	ParticleForGPU* instancingData;
-	std::string motionName = "Homing";
+	// シーンの初期化以降に作ったグループ(シーンの終了で破棄する)
+	bool isSceneGroup = false;
 };
 // エミット設定構造体
 struct EmitSetting {
@@ -96,13 +90,32 @@ public:
 	/// <param name="motionName">動きの名前</param>
 	void CreateParticleGroup(const std::string& name, const std::string& textureFilePath, const std::string& modelFilePath, const std::string& type = "Default", const std::string& motionName = "Homing");
 
+	/// <summary>
+	/// パーティクルグループの破棄
+	/// インスタンス用のSRVとモデルを解放する
+	/// </summary>
+	/// <param name="name">パーティクルグループの名前</param>
+	void DestroyParticleGroup(const std::string& name);
+
+	/// <summary>
+	/// これ以降に作るグループをシーンのものとして扱う(シーンの初期化前に呼ぶ)
+	/// それまでに作ったグループは全シーン共通として残る
+	/// </summary>
+	void BeginSceneParticleGroups() { isSceneScope_ = true; }
+
+	/// <summary>
+	/// シーンのグループをまとめて破棄する(シーンの終了後に呼ぶ)
+	/// インスタンス用のSRV、モデル、テクスチャの参照を手放す
+	/// </summary>
+	void DestroySceneParticleGroups();
+
 	/// <summary>
 	/// 更新
 	/// </summary>
 	void Update();
 
 	/// <summary>
-	/// 描画
+	/// 描画(並べ替えの列のParticleの層に積む)
 	/// </summary>
 	void Draw();
 
@@ -120,6 +133,32 @@ public:
 	/// <param name="setting">エミッター設定</param>
 	void AddEmitterSetting(const EmitSetting& setting);
 
+	/// <summary>
+	/// 決定論モードの切り替え
+	/// 有効中は乱数をシードで初期化し、固定デルタタイムで更新する(負荷による間引きも止める)
+	/// </summary>
+	/// <param name="enable">有効にするか</param>
+	/// <param name="seed">乱数シード</param>
+	void SetDeterministic(bool enable, uint32_t seed = 0) { system_.SetDeterministic(enable, seed); }
+
+	/// <summary>
+	/// エミットの記録開始(決定論モードも有効にする)
+	/// </summary>
+	/// <param name="seed">乱数シード</param>
+	void StartRecording(uint32_t seed);
+
+	/// <summary>
+	/// エミットの記録終了
+	/// </summary>
+	void StopRecording() { system_.StopRecording(); }
+
+	/// <summary>
+	/// 記録設定の読み込み
+	/// 有効なら記録を始め、指定フレーム数で止めてファイルに書き出す
+	/// </summary>
+	/// <param name="filePath">設定ファイル(JSON)</param>
+	void LoadRecordingSetting(const std::string& filePath);
+
 	/// <summary>
 	/// デバッグUI
 	/// </summary>
@@ -133,6 +172,65 @@ public: // セッター
 	/// <param name="camera">カメラ</param>
 	void SetCamera(std::shared_ptr<Camera> camera) { camera_ = camera; }
 
+	/// <summary>
+	/// 全グループ合計のパーティクル上限
+	/// </summary>
+	/// <param name="budget">上限数</param>
+	void SetParticleBudget(uint32_t budget) { system_.SetParticleBudget(budget); }
+
+	/// <summary>
+	/// 更新処理にかけてよい時間(ミリ秒)
+	/// これを超えると発生数と描画数を絞る
+	/// </summary>
+	/// <param name="milliseconds">目標時間</param>
+	void SetUpdateTimeBudget(float milliseconds) { system_.SetUpdateTimeBudget(milliseconds); }
+
+	/// <summary>
+	/// グループの優先度設定
+	/// </summary>
+	/// <param name="groupName">グループ名</param>
+	/// <param name="priority">優先度(0.0f:真っ先に間引く ～ 1.0f:間引かない)</param>
+	void SetGroupPriority(const std::string& groupName, float priority) { system_.SetGroupPriority(groupName, priority); }
+
+	/// <summary>
+	/// 距離による間引きの範囲
+	/// </summary>
+	/// <param name="nearDistance">これより近いと距離による間引きなし</param>
+	/// <param name="farDistance">これより遠いと最大まで間引く</param>
+	void SetLodDistance(float nearDistance, float farDistance) { system_.SetLodDistance(nearDistance, farDistance); }
+
+public: // ゲッター
+
+	// 負荷係数(1.0f:通常 ～ 最大まで間引き中)
+	float GetLoadScale() const { return system_.GetLoadScale(); }
+
+	// 生存中のパーティクル総数
+	uint32_t GetTotalParticleCount() const { return system_.GetTotalParticleCount(); }
+
+	// 直近の更新時間(ミリ秒)
+	float GetUpdateTimeMs() const { return system_.GetUpdateTimeMs(); }
+
+	// シミュレーション本体
+	const ParticleSystem& GetSystem() const { return system_; }
+
+	// 記録したエミット
+	const ParticleEmitLog& GetEmitLog() const { return system_.GetEmitLog(); }
+
+	// 記録中か
+	bool IsRecording() const { return system_.IsRecording(); }
+
+private:
+
+	/// <summary>
+	/// 全パーティクルを消す
+	/// </summary>
+	void ClearParticles();
+
+	/// <summary>
+	/// 記録を止めて設定の出力先に書き出す
+	/// </summary>
+	void FinishRecording();
+
 private: // 構造体
 
 	struct TransformData
@@ -175,6 +273,16 @@ private: // 構造体
 		AABB area;            //!< 範囲
 	};
 
+	// 起動時の記録設定
+	struct RecordingSetting
+	{
+		bool isEnabled = false;
+		uint32_t seed = 0;
+		// 記録するフレーム数
+		uint32_t frameCount = 600;
+		std::string outputFilePath = "particleEmitLog.json";
+	};
+
 	// 頂点データの初期化（座標など）
 	struct Vertex 
 	{
@@ -202,8 +310,8 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature_;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState_;
 
-	// 乱数生成
-	std::mt19937 randomEngine_;
+	// シミュレーション(発生、移動、行列計算、カリング、間引き)
+	ParticleSystem system_;
 
 	//ディスクリプタレンジの生成
 	D3D12_DESCRIPTOR_RANGE descriptorRange_[1]{};
@@ -231,7 +339,6 @@ private:
 	AccelerationField accelerationField_;
 
 	TransformData transform_;
-	Matrix4x4 backToFrontMatrix_;
 	//modelマテリアる用のリソースを作る。今回color1つ分のサイズを用意する
 	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource_;
 	//マテリアルにデータを書き込む	
@@ -248,4 +355,13 @@ private:
 
 	std::vector<EmitSetting> emitSettings_;
 
+	// 1グループあたりの最大インスタンス数
+	static const uint32_t kMaxInstanceCount_ = 1024;
+
+	// シーンの初期化以降か(作ったグループをシーンのものにする)
+	bool isSceneScope_ = false;
+
+	// 起動時の記録設定
+	RecordingSetting recordingSetting_;
+
 };
\ No newline at end of file
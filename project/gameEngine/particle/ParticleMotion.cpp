@@ -157,7 +157,7 @@ Particle ParticleMotion::MakeWiggle(std::mt19937& rand, const Vector3& origin)
 
 Particle ParticleMotion::MakeCylinder(std::mt19937& rand, const Vector3& position)
 {
-    rand;
+    (void)rand;
 
     Particle p;
     p.transform.scale = { 1.0f, 1.0f, 1.0f };
@@ -191,7 +191,7 @@ Particle ParticleMotion::MakeCylinder(std::mt19937& rand, const Vector3& positio
 
 Particle ParticleMotion::MakeSlash(std::mt19937& rand, const Vector3& translate)
 {
-    rand;
+    (void)rand;
     std::uniform_real_distribution<float> scaleDist(0.5f, 1.5f);
     std::uniform_real_distribution<float> rotateDist(-std::numbers::pi_v<float>, std::numbers::pi_v<float>);
 
@@ -227,7 +227,7 @@ Particle ParticleMotion::MakeFlame(std::mt19937& rand, const Vector3& base)
 
 Particle ParticleMotion::MakeMagic1(std::mt19937& rand, const Vector3& translate)
 {
-    rand;
+    (void)rand;
     Particle p;
     p.transform.translate = translate;
     p.transform.rotate = { 0.0f, 0.0f, 3.14f };
@@ -0,0 +1,393 @@
+#include "ParticleSystem.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include "json/json.hpp"
+
+void ParticleSystem::CreateGroup(const std::string& name, const std::string& motionName, uint32_t maxInstanceCount)
+{
+	if (groups_.contains(name))
+	{
+		return;
+	}
+
+	Group group;
+	group.motionName = motionName;
+	group.instances.resize(maxInstanceCount);
+	RecordGroup(name, group);
+	groups_.insert(std::make_pair(name, std::move(group)));
+}
+
+uint32_t ParticleSystem::Emit(const std::string& groupName, const Vector3& position, uint32_t count)
+{
+	auto it = groups_.find(groupName);
+	if (it == groups_.end())
+	{
+		return 0;
+	}
+
+	Group& group = it->second;
+
+	// 記録中なら要求された発生をそのまま残す(間引きは再生時に同じように掛かる)
+	if (isRecording_)
+	{
+		emitLog_.Add(frameIndex_ - recordStartFrame_, groupName, position, count);
+	}
+
+	// 負荷と距離に応じて発生数を絞る(端数は次回に持ち越す)
+	group.emitAccumulator += static_cast<float>(count) * CalculateKeepRate(group, position);
+	count = static_cast<uint32_t>(group.emitAccumulator);
+	group.emitAccumulator -= static_cast<float>(count);
+
+	// 全体の上限を超えないようにする
+	uint32_t remaining = particleBudget_ > totalParticleCount_ ? particleBudget_ - totalParticleCount_ : 0;
+	count = std::min(count, remaining);
+	totalParticleCount_ += count;
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		Particle p = ParticleMotion::Create(group.motionName, randomEngine_, position);
+		p.motionName = group.motionName;
+		group.particleList.push_back(p);
+	}
+
+	return count;
+}
+
+void ParticleSystem::Update(float deltaTime, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition)
+{
+	// 更新時間の計測開始
+	const auto updateStart = std::chrono::steady_clock::now();
+
+	cameraPosition_ = cameraPosition;
+
+	Matrix4x4 billboardMatrix = backToFrontMatrix_ * viewMatrix;
+	billboardMatrix.m[3][0] = 0.0f;
+	billboardMatrix.m[3][1] = 0.0f;
+	billboardMatrix.m[3][2] = 0.0f;
+
+	const Matrix4x4 viewProjectionMatrix = viewMatrix * projectionMatrix;
+
+	totalParticleCount_ = 0;
+	totalInstanceCount_ = 0;
+
+	for (auto& [name, group] : groups_)
+	{
+		uint32_t count = 0;
+		const uint32_t maxInstanceCount = static_cast<uint32_t>(group.instances.size());
+		// 負荷時の間引き用
+		float drawAccumulator = 0.0f;
+
+		for (auto it = group.particleList.begin(); it != group.particleList.end();)
+		{
+			Particle& particle = *it;
+
+			// 寿命が終わったパーティクルを削除
+			if (particle.currentTime >= particle.lifeTime)
+			{
+				it = group.particleList.erase(it);
+				continue;
+			}
+
+			// 位置、回転、スケール、寿命を更新
+			particle.transform.translate += particle.velocity * deltaTime;
+			particle.transform.rotate += particle.angularVelocity * deltaTime;
+			particle.transform.scale += particle.scaleVelocity * deltaTime;
+			particle.currentTime += deltaTime;
+
+			// アルファ値をパーティクルの色に適用
+			particle.color.w = 1.0f - (particle.currentTime / particle.lifeTime);
+
+			++it;
+
+			// 描画枠が埋まっていれば行列は作らない
+			if (count >= maxInstanceCount)
+			{
+				continue;
+			}
+
+			// 視錐台の外なら描画しない
+			if (isCulling_)
+			{
+				const Vector3& t = particle.transform.translate;
+				Vector3 viewPosition = {
+					t.x * viewMatrix.m[0][0] + t.y * viewMatrix.m[1][0] + t.z * viewMatrix.m[2][0] + viewMatrix.m[3][0],
+					t.x * viewMatrix.m[0][1] + t.y * viewMatrix.m[1][1] + t.z * viewMatrix.m[2][1] + viewMatrix.m[3][1],
+					t.x * viewMatrix.m[0][2] + t.y * viewMatrix.m[1][2] + t.z * viewMatrix.m[2][2] + viewMatrix.m[3][2],
+				};
+				const Vector3& s = particle.transform.scale;
+				float radius = std::max({ std::abs(s.x), std::abs(s.y), std::abs(s.z) }) * kCullRadiusScale_;
+				if (!IsVisible(viewPosition, radius, projectionMatrix))
+				{
+					continue;
+				}
+			}
+
+			// 負荷が高いときは遠いものから描画数を減らす
+			if (loadScale_ < 1.0f)
+			{
+				drawAccumulator += CalculateKeepRate(group, particle.transform.translate);
+				if (drawAccumulator < 1.0f)
+				{
+					continue;
+				}
+				drawAccumulator -= 1.0f;
+			}
+
+			// SRからTranslateを分離し、ビルボード行列をSRに掛けてから移動する
+			Matrix4x4 SR =
+				MakeScaleMatrix(particle.transform.scale) *
+				MakeRotateXMatrix(particle.transform.rotate.x) *
+				MakeRotateYMatrix(particle.transform.rotate.y) *
+				MakeRotateZMatrix(particle.transform.rotate.z);
+			Matrix4x4 worldMatrix = (SR * billboardMatrix) * MakeTranslateMatrix(particle.transform.translate);
+
+			ParticleForGPU& instance = group.instances[count];
+			instance.WVP = worldMatrix * viewProjectionMatrix;
+			instance.world = worldMatrix;
+			instance.color = particle.color;
+			++count;
+		}
+
+		group.instanceCount = count;
+		totalParticleCount_ += static_cast<uint32_t>(group.particleList.size());
+		totalInstanceCount_ += count;
+	}
+
+	++frameIndex_;
+
+	// 計測した更新時間から負荷係数を調整
+	// 超えたら素早く絞り、余裕があればゆっくり戻す
+	updateTimeMs_ = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
+	if (!isAdaptiveLoad_)
+	{
+		loadScale_ = 1.0f;
+	}
+	else if (updateTimeMs_ > updateTimeBudgetMs_ or totalParticleCount_ > particleBudget_)
+	{
+		loadScale_ = std::max(kMinLoadScale_, loadScale_ * 0.9f);
+	}
+	else
+	{
+		loadScale_ = std::min(1.0f, loadScale_ + 0.02f);
+	}
+}
+
+void ParticleSystem::Clear()
+{
+	for (auto& [name, group] : groups_)
+	{
+		group.particleList.clear();
+		group.instanceCount = 0;
+		group.emitAccumulator = 0.0f;
+	}
+	totalParticleCount_ = 0;
+	totalInstanceCount_ = 0;
+}
+
+void ParticleSystem::SetDeterministic(bool enable, uint32_t seed)
+{
+	if (enable)
+	{
+		// 通常の乱数の並びを戻せるように、最初に有効にしたときだけ状態を退避する
+		if (!isDeterministic_)
+		{
+			savedRandomEngine_ = randomEngine_;
+		}
+		randomEngine_.seed(seed);
+	}
+	else if (isDeterministic_)
+	{
+		randomEngine_ = savedRandomEngine_;
+	}
+
+	isDeterministic_ = enable;
+
+	// 計測時間は実行ごとに変わるので決定論モードでは負荷による間引きを止める
+	SetAdaptiveLoad(!isDeterministic_);
+}
+
+void ParticleSystem::StartRecording(uint32_t seed)
+{
+	// 記録開始時点の状態を再生側でも作れるように、残っているパーティクルは消す
+	Clear();
+	wasDeterministic_ = isDeterministic_;
+	SetDeterministic(true, seed);
+
+	emitLog_.Clear();
+	emitLog_.SetSeed(seed);
+	emitLog_.SetParticleBudget(particleBudget_);
+	recordStartFrame_ = frameIndex_;
+	isRecording_ = true;
+
+	for (const auto& [name, group] : groups_)
+	{
+		RecordGroup(name, group);
+	}
+}
+
+void ParticleSystem::StopRecording()
+{
+	if (!isRecording_)
+	{
+		return;
+	}
+
+	isRecording_ = false;
+	emitLog_.SetFrameCount(frameIndex_ - recordStartFrame_);
+
+	if (!wasDeterministic_)
+	{
+		SetDeterministic(false);
+	}
+}
+
+bool ParticleSystem::Replay(const ParticleEmitLog& log, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition, const std::string& reportFilePath)
+{
+	// 記録時と同じグループ、上限、シードで作り直す
+	ParticleSystem system;
+	system.SetParticleBudget(log.GetParticleBudget());
+	for (const EmitGroupRecord& group : log.GetGroups())
+	{
+		system.CreateGroup(group.groupName, group.motionName, group.maxInstanceCount);
+		system.SetGroupPriority(group.groupName, group.priority);
+	}
+	system.SetDeterministic(true, log.GetSeed());
+
+	nlohmann::json frames = nlohmann::json::array();
+	float totalUpdateMs = 0.0f;
+	float maxUpdateMs = 0.0f;
+	uint32_t maxParticleCount = 0;
+
+	const auto& records = log.GetRecords();
+	size_t recordIndex = 0;
+	for (uint32_t frame = 0; frame < log.GetFrameCount(); ++frame)
+	{
+		// このフレームのエミットを流し込む(記録はフレーム順)
+		while (recordIndex < records.size() && records[recordIndex].frame == frame)
+		{
+			const EmitRecord& record = records[recordIndex];
+			system.Emit(record.groupName, record.position, record.count);
+			++recordIndex;
+		}
+
+		system.Update(kFixedDeltaTime_, viewMatrix, projectionMatrix, cameraPosition);
+
+		const float updateMs = system.GetUpdateTimeMs();
+		const uint32_t particleCount = system.GetTotalParticleCount();
+
+		frames.push_back({
+			{ "frame", frame },
+			{ "updateMs", updateMs },
+			{ "particles", particleCount },
+			{ "instances", system.GetTotalInstanceCount() },
+			});
+
+		totalUpdateMs += updateMs;
+		maxUpdateMs = std::max(maxUpdateMs, updateMs);
+		maxParticleCount = std::max(maxParticleCount, particleCount);
+	}
+
+	nlohmann::json report;
+	report["seed"] = log.GetSeed();
+	report["frameCount"] = log.GetFrameCount();
+	report["averageUpdateMs"] = log.GetFrameCount() > 0 ? totalUpdateMs / static_cast<float>(log.GetFrameCount()) : 0.0f;
+	report["maxUpdateMs"] = maxUpdateMs;
+	report["maxParticles"] = maxParticleCount;
+	report["frames"] = std::move(frames);
+
+	std::ofstream file(reportFilePath);
+	if (file.fail())
+	{
+		return false;
+	}
+	file << report.dump(1, '\t');
+	return true;
+}
+
+void ParticleSystem::SetAdaptiveLoad(bool enable)
+{
+	isAdaptiveLoad_ = enable;
+	if (!isAdaptiveLoad_)
+	{
+		loadScale_ = 1.0f;
+	}
+}
+
+void ParticleSystem::SetGroupPriority(const std::string& groupName, float priority)
+{
+	auto it = groups_.find(groupName);
+	if (it == groups_.end())
+	{
+		return;
+	}
+
+	it->second.priority = std::clamp(priority, 0.0f, 1.0f);
+	RecordGroup(groupName, it->second);
+}
+
+const ParticleSystem::Group* ParticleSystem::FindGroup(const std::string& name) const
+{
+	auto it = groups_.find(name);
+	return it != groups_.end() ? &it->second : nullptr;
+}
+
+float ParticleSystem::CalculateKeepRate(const Group& group, const Vector3& position) const
+{
+	// 負荷がなければ間引かない
+	if (loadScale_ >= 1.0f)
+	{
+		return 1.0f;
+	}
+
+	// カメラからの距離 (近:0.0f ～ 遠:1.0f)
+	float distanceRate = 0.0f;
+	if (lodFarDistance_ > lodNearDistance_)
+	{
+		float distance = Length(position - cameraPosition_);
+		distanceRate = std::clamp((distance - lodNearDistance_) / (lodFarDistance_ - lodNearDistance_), 0.0f, 1.0f);
+	}
+
+	// 遠いものほど強く間引く
+	float pressure = 1.0f - loadScale_;
+	float keepRate = std::max(kMinKeepRate_, 1.0f - pressure * (1.0f + distanceRate));
+
+	// 優先度が高いほど間引きを弱める
+	return keepRate + (1.0f - keepRate) * group.priority;
+}
+
+bool ParticleSystem::IsVisible(const Vector3& viewPosition, float radius, const Matrix4x4& projectionMatrix) const
+{
+	// カメラの後ろ
+	if (viewPosition.z + radius <= 0.0f)
+	{
+		return false;
+	}
+
+	// 左右と上下の面との距離で判定(面の法線は(±m00, 0, -1)と(0, ±m11, -1)を正規化したもの)
+	const float sx = projectionMatrix.m[0][0];
+	const float sy = projectionMatrix.m[1][1];
+	if (std::abs(viewPosition.x) * sx - viewPosition.z > radius * std::sqrt(sx * sx + 1.0f))
+	{
+		return false;
+	}
+	if (std::abs(viewPosition.y) * sy - viewPosition.z > radius * std::sqrt(sy * sy + 1.0f))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void ParticleSystem::RecordGroup(const std::string& name, const Group& group)
+{
+	if (!isRecording_)
+	{
+		return;
+	}
+
+	emitLog_.AddGroup({ name, group.motionName, static_cast<uint32_t>(group.instances.size()), group.priority });
+}
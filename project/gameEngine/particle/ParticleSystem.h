@@ -0,0 +1,276 @@
+#pragma once
+
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <cstdint>
+#include <numbers>
+
+#include "MyMath.h"
+#include "Particle.h"
+#include "ParticleMotion.h"
+#include "ParticleEmitLog.h"
+
+// GPU用パーティクル構造体
+struct ParticleForGPU
+{
+	Matrix4x4 WVP;
+	Matrix4x4 world;
+	Vector4 color;
+};
+
+/// <summary>
+/// パーティクルのシミュレーション
+/// 発生、移動、行列計算、カリング、負荷による間引き、エミットの記録と再生を行う(描画APIには依存しない)
+/// </summary>
+class ParticleSystem
+{
+public:
+
+	// グループ1つ分のシミュレーション状態
+	struct Group
+	{
+		std::list<Particle> particleList;
+		std::string motionName = "Homing";
+		// 優先度(0.0f:負荷時に真っ先に間引く ～ 1.0f:間引かない)
+		float priority = 0.5f;
+		// 間引き後の発生数の端数
+		float emitAccumulator = 0.0f;
+		// 描画するインスタンス(先頭からinstanceCount個が有効)
+		std::vector<ParticleForGPU> instances;
+		uint32_t instanceCount = 0;
+	};
+
+public:
+
+	/// <summary>
+	/// グループの生成(既にあれば何もしない)
+	/// </summary>
+	/// <param name="name">グループ名</param>
+	/// <param name="motionName">動きの名前</param>
+	/// <param name="maxInstanceCount">描画できる最大数</param>
+	void CreateGroup(const std::string& name, const std::string& motionName, uint32_t maxInstanceCount);
+
+	/// <summary>
+	/// グループの破棄
+	/// </summary>
+	/// <param name="name">グループ名</param>
+	void DestroyGroup(const std::string& name) { groups_.erase(name); }
+
+	/// <summary>
+	/// パーティクルの発生
+	/// </summary>
+	/// <param name="groupName">グループ名</param>
+	/// <param name="position">発生位置</param>
+	/// <param name="count">発生数</param>
+	/// <returns>間引き後に実際に発生した数</returns>
+	uint32_t Emit(const std::string& groupName, const Vector3& position, uint32_t count);
+
+	/// <summary>
+	/// 更新(移動、寿命、行列計算、カリング)
+	/// </summary>
+	/// <param name="deltaTime">デルタタイム</param>
+	/// <param name="viewMatrix">ビュー行列</param>
+	/// <param name="projectionMatrix">射影行列</param>
+	/// <param name="cameraPosition">カメラ位置(距離による間引き用)</param>
+	void Update(float deltaTime, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition);
+
+	/// <summary>
+	/// 全パーティクルを消す
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// 乱数の初期化
+	/// </summary>
+	/// <param name="seed">乱数シード</param>
+	void Seed(uint32_t seed) { randomEngine_.seed(seed); }
+
+	/// <summary>
+	/// 決定論モードの切り替え
+	/// 有効にすると乱数をシードで初期化し、負荷による間引きを止める
+	/// 無効に戻すと有効にする前の乱数の状態に戻す
+	/// </summary>
+	/// <param name="enable">有効にするか</param>
+	/// <param name="seed">乱数シード</param>
+	void SetDeterministic(bool enable, uint32_t seed = 0);
+
+	/// <summary>
+	/// エミットの記録開始(残っているパーティクルは消し、決定論モードにする)
+	/// </summary>
+	/// <param name="seed">乱数シード</param>
+	void StartRecording(uint32_t seed);
+
+	/// <summary>
+	/// エミットの記録終了(記録前の決定論モードの状態に戻す)
+	/// </summary>
+	void StopRecording();
+
+	/// <summary>
+	/// 記録したエミットを新しいParticleSystemで再生し、フレームごとの更新時間とパーティクル数を出力する
+	/// 呼び出し元のシステムの状態には触れない
+	/// </summary>
+	/// <param name="log">エミット記録</param>
+	/// <param name="viewMatrix">ビュー行列</param>
+	/// <param name="projectionMatrix">射影行列</param>
+	/// <param name="cameraPosition">カメラ位置</param>
+	/// <param name="reportFilePath">結果の出力先(JSON)</param>
+	/// <returns>書き出せたか</returns>
+	static bool Replay(const ParticleEmitLog& log, const Matrix4x4& viewMatrix, const Matrix4x4& projectionMatrix, const Vector3& cameraPosition, const std::string& reportFilePath);
+
+public: // セッター
+
+	// 全グループ合計のパーティクル上限
+	void SetParticleBudget(uint32_t budget) { particleBudget_ = budget; }
+
+	// 更新処理にかけてよい時間(ミリ秒)
+	void SetUpdateTimeBudget(float milliseconds) { updateTimeBudgetMs_ = milliseconds; }
+
+	/// <summary>
+	/// 更新時間による負荷調整の有効化
+	/// 無効にすると負荷係数を1.0fに固定する(計測時間に左右されない)
+	/// </summary>
+	/// <param name="enable">有効にするか</param>
+	void SetAdaptiveLoad(bool enable);
+
+	/// <summary>
+	/// グループの優先度設定
+	/// </summary>
+	/// <param name="groupName">グループ名</param>
+	/// <param name="priority">優先度(0.0f:真っ先に間引く ～ 1.0f:間引かない)</param>
+	void SetGroupPriority(const std::string& groupName, float priority);
+
+	/// <summary>
+	/// 距離による間引きの範囲
+	/// </summary>
+	/// <param name="nearDistance">これより近いと距離による間引きなし</param>
+	/// <param name="farDistance">これより遠いと最大まで間引く</param>
+	void SetLodDistance(float nearDistance, float farDistance) { lodNearDistance_ = nearDistance; lodFarDistance_ = farDistance; }
+
+	// 視錐台カリングの有効化
+	void SetCulling(bool enable) { isCulling_ = enable; }
+
+public: // ゲッター
+
+	// グループ一覧
+	const std::unordered_map<std::string, Group>& GetGroups() const { return groups_; }
+
+	// グループ取得(無ければnullptr)
+	const Group* FindGroup(const std::string& name) const;
+
+	// 負荷係数(1.0f:通常 ～ kMinLoadScale_:最大まで間引き中)
+	float GetLoadScale() const { return loadScale_; }
+
+	// 生存中のパーティクル総数
+	uint32_t GetTotalParticleCount() const { return totalParticleCount_; }
+
+	// 描画するインスタンス総数
+	uint32_t GetTotalInstanceCount() const { return totalInstanceCount_; }
+
+	// 直近の更新時間(ミリ秒)
+	float GetUpdateTimeMs() const { return updateTimeMs_; }
+
+	// 決定論モードか
+	bool IsDeterministic() const { return isDeterministic_; }
+
+	// 決定論モードの固定デルタタイム
+	static float GetFixedDeltaTime() { return kFixedDeltaTime_; }
+
+	// 記録中か
+	bool IsRecording() const { return isRecording_; }
+
+	// 記録を始めてから更新したフレーム数
+	uint32_t GetRecordedFrameCount() const { return isRecording_ ? frameIndex_ - recordStartFrame_ : emitLog_.GetFrameCount(); }
+
+	// 記録したエミット
+	const ParticleEmitLog& GetEmitLog() const { return emitLog_; }
+
+	// 全体のパーティクル上限
+	uint32_t GetParticleBudget() const { return particleBudget_; }
+
+	// 更新時間の目標(ミリ秒)
+	float GetUpdateTimeBudget() const { return updateTimeBudgetMs_; }
+
+private:
+
+	/// <summary>
+	/// 負荷と距離から残す割合を求める
+	/// </summary>
+	/// <param name="group">グループ</param>
+	/// <param name="position">位置</param>
+	/// <returns>残す割合(0.0f～1.0f)</returns>
+	float CalculateKeepRate(const Group& group, const Vector3& position) const;
+
+	/// <summary>
+	/// 視錐台の中にあるか(ビュー空間の球で判定)
+	/// </summary>
+	/// <param name="viewPosition">ビュー空間の中心</param>
+	/// <param name="radius">半径</param>
+	/// <param name="projectionMatrix">射影行列</param>
+	/// <returns>見えるか</returns>
+	bool IsVisible(const Vector3& viewPosition, float radius, const Matrix4x4& projectionMatrix) const;
+
+	/// <summary>
+	/// 記録中ならグループを記録に残す
+	/// </summary>
+	/// <param name="name">グループ名</param>
+	/// <param name="group">グループ</param>
+	void RecordGroup(const std::string& name, const Group& group);
+
+private:
+
+	// 負荷係数の下限
+	static constexpr float kMinLoadScale_ = 0.25f;
+	// 間引き時に最低限残す割合
+	static constexpr float kMinKeepRate_ = 0.1f;
+	// スケールに対するカリング半径の倍率(メッシュの大きさの余裕)
+	static constexpr float kCullRadiusScale_ = 2.0f;
+	// 決定論モードの固定デルタタイム
+	static constexpr float kFixedDeltaTime_ = 1.0f / 60.0f;
+
+	std::unordered_map<std::string, Group> groups_;
+
+	// 乱数生成
+	std::mt19937 randomEngine_{ std::random_device{}() };
+	// 決定論モードにする前の乱数の状態
+	std::mt19937 savedRandomEngine_;
+
+	// ビルボード用の裏返し行列
+	Matrix4x4 backToFrontMatrix_ = MakeRotateYMatrix(std::numbers::pi_v<float>);
+
+	// 最後に更新したときのカメラ位置
+	Vector3 cameraPosition_ = { 0.0f,0.0f,0.0f };
+
+	// 全体のパーティクル上限
+	uint32_t particleBudget_ = 4096;
+	// 生存中のパーティクル総数
+	uint32_t totalParticleCount_ = 0;
+	// 描画するインスタンス総数
+	uint32_t totalInstanceCount_ = 0;
+	// 更新時間の目標(ミリ秒)
+	float updateTimeBudgetMs_ = 1.0f;
+	// 直近の更新時間(ミリ秒)
+	float updateTimeMs_ = 0.0f;
+	// 負荷係数
+	float loadScale_ = 1.0f;
+	bool isAdaptiveLoad_ = true;
+	// 距離による間引きの範囲
+	float lodNearDistance_ = 20.0f;
+	float lodFarDistance_ = 60.0f;
+	// 視錐台カリング
+	bool isCulling_ = true;
+
+	// 決定論モード
+	bool isDeterministic_ = false;
+	// 更新したフレーム数
+	uint32_t frameIndex_ = 0;
+
+	// エミット記録
+	ParticleEmitLog emitLog_;
+	bool isRecording_ = false;
+	uint32_t recordStartFrame_ = 0;
+	// 記録前に決定論モードだったか
+	bool wasDeterministic_ = false;
+};
@@ -59,27 +59,31 @@ void Skybox::Update()
 
 void Skybox::Draw()
 {
-	ID3D12GraphicsCommandList* cmdList = dxCommon_->GetCommandList().Get();
-
-	// パイプラインとルートシグネチャ設定
-	cmdList->SetGraphicsRootSignature(rootSignature_.Get());
-	cmdList->SetPipelineState(pipelineState_.Get());
-
-	// ルートパラメータ  定数バッファ b0（VS用）
-	cmdList->SetGraphicsRootConstantBufferView(0, constantBuffer_->GetGPUVirtualAddress());
-	cmdList->SetGraphicsRootConstantBufferView(1, materialBuffer_->GetGPUVirtualAddress());
-
-	// ルートパラメータ  SRV (CubeMap) をピクセルシェーダーに渡す（Descriptor Table）
-	D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = srvManager_->GetGPUDescriptorHandle(cubeMapSrvIndex_);
-	cmdList->SetGraphicsRootDescriptorTable(2, gpuHandle);
-
-	// 頂点・インデックスバッファ設定
-	cmdList->IASetVertexBuffers(0, 1, &vbView_);
-	cmdList->IASetIndexBuffer(&ibView_);
-	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-	// 描画呼び出し
-	cmdList->DrawIndexedInstanced(static_cast<UINT>(indexData_.size()), 1, 0, 0, 0);
+	// 他のものより先に描くように、一番下の層に積む
+	dxCommon_->GetRenderQueue().Submit(RenderQueue::MakeKey(RenderQueue::Layer::Background, 0, 0, 0, 0), [this]()
+		{
+			ID3D12GraphicsCommandList* cmdList = dxCommon_->GetCommandList().Get();
+
+			// パイプラインとルートシグネチャ設定
+			cmdList->SetGraphicsRootSignature(rootSignature_.Get());
+			cmdList->SetPipelineState(pipelineState_.Get());
+
+			// ルートパラメータ  定数バッファ b0（VS用）
+			cmdList->SetGraphicsRootConstantBufferView(0, constantBuffer_->GetGPUVirtualAddress());
+			cmdList->SetGraphicsRootConstantBufferView(1, materialBuffer_->GetGPUVirtualAddress());
+
+			// ルートパラメータ  SRV (CubeMap) をピクセルシェーダーに渡す（Descriptor Table）
+			D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = srvManager_->GetGPUDescriptorHandle(cubeMapSrvIndex_);
+			cmdList->SetGraphicsRootDescriptorTable(2, gpuHandle);
+
+			// 頂点・インデックスバッファ設定
+			cmdList->IASetVertexBuffers(0, 1, &vbView_);
+			cmdList->IASetIndexBuffer(&ibView_);
+			cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+			// 描画呼び出し
+			cmdList->DrawIndexedInstanced(static_cast<UINT>(indexData_.size()), 1, 0, 0, 0);
+		});
 }
 
 void Skybox::CreateBuffers()
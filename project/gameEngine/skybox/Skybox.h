@@ -38,7 +38,7 @@ public:
     void Finalize();
     // 更新
     void Update();
-    // 描画
+    // 描画(並べ替えの列のBackgroundの層に積む)
     void Draw();
 
 public: // セッター
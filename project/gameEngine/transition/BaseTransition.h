@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <cstdint>
 
 /// <summary>
 /// シーン切り替え時のトランジション処理を管理するための基底クラス
@@ -33,5 +34,10 @@ public: // ゲッター
 	// トランジションが終了したか
 	virtual bool IsFinished() const = 0;
 
+protected:
+
+	// スプライトを描く層(シーンのスプライトより手前に出す)
+	static const uint32_t kSpriteLayer = 1;
+
 };
 
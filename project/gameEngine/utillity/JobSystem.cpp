@@ -0,0 +1,169 @@
+#include "JobSystem.h"
+
+#include <Windows.h>
+#include <objbase.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// 常駐するワーカーと、今配っているジョブ
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	// ジョブが配られた、または終了するときに起こす
+	std::condition_variable wakeCondition;
+	// ワーカーがジョブを抜けたときに起こす
+	std::condition_variable doneCondition;
+	const std::function<void(size_t)>* currentJob = nullptr;
+	size_t jobCount = 0;
+	std::atomic<size_t> nextIndex = 0;
+	// ジョブを配るたびに進める(同じジョブを2回取らないため)
+	uint64_t generation = 0;
+	// ジョブを実行中のワーカー数
+	size_t busyWorkerCount = 0;
+	bool isStopping = false;
+
+	// ParallelForを同時に1つだけにする
+	std::mutex dispatchMutex;
+	// ワーカースレッドか(jobの中からのParallelForを判定する)
+	thread_local bool isWorkerThread = false;
+
+	// 空いた番号を取って実行する
+	void RunJobs(const std::function<void(size_t)>& job, size_t count)
+	{
+		for (size_t index = nextIndex++; index < count; index = nextIndex++)
+		{
+			job(index);
+		}
+	}
+
+	void WorkerMain()
+	{
+		isWorkerThread = true;
+		// WICなどCOMを使うジョブのために、スレッドごとに1回だけ初期化する
+		HRESULT coInitialize = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+		uint64_t seenGeneration = 0;
+		while (true)
+		{
+			const std::function<void(size_t)>* job = nullptr;
+			size_t count = 0;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wakeCondition.wait(lock, [&]() { return isStopping || generation != seenGeneration; });
+				if (isStopping)
+				{
+					break;
+				}
+				seenGeneration = generation;
+				// 起きるのが遅れて、もう終わったジョブなら何もしない
+				if (!currentJob)
+				{
+					continue;
+				}
+				job = currentJob;
+				count = jobCount;
+				++busyWorkerCount;
+			}
+
+			RunJobs(*job, count);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				--busyWorkerCount;
+			}
+			doneCondition.notify_all();
+		}
+
+		if (SUCCEEDED(coInitialize))
+		{
+			CoUninitialize();
+		}
+	}
+}
+
+namespace JobSystem
+{
+	void Initialize()
+	{
+		std::lock_guard<std::mutex> dispatchLock(dispatchMutex);
+		if (!workers.empty())
+		{
+			return;
+		}
+
+		isStopping = false;
+		const size_t workerCount = GetWorkerCount() - 1;
+		workers.reserve(workerCount);
+		for (size_t i = 0; i < workerCount; ++i)
+		{
+			workers.emplace_back(WorkerMain);
+		}
+	}
+
+	void Finalize()
+	{
+		std::lock_guard<std::mutex> dispatchLock(dispatchMutex);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isStopping = true;
+		}
+		wakeCondition.notify_all();
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+		workers.clear();
+	}
+
+	void ParallelFor(size_t count, const std::function<void(size_t)>& job)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (workers.empty())
+		{
+			Initialize();
+		}
+
+		// jobの中から呼ばれた、または別スレッドが配っている最中ならここで順に回す
+		std::unique_lock<std::mutex> dispatchLock(dispatchMutex, std::defer_lock);
+		if (isWorkerThread || count == 1 || workers.empty() || !dispatchLock.try_lock())
+		{
+			for (size_t index = 0; index < count; ++index)
+			{
+				job(index);
+			}
+			return;
+		}
+
+		// ワーカーにジョブを配る
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			currentJob = &job;
+			jobCount = count;
+			nextIndex = 0;
+			++generation;
+		}
+		wakeCondition.notify_all();
+
+		RunJobs(job, count);
+
+		// 番号は全て取られたので、実行中のワーカーが抜けるのを待ってからジョブを外す
+		std::unique_lock<std::mutex> lock(mutex);
+		doneCondition.wait(lock, []() { return busyWorkerCount == 0; });
+		currentJob = nullptr;
+		jobCount = 0;
+	}
+
+	size_t GetWorkerCount()
+	{
+		return std::max<size_t>(1, std::thread::hardware_concurrency());
+	}
+}
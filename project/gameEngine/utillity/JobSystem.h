@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+
+// 並列処理ユーティリティ
+// ワーカースレッドはInitializeで立ててFinalizeまで使い回す
+namespace JobSystem
+{
+	/// <summary>
+	/// ワーカースレッドを立てる(未初期化でParallelForを呼んだ場合もここで立てる)
+	/// 各ワーカーはCOMを1回だけ初期化しておく
+	/// </summary>
+	void Initialize();
+
+	/// <summary>
+	/// ワーカースレッドを止めて終了を待つ
+	/// </summary>
+	void Finalize();
+
+	/// <summary>
+	/// 0～count-1の番号でjobをワーカースレッドに分けて実行し、全て終わるまで待つ
+	/// 呼び出したスレッドもワーカーとして動く
+	/// 他のParallelForの実行中やjobの中から呼ばれた場合は呼び出したスレッドだけで実行する
+	/// </summary>
+	/// <param name="count">ジョブの数</param>
+	/// <param name="job">番号を受け取って処理する関数(スレッドセーフであること)</param>
+	void ParallelFor(size_t count, const std::function<void(size_t)>& job);
+
+	/// <summary>
+	/// 使用するワーカースレッド数(呼び出したスレッドを含む)
+	/// </summary>
+	/// <returns>スレッド数</returns>
+	size_t GetWorkerCount();
+}
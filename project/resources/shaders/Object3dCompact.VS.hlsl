@@ -0,0 +1,25 @@
+#include "Object3d.hlsli"
+#include "Object3dCompact.hlsli"
+
+struct TransformationMatrix
+{
+    float4x4 WVP;
+    float4x4 World;
+    float4x4 WorldInverseTranspose;
+};
+
+ConstantBuffer<TransformationMatrix> gTransformMatrix : register(b0);
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    float4 position = float4(gVertexDequant.positionMin + input.position.xyz * gVertexDequant.positionExtent, 1.0f);
+    float2 texcoord = gVertexDequant.texcoordMin + input.texcoord * gVertexDequant.texcoordExtent;
+    float3 normal = DecodeOctahedral(input.normal);
+
+    VertexShaderOutput output;
+    output.position = mul(position, gTransformMatrix.WVP);
+    output.texcoord = texcoord;
+    output.normal = normalize(mul(normal, (float3x3) gTransformMatrix.WorldInverseTranspose));
+    output.worldPosition = mul(position, gTransformMatrix.World).xyz;
+    return output;
+}
@@ -0,0 +1,27 @@
+// 量子化した頂点を元の範囲に戻すための値(メッシュごと)
+struct VertexDequant
+{
+    float3 positionMin;
+    float3 positionExtent;
+    float2 texcoordMin;
+    float2 texcoordExtent;
+};
+
+ConstantBuffer<VertexDequant> gVertexDequant : register(b1);
+
+struct VertexShaderInput
+{
+    float4 position : POSITION0; // 16bit UNORM (AABB内の位置)
+    float2 texcoord : TEXCOORD0; // 16bit UNORM (UVの範囲内の位置)
+    float2 normal : NORMAL0; // 16bit SNORM (八面体で2成分に詰めた法線)
+};
+
+// 八面体に詰めた法線を戻す
+float3 DecodeOctahedral(float2 e)
+{
+    float3 n = float3(e.x, e.y, 1.0f - abs(e.x) - abs(e.y));
+    float t = saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return normalize(n);
+}
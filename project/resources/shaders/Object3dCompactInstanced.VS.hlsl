@@ -0,0 +1,27 @@
+#include "Object3d.hlsli"
+#include "Object3dCompact.hlsli"
+
+struct TransformationMatrix
+{
+    float4x4 WVP;
+    float4x4 World;
+    float4x4 WorldInverseTranspose;
+};
+
+// インスタンスごとの座標変換行列(ピクセルシェーダーのテクスチャと番号が重ならないようにspace1に置く)
+StructuredBuffer<TransformationMatrix> gInstances : register(t0, space1);
+
+VertexShaderOutput main(VertexShaderInput input, uint instanceId : SV_InstanceID)
+{
+    TransformationMatrix transform = gInstances[instanceId];
+    float4 position = float4(gVertexDequant.positionMin + input.position.xyz * gVertexDequant.positionExtent, 1.0f);
+    float2 texcoord = gVertexDequant.texcoordMin + input.texcoord * gVertexDequant.texcoordExtent;
+    float3 normal = DecodeOctahedral(input.normal);
+
+    VertexShaderOutput output;
+    output.position = mul(position, transform.WVP);
+    output.texcoord = texcoord;
+    output.normal = normalize(mul(normal, (float3x3) transform.WorldInverseTranspose));
+    output.worldPosition = mul(position, transform.World).xyz;
+    return output;
+}
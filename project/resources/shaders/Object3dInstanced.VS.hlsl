@@ -0,0 +1,29 @@
+#include "Object3d.hlsli"
+
+struct TransformationMatrix
+{
+    float4x4 WVP;
+    float4x4 World;
+    float4x4 WorldInverseTranspose;
+};
+
+// インスタンスごとの座標変換行列(ピクセルシェーダーのテクスチャと番号が重ならないようにspace1に置く)
+StructuredBuffer<TransformationMatrix> gInstances : register(t0, space1);
+
+struct VertexShaderInput
+{
+    float4 position : POSITION0;
+    float2 texcoord : TEXCOORD0;
+    float3 normal : NORMAL0;
+};
+
+VertexShaderOutput main(VertexShaderInput input, uint instanceId : SV_InstanceID)
+{
+    TransformationMatrix transform = gInstances[instanceId];
+    VertexShaderOutput output;
+    output.position = mul(input.position, transform.WVP);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(input.normal, (float3x3) transform.WorldInverseTranspose));
+    output.worldPosition = mul(input.position, transform.World).xyz;
+    return output;
+}
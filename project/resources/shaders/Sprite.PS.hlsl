@@ -1,12 +1,5 @@
-#include "Object3d.hlsli"
+#include "Sprite.hlsli"
 
-struct Material
-{
-    float4 color;
-    float4x4 uvTransform;
-};
-
-ConstantBuffer<Material> gMaterial : register(b0);
 Texture2D<float4> gTexture : register(t0);
 SamplerState gSampler : register(s0);
 
@@ -18,10 +11,9 @@ struct PixelShaderOutput
 PixelShaderOutput main(VertexShaderOutput input)
 {
     PixelShaderOutput output;
-    float4 transformeduv = mul(float4(input.texcoord, 0.0f, 1.0f), gMaterial.uvTransform);
-    float4 textureColor = gTexture.Sample(gSampler, transformeduv.xy);
+    float4 textureColor = gTexture.Sample(gSampler, input.texcoord);
    
-    float4 color = gMaterial.color * textureColor;
+    float4 color = input.color * textureColor;
     color.rgb *= color.a; 
     output.color = color;
     
@@ -1,26 +1,19 @@
-#include "Object3d.hlsli"
-
-struct TransformationMatrix
-{
-    float4x4 WVP;
-    float4x4 World;
-};
-
-ConstantBuffer<TransformationMatrix> gTransformMatrix : register(b0);
+#include "Sprite.hlsli"
 
+// 頂点はSpriteBatchでクリップ座標まで変換済み
 struct VertexShaderInput
 {
     float4 position : POSITION0;
     float2 texcoord : TEXCOORD0;
-    float3 normal : NORMAL0;
+    float4 color : COLOR0;
 };
 
 VertexShaderOutput main(VertexShaderInput input)
 {
     VertexShaderOutput output;
-    output.position = mul(input.position, gTransformMatrix.WVP);
-    output.texcoord =input.texcoord;
-    output.normal = normalize(mul(input.normal, (float3x3) gTransformMatrix.World));
+    output.position = input.position;
+    output.texcoord = input.texcoord;
+    output.color = input.color;
     return output;
 }
 
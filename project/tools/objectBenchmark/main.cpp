@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "Object3dBenchmark.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: ObjectBenchmark [options]\n"
+			"  --objects <n>   オブジェクト数(既定: 500)\n"
+			"  --vertices <n>  1モデルの頂点数\n"
+			"  --nodes <n>     モデルのルート以外のノード数\n"
+			"  --moving <n>    毎フレーム動かすオブジェクトの割合(%%)\n"
+			"  --warmup <n>    計測前に回すフレーム数\n"
+			"  --frames <n>    計測するフレーム数\n"
+			"  --output <file> 結果の出力先(JSON)\n");
+	}
+
+	uint32_t ToUint(const std::string& text)
+	{
+		return static_cast<uint32_t>(std::strtoul(text.c_str(), nullptr, 10));
+	}
+}
+
+// 描画デバイスを作らずにObject3dの更新の行列計算とカリングだけを計測する
+int main(int argc, char* argv[])
+{
+	Object3dBenchmark::Setting setting;
+	std::string outputFilePath = "objectBenchmark.json";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--help" or option == "-h")
+		{
+			PrintUsage();
+			return 0;
+		}
+
+		// 以降のオプションは値を1つ取る
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "%s に値がありません\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+		const std::string value = argv[++i];
+
+		if (option == "--objects")
+		{
+			setting.objectCount = ToUint(value);
+		}
+		else if (option == "--vertices")
+		{
+			setting.vertexCount = ToUint(value);
+		}
+		else if (option == "--nodes")
+		{
+			setting.nodeCount = ToUint(value);
+		}
+		else if (option == "--moving")
+		{
+			setting.movingPercent = ToUint(value);
+		}
+		else if (option == "--warmup")
+		{
+			setting.warmupFrames = ToUint(value);
+		}
+		else if (option == "--frames")
+		{
+			setting.frames = ToUint(value);
+		}
+		else if (option == "--output")
+		{
+			outputFilePath = value;
+		}
+		else
+		{
+			std::fprintf(stderr, "不明なオプション: %s\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if (!Object3dBenchmark::Run(setting, outputFilePath))
+	{
+		std::fprintf(stderr, "計測に失敗しました(出力先を確認してください): %s\n", outputFilePath.c_str());
+		return 1;
+	}
+
+	std::printf("%s\n", outputFilePath.c_str());
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "ParticleBenchmark.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: ParticleBenchmark [options]\n"
+			"  --motion <name>[,<name>...]  計測するモーション(省略時は全モーション)\n"
+			"  --counts <n>[,<n>...]        計測する粒子数\n"
+			"  --warmup <n>                 計測前に回すフレーム数\n"
+			"  --frames <n>                 計測するフレーム数\n"
+			"  --seed <n>                   乱数シード\n"
+			"  --output <file>              結果の出力先(JSON)\n"
+			"  --replay <file>              計測の代わりにエミット記録を再生する\n");
+	}
+
+	// カンマ区切りを分割
+	std::vector<std::string> Split(const std::string& text)
+	{
+		std::vector<std::string> result;
+		std::stringstream stream(text);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			if (!item.empty())
+			{
+				result.push_back(item);
+			}
+		}
+		return result;
+	}
+
+	uint32_t ToUint(const std::string& text)
+	{
+		return static_cast<uint32_t>(std::strtoul(text.c_str(), nullptr, 10));
+	}
+}
+
+// 描画デバイスを作らずにParticleSystemだけを計測、再生する
+int main(int argc, char* argv[])
+{
+	ParticleBenchmark::Setting setting;
+	std::string outputFilePath;
+	std::string replayFilePath;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--help" or option == "-h")
+		{
+			PrintUsage();
+			return 0;
+		}
+
+		// 以降のオプションは値を1つ取る
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "%s に値がありません\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+		const std::string value = argv[++i];
+
+		if (option == "--motion")
+		{
+			setting.motionNames = Split(value);
+		}
+		else if (option == "--counts")
+		{
+			setting.particleCounts.clear();
+			for (const std::string& count : Split(value))
+			{
+				setting.particleCounts.push_back(ToUint(count));
+			}
+		}
+		else if (option == "--warmup")
+		{
+			setting.warmupFrames = ToUint(value);
+		}
+		else if (option == "--frames")
+		{
+			setting.frames = ToUint(value);
+		}
+		else if (option == "--seed")
+		{
+			setting.seed = ToUint(value);
+		}
+		else if (option == "--output")
+		{
+			outputFilePath = value;
+		}
+		else if (option == "--replay")
+		{
+			replayFilePath = value;
+		}
+		else
+		{
+			std::fprintf(stderr, "不明なオプション: %s\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// 記録の再生
+	if (!replayFilePath.empty())
+	{
+		if (outputFilePath.empty())
+		{
+			outputFilePath = "particleReplayReport.json";
+		}
+		if (!ParticleBenchmark::Replay(replayFilePath, outputFilePath))
+		{
+			std::fprintf(stderr, "再生に失敗しました(記録か出力先を確認してください): %s\n", replayFilePath.c_str());
+			return 1;
+		}
+
+		std::printf("%s\n", outputFilePath.c_str());
+		return 0;
+	}
+
+	if (outputFilePath.empty())
+	{
+		outputFilePath = "particleBenchmark.json";
+	}
+	if (!ParticleBenchmark::Run(setting, outputFilePath))
+	{
+		std::fprintf(stderr, "計測に失敗しました(モーション名か出力先を確認してください): %s\n", outputFilePath.c_str());
+		return 1;
+	}
+
+	std::printf("%s\n", outputFilePath.c_str());
+	return 0;
+}
@@ -0,0 +1,121 @@
+#include "FrustumCuller.h"
+
+#include "MyMath.h"
+
+#include <cmath>
+
+#include "TestCheck.h"
+
+namespace
+{
+	// 原点から+Zを向くカメラ(奥行き0.1から100)
+	// 距離10では上下に約2.3、左右に約4.1まで見える
+	Matrix4x4 MakeViewProjection()
+	{
+		return MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f);
+	}
+
+	// 各位置に大きさ1の箱を置いて判定する
+	void TestPlacement()
+	{
+		FrustumCuller culler;
+		const uint32_t front = culler.Register();
+		const uint32_t behind = culler.Register();
+		const uint32_t beside = culler.Register();
+		const uint32_t beyondFar = culler.Register();
+		const uint32_t straddling = culler.Register();
+		const uint32_t alwaysVisible = culler.Register();
+		TEST_CHECK(culler.GetRegisteredCount() == 6);
+
+		const Vector3 extent = { 1.0f, 1.0f, 1.0f };
+		culler.SetBounds(front, { 0.0f, 0.0f, 10.0f }, extent);
+		culler.SetBounds(behind, { 0.0f, 0.0f, -10.0f }, extent);
+		culler.SetBounds(beside, { 20.0f, 0.0f, 10.0f }, extent);
+		culler.SetBounds(beyondFar, { 0.0f, 0.0f, 150.0f }, extent);
+		// 右端(約4.1)を跨ぐ
+		culler.SetBounds(straddling, { 4.5f, 0.0f, 10.0f }, extent);
+		// 範囲を設定しても、常に見えている扱いに戻せる
+		culler.SetBounds(alwaysVisible, { 0.0f, 0.0f, -10.0f }, extent);
+		culler.SetAlwaysVisible(alwaysVisible);
+
+		culler.Cull(MakeViewProjection());
+		TEST_CHECK(culler.IsVisible(front));
+		TEST_CHECK(!culler.IsVisible(behind));
+		TEST_CHECK(!culler.IsVisible(beside));
+		TEST_CHECK(!culler.IsVisible(beyondFar));
+		TEST_CHECK(culler.IsVisible(straddling));
+		TEST_CHECK(culler.IsVisible(alwaysVisible));
+
+		const std::vector<uint32_t>& visibleIndices = culler.GetVisibleIndices();
+		TEST_CHECK(visibleIndices.size() == 3);
+		if (visibleIndices.size() == 3)
+		{
+			TEST_CHECK(visibleIndices[0] == front);
+			TEST_CHECK(visibleIndices[1] == straddling);
+			TEST_CHECK(visibleIndices[2] == alwaysVisible);
+		}
+	}
+
+	// 範囲を設定していない枠は見えている扱い、返した枠は見えない扱い
+	void TestRegisterAndUnregister()
+	{
+		FrustumCuller culler;
+		const uint32_t unbounded = culler.Register();
+		const uint32_t removed = culler.Register();
+		culler.SetBounds(removed, { 0.0f, 0.0f, 10.0f }, { 1.0f, 1.0f, 1.0f });
+		culler.Unregister(removed);
+		TEST_CHECK(culler.GetRegisteredCount() == 1);
+
+		culler.Cull(MakeViewProjection());
+		TEST_CHECK(culler.IsVisible(unbounded));
+		TEST_CHECK(culler.GetVisibleIndices().size() == 1);
+
+		// 返した枠は使い回される
+		TEST_CHECK(culler.Register() == removed);
+
+		// 枠を持っていないものは見えている扱い
+		TEST_CHECK(culler.IsVisible(FrustumCuller::kInvalidIndex));
+	}
+
+	// カメラが動けば判定も変わる
+	void TestMovedCamera()
+	{
+		FrustumCuller culler;
+		const uint32_t index = culler.Register();
+		culler.SetBounds(index, { 20.0f, 0.0f, 10.0f }, { 1.0f, 1.0f, 1.0f });
+
+		culler.Cull(MakeViewProjection());
+		TEST_CHECK(!culler.IsVisible(index));
+
+		const Matrix4x4 view = Inverse(MakeTranslateMatrix({ 20.0f, 0.0f, 0.0f }));
+		culler.Cull(Multiply(view, MakeViewProjection()));
+		TEST_CHECK(culler.IsVisible(index));
+	}
+
+	// 回転した箱は回転後の頂点を囲む大きさになる
+	void TestTransformBounds()
+	{
+		const Matrix4x4 world = MakeAffineMatrix({ 2.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 1.57079632f }, { 5.0f, 0.0f, 0.0f });
+		Vector3 center{};
+		Vector3 extent{};
+		FrustumCuller::TransformBounds({ -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f }, world, center, extent);
+
+		const float epsilon = 1.0e-4f;
+		TEST_CHECK(std::abs(center.x - 5.0f) < epsilon);
+		TEST_CHECK(std::abs(center.y) < epsilon);
+		TEST_CHECK(std::abs(center.z) < epsilon);
+		// X方向に2倍してからZ軸で90度回すので、Y方向に2の大きさになる
+		TEST_CHECK(std::abs(extent.x - 1.0f) < epsilon);
+		TEST_CHECK(std::abs(extent.y - 2.0f) < epsilon);
+		TEST_CHECK(std::abs(extent.z - 1.0f) < epsilon);
+	}
+}
+
+int main()
+{
+	TestPlacement();
+	TestRegisterAndUnregister();
+	TestMovedCamera();
+	TestTransformBounds();
+	return GetTestResult();
+}
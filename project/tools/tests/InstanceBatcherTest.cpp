@@ -0,0 +1,113 @@
+#include "InstanceBatcher.h"
+
+#include "TestCheck.h"
+
+namespace
+{
+	// モデルとオブジェクトは番地を比べるだけなので、中身の無いものを指す
+	int modelStorage[2];
+	int objectStorage[6];
+	Model* const kModelA = reinterpret_cast<Model*>(&modelStorage[0]);
+	Model* const kModelB = reinterpret_cast<Model*>(&modelStorage[1]);
+
+	const Object3d* GetObject(int index)
+	{
+		return reinterpret_cast<const Object3d*>(&objectStorage[index]);
+	}
+
+	// 積んだ順の番号をWVPの先頭に入れたインスタンス
+	InstanceBatcher::InstanceData MakeInstance(int index)
+	{
+		InstanceBatcher::InstanceData instance{};
+		instance.WVP.m[0][0] = static_cast<float>(index);
+		return instance;
+	}
+
+	int GetIndex(const InstanceBatcher::InstanceData& instance)
+	{
+		return static_cast<int>(instance.WVP.m[0][0]);
+	}
+
+	// モデルと詳細度の段の組ごとにまとまり、グループは最初に積まれた順に並ぶ
+	void TestGroupingAndOrder()
+	{
+		InstanceBatcher batcher;
+		batcher.Add(kModelA, 0, GetObject(0), MakeInstance(0));
+		batcher.Add(kModelB, 0, GetObject(1), MakeInstance(1));
+		batcher.Add(kModelA, 1, GetObject(2), MakeInstance(2));
+		batcher.Add(kModelA, 0, GetObject(3), MakeInstance(3));
+		batcher.Add(kModelB, 0, GetObject(4), MakeInstance(4));
+		batcher.Add(kModelA, 0, GetObject(5), MakeInstance(5));
+		TEST_CHECK(batcher.GetInstanceCount() == 6);
+		batcher.Build();
+
+		const std::vector<InstanceBatcher::Group>& groups = batcher.GetGroups();
+		TEST_CHECK(groups.size() == 3);
+		if (groups.size() != 3)
+		{
+			return;
+		}
+
+		TEST_CHECK(groups[0].model == kModelA && groups[0].lodIndex == 0);
+		TEST_CHECK(groups[0].firstObject == GetObject(0));
+		TEST_CHECK(groups[0].instanceStart == 0 && groups[0].instanceCount == 3);
+
+		TEST_CHECK(groups[1].model == kModelB && groups[1].lodIndex == 0);
+		TEST_CHECK(groups[1].firstObject == GetObject(1));
+		TEST_CHECK(groups[1].instanceStart == 3 && groups[1].instanceCount == 2);
+
+		// 同じモデルでも詳細度の段が違えば別のグループ
+		TEST_CHECK(groups[2].model == kModelA && groups[2].lodIndex == 1);
+		TEST_CHECK(groups[2].firstObject == GetObject(2));
+		TEST_CHECK(groups[2].instanceStart == 5 && groups[2].instanceCount == 1);
+
+		// グループ内は積まれた順のまま詰まっている
+		const std::vector<InstanceBatcher::InstanceData>& instances = batcher.GetInstances();
+		TEST_CHECK(instances.size() == 6);
+		const int expected[] = { 0, 3, 5, 1, 4, 2 };
+		for (size_t i = 0; i < instances.size() && i < 6; ++i)
+		{
+			TEST_CHECK(GetIndex(instances[i]) == expected[i]);
+		}
+	}
+
+	// Clearの後は前のフレームのものが残らない
+	void TestClear()
+	{
+		InstanceBatcher batcher;
+		batcher.Add(kModelA, 0, GetObject(0), MakeInstance(0));
+		batcher.Add(kModelB, 0, GetObject(1), MakeInstance(1));
+		batcher.Build();
+		batcher.Clear();
+		TEST_CHECK(batcher.GetInstanceCount() == 0);
+		TEST_CHECK(batcher.GetGroups().empty());
+		TEST_CHECK(batcher.GetInstances().empty());
+
+		batcher.Add(kModelB, 2, GetObject(2), MakeInstance(2));
+		batcher.Build();
+		TEST_CHECK(batcher.GetGroups().size() == 1);
+		TEST_CHECK(batcher.GetInstances().size() == 1);
+		if (batcher.GetGroups().size() == 1)
+		{
+			TEST_CHECK(batcher.GetGroups()[0].model == kModelB && batcher.GetGroups()[0].lodIndex == 2);
+			TEST_CHECK(batcher.GetGroups()[0].instanceStart == 0 && batcher.GetGroups()[0].instanceCount == 1);
+		}
+	}
+
+	// 何も積まなければグループも無い
+	void TestEmpty()
+	{
+		InstanceBatcher batcher;
+		batcher.Build();
+		TEST_CHECK(batcher.GetGroups().empty());
+		TEST_CHECK(batcher.GetInstances().empty());
+	}
+}
+
+int main()
+{
+	TestGroupingAndOrder();
+	TestClear();
+	TestEmpty();
+	return GetTestResult();
+}
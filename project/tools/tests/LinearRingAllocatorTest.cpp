@@ -0,0 +1,87 @@
+#include "LinearRingAllocator.h"
+
+#include "TestCheck.h"
+
+namespace
+{
+	// 終端に収まらない割り当ては残りを捨てて先頭に回り込む
+	void TestWrapAroundPadding()
+	{
+		LinearRingAllocator allocator;
+		allocator.Initialize(256);
+
+		TEST_CHECK(allocator.Allocate(200, 1) == 0);
+		allocator.FinishFrame(1);
+		allocator.Retire(1);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+
+		// 200から100は終端を越えるので先頭から。捨てた56バイトも使用中に数える
+		TEST_CHECK(allocator.Allocate(100, 1) == 0);
+		TEST_CHECK(allocator.GetUsedSize() == 156);
+
+		// 境界合わせ
+		TEST_CHECK(allocator.Allocate(10, 64) == 128);
+		TEST_CHECK(allocator.GetUsedSize() == 194);
+	}
+
+	// リングが埋まっている間は、GPUが使い終えるまで割り当てられない
+	void TestFullUntilRetire()
+	{
+		LinearRingAllocator allocator;
+		allocator.Initialize(256);
+
+		TEST_CHECK(allocator.Allocate(128, 16) == 0);
+		TEST_CHECK(allocator.Allocate(128, 16) == 128);
+		TEST_CHECK(allocator.Allocate(16, 16) == LinearRingAllocator::kInvalidOffset);
+		allocator.FinishFrame(5);
+
+		// 区切りのフェンスに届くまでは空かない
+		allocator.Retire(4);
+		TEST_CHECK(allocator.Allocate(16, 16) == LinearRingAllocator::kInvalidOffset);
+
+		allocator.Retire(5);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+		TEST_CHECK(allocator.Allocate(16, 16) == 0);
+	}
+
+	// 割り当てのないフレームは区切らない
+	void TestFinishFrameWithoutAllocation()
+	{
+		LinearRingAllocator allocator;
+		allocator.Initialize(256);
+
+		allocator.FinishFrame(1);
+		allocator.Retire(1);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+
+		TEST_CHECK(allocator.Allocate(64, 16) == 0);
+		allocator.FinishFrame(2);
+		// 何も割り当てていないので区切りは増えず、2を越えた時点で全部空く
+		allocator.FinishFrame(3);
+		allocator.Retire(2);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+		allocator.Retire(3);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+	}
+
+	// リングより大きいものは割り当てず、状態も変えない
+	void TestLargerThanCapacity()
+	{
+		LinearRingAllocator allocator;
+		allocator.Initialize(256);
+
+		TEST_CHECK(allocator.Allocate(257, 1) == LinearRingAllocator::kInvalidOffset);
+		TEST_CHECK(allocator.GetUsedSize() == 0);
+		TEST_CHECK(allocator.Allocate(256, 1) == 0);
+		TEST_CHECK(allocator.GetUsedSize() == 256);
+	}
+}
+
+int main()
+{
+	TestWrapAroundPadding();
+	TestFullUntilRetire();
+	TestFinishFrameWithoutAllocation();
+	TestLargerThanCapacity();
+	return GetTestResult();
+}
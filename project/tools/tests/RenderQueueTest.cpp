@@ -0,0 +1,111 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+#include "TestCheck.h"
+
+namespace
+{
+	// キーの各欄が上位から 層・パイプライン・マテリアル・テクスチャ・深度 の順に詰まる
+	void TestMakeKey()
+	{
+		const uint64_t key = RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0x5, 0x1234, 0xABCD, 0x00FEDC);
+		const uint64_t expected =
+			(uint64_t(1) << 60) | (uint64_t(0x5) << 56) | (uint64_t(0x1234) << 40) | (uint64_t(0xABCD) << 24) | uint64_t(0x00FEDC);
+		TEST_CHECK(key == expected);
+
+		// 半透明の層は深度が層のすぐ下に来る
+		const uint64_t transparentKey = RenderQueue::MakeKey(RenderQueue::Layer::Transparent, 0x5, 0x1234, 0xABCD, 0x00FEDC);
+		const uint64_t transparentExpected =
+			(uint64_t(2) << 60) | (uint64_t(0x00FEDC) << 36) | (uint64_t(0x5) << 32) | (uint64_t(0x1234) << 16) | uint64_t(0xABCD);
+		TEST_CHECK(transparentKey == transparentExpected);
+		TEST_CHECK(RenderQueue::MakeKey(RenderQueue::Layer::Transparent, 0xF, 0xFFFF, 0xFFFF, 1) <
+			RenderQueue::MakeKey(RenderQueue::Layer::Transparent, 0, 0, 0, 2));
+
+		// 幅に収まらない分は隣の欄にはみ出さない
+		const uint64_t truncated = RenderQueue::MakeKey(RenderQueue::Layer::Background, 0x13, 0x12345, 0x1ABCD, 0x1FFFFFF);
+		TEST_CHECK(truncated == ((uint64_t(0x3) << 56) | (uint64_t(0x2345) << 40) | (uint64_t(0xABCD) << 24) | uint64_t(0xFFFFFF)));
+
+		// 層が違えば他の欄に関係なく層の順になる
+		TEST_CHECK(RenderQueue::MakeKey(RenderQueue::Layer::Background, 0xF, 0xFFFF, 0xFFFF, 0xFFFFFF) <
+			RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0, 0, 0, 0));
+		TEST_CHECK(RenderQueue::MakeKey(RenderQueue::Layer::Transparent, 0xF, 0xFFFF, 0xFFFF, 0xFFFFFF) <
+			RenderQueue::MakeKey(RenderQueue::Layer::Particle, 0, 0, 0, 0));
+		TEST_CHECK(RenderQueue::MakeKey(RenderQueue::Layer::Particle, 0xF, 0xFFFF, 0xFFFF, 0xFFFFFF) <
+			RenderQueue::MakeKey(RenderQueue::Layer::Overlay, 0, 0, 0, 0));
+	}
+
+	// 深度は0から欄の最大値に収まり、奥から描くときは向きが逆になる
+	void TestQuantizeDepth()
+	{
+		const uint32_t maxValue = (1u << RenderQueue::kDepthBits) - 1;
+		TEST_CHECK(RenderQueue::QuantizeDepth(0.0f, 100.0f) == 0);
+		TEST_CHECK(RenderQueue::QuantizeDepth(-5.0f, 100.0f) == 0);
+		TEST_CHECK(RenderQueue::QuantizeDepth(100.0f, 100.0f) == maxValue);
+		TEST_CHECK(RenderQueue::QuantizeDepth(1000.0f, 100.0f) == maxValue);
+		TEST_CHECK(RenderQueue::QuantizeDepth(25.0f, 100.0f) < RenderQueue::QuantizeDepth(50.0f, 100.0f));
+
+		TEST_CHECK(RenderQueue::QuantizeDepth(0.0f, 100.0f, true) == maxValue);
+		TEST_CHECK(RenderQueue::QuantizeDepth(-5.0f, 100.0f, true) == maxValue);
+		TEST_CHECK(RenderQueue::QuantizeDepth(1000.0f, 100.0f, true) == 0);
+		TEST_CHECK(RenderQueue::QuantizeDepth(25.0f, 100.0f, true) > RenderQueue::QuantizeDepth(50.0f, 100.0f, true));
+	}
+
+	// 基数ソートの並びがstd::stable_sortと一致する(同じキーは積んだ順のまま)
+	void TestStableOrder()
+	{
+		std::mt19937_64 random(12345);
+		RenderQueue queue;
+		std::vector<uint64_t> keys;
+
+		// 同じキーが何度も出るように、各欄を狭い範囲から選ぶ
+		for (uint32_t i = 0; i < 2000; ++i)
+		{
+			const RenderQueue::Layer layer = static_cast<RenderQueue::Layer>(random() % 5);
+			const uint64_t key = RenderQueue::MakeKey(layer,
+				static_cast<uint32_t>(random() % 3), static_cast<uint32_t>(random() % 5),
+				static_cast<uint32_t>(random() % 4), static_cast<uint32_t>(random() % 8) * 0x10101);
+			keys.push_back(key);
+			queue.Submit(key, nullptr);
+		}
+		queue.Sort();
+
+		std::vector<uint32_t> expectedOrder(keys.size());
+		std::iota(expectedOrder.begin(), expectedOrder.end(), 0u);
+		std::stable_sort(expectedOrder.begin(), expectedOrder.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		TEST_CHECK(queue.GetSortedOrder() == expectedOrder);
+		TEST_CHECK(queue.GetSortedKeys().size() == keys.size());
+		TEST_CHECK(std::is_sorted(queue.GetSortedKeys().begin(), queue.GetSortedKeys().end()));
+	}
+
+	// 実行は並べた順で、終わったら空になる
+	void TestExecute()
+	{
+		RenderQueue queue;
+		std::vector<int> executed;
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::Layer::Overlay, 0, 0, 0, 0), [&executed]() { executed.push_back(0); });
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0, 0, 0, 5), [&executed]() { executed.push_back(1); });
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0, 0, 0, 1), [&executed]() { executed.push_back(2); });
+		queue.Submit(RenderQueue::MakeKey(RenderQueue::Layer::Opaque, 0, 0, 0, 1), [&executed]() { executed.push_back(3); });
+		queue.Execute();
+
+		TEST_CHECK((executed == std::vector<int>{ 2, 3, 1, 0 }));
+		TEST_CHECK(queue.GetCount() == 0);
+
+		// 空のまま実行しても何も起きない
+		queue.Execute();
+		TEST_CHECK(executed.size() == 4);
+	}
+}
+
+int main()
+{
+	TestMakeKey();
+	TestQuantizeDepth();
+	TestStableOrder();
+	TestExecute();
+	return GetTestResult();
+}
@@ -0,0 +1,98 @@
+#include "SpriteBatch.h"
+
+#include "TestCheck.h"
+
+namespace
+{
+	// 見分けるための番号を左下の頂点のxに入れた四角形
+	void AddQuad(SpriteBatch& batch, uint32_t layer, uint32_t textureIndex, float tag)
+	{
+		SpriteBatch::Vertex vertices[SpriteBatch::kVerticesPerQuad]{};
+		vertices[0].position = { tag,0.0f,0.0f,1.0f };
+		batch.Add(layer, textureIndex, vertices);
+	}
+
+	// 並べた後のquadIndex番目の四角形の番号
+	float GetTag(const SpriteBatch& batch, uint32_t quadIndex)
+	{
+		return batch.GetVertices()[quadIndex * SpriteBatch::kVerticesPerQuad].position.x;
+	}
+
+	bool IsRun(const SpriteBatch::Run& run, uint32_t textureIndex, uint32_t quadStart, uint32_t quadCount)
+	{
+		return run.textureIndex == textureIndex and run.quadStart == quadStart and run.quadCount == quadCount;
+	}
+
+	// 同じ層で重なっているテクスチャの違うものは、テクスチャの番号に関係なく積んだ順に描く
+	void TestSameLayerKeepsOrder()
+	{
+		SpriteBatch batch;
+		AddQuad(batch, 0, 5, 1.0f);
+		AddQuad(batch, 0, 2, 2.0f);
+		batch.Build();
+
+		TEST_CHECK(batch.GetVertices().size() == 2 * SpriteBatch::kVerticesPerQuad);
+		TEST_CHECK(GetTag(batch, 0) == 1.0f);
+		TEST_CHECK(GetTag(batch, 1) == 2.0f);
+		TEST_CHECK(batch.GetRuns().size() == 2);
+		TEST_CHECK(IsRun(batch.GetRuns()[0], 5, 0, 1));
+		TEST_CHECK(IsRun(batch.GetRuns()[1], 2, 1, 1));
+	}
+
+	// 続けて積んだ同じテクスチャのものだけ1つの区間にまとめる
+	void TestAdjacentSameTextureMerges()
+	{
+		SpriteBatch batch;
+		AddQuad(batch, 0, 3, 1.0f);
+		AddQuad(batch, 0, 3, 2.0f);
+		AddQuad(batch, 0, 4, 3.0f);
+		AddQuad(batch, 0, 3, 4.0f);
+		batch.Build();
+
+		TEST_CHECK(batch.GetRuns().size() == 3);
+		TEST_CHECK(IsRun(batch.GetRuns()[0], 3, 0, 2));
+		TEST_CHECK(IsRun(batch.GetRuns()[1], 4, 2, 1));
+		TEST_CHECK(IsRun(batch.GetRuns()[2], 3, 3, 1));
+		TEST_CHECK(GetTag(batch, 3) == 4.0f);
+	}
+
+	// 層は小さいものから描き、同じ層の中は積んだ順のまま
+	void TestLayerOrder()
+	{
+		SpriteBatch batch;
+		AddQuad(batch, 1, 1, 1.0f);
+		AddQuad(batch, 0, 2, 2.0f);
+		AddQuad(batch, 1, 1, 3.0f);
+		batch.Build();
+
+		TEST_CHECK(GetTag(batch, 0) == 2.0f);
+		TEST_CHECK(GetTag(batch, 1) == 1.0f);
+		TEST_CHECK(GetTag(batch, 2) == 3.0f);
+		TEST_CHECK(batch.GetRuns().size() == 2);
+		TEST_CHECK(IsRun(batch.GetRuns()[0], 2, 0, 1));
+		TEST_CHECK(IsRun(batch.GetRuns()[1], 1, 1, 2));
+	}
+
+	// 捨てた後は前のフレームのものが残らない
+	void TestClear()
+	{
+		SpriteBatch batch;
+		AddQuad(batch, 0, 1, 1.0f);
+		batch.Build();
+		batch.Clear();
+		TEST_CHECK(batch.GetQuadCount() == 0);
+
+		batch.Build();
+		TEST_CHECK(batch.GetVertices().empty());
+		TEST_CHECK(batch.GetRuns().empty());
+	}
+}
+
+int main()
+{
+	TestSameLayerKeepsOrder();
+	TestAdjacentSameTextureMerges();
+	TestLayerOrder();
+	TestClear();
+	return GetTestResult();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdio>
+
+// テスト用の確認処理(失敗したら場所を出して数える)
+
+// 失敗した確認の数
+inline int& GetTestFailureCount()
+{
+	static int count = 0;
+	return count;
+}
+
+// 条件が偽なら失敗として数える
+#define TEST_CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: 失敗: %s\n", __FILE__, __LINE__, #condition); \
+			++GetTestFailureCount(); \
+		} \
+	} while (false)
+
+// mainの戻り値(失敗があれば1)
+inline int GetTestResult()
+{
+	if (GetTestFailureCount() > 0)
+	{
+		std::fprintf(stderr, "%d 件失敗\n", GetTestFailureCount());
+		return 1;
+	}
+	return 0;
+}
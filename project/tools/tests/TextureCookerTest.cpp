@@ -0,0 +1,106 @@
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "TextureCooker.h"
+
+#include "TestCheck.h"
+
+namespace
+{
+	// 不透明な8x8の画像はBC1(sRGB)に圧縮され、1x1までのミップマップが付く
+	void TestCookOpaqueImage(const std::string& sourceFilePath)
+	{
+		TEST_CHECK(!TextureCooker::IsUpToDate(sourceFilePath));
+		TEST_CHECK(TextureCooker::Cook(sourceFilePath, true));
+		TEST_CHECK(std::filesystem::exists(TextureCooker::GetCookedFilePath(sourceFilePath)));
+
+		// ハッシュファイルは識別子から始まる
+		char magic[4]{};
+		std::ifstream hashFile(TextureCooker::GetHashFilePath(sourceFilePath), std::ios::binary);
+		TEST_CHECK(hashFile.read(magic, sizeof(magic)).good());
+		TEST_CHECK(std::memcmp(magic, "TXCK", sizeof(magic)) == 0);
+
+		TEST_CHECK(TextureCooker::IsUpToDate(sourceFilePath));
+		DirectX::ScratchImage image{};
+		TEST_CHECK(TextureCooker::Load(sourceFilePath, image));
+		const DirectX::TexMetadata& metadata = image.GetMetadata();
+		TEST_CHECK(metadata.width == 8 and metadata.height == 8);
+		TEST_CHECK(metadata.mipLevels == 4);
+		TEST_CHECK(metadata.format == DXGI_FORMAT_BC1_UNORM_SRGB);
+	}
+
+	// 圧縮しない指定ならRGBA8(sRGB)のまま書き出す
+	void TestCookUncompressed(const std::string& sourceFilePath)
+	{
+		TEST_CHECK(TextureCooker::Cook(sourceFilePath, false));
+		DirectX::ScratchImage image{};
+		TEST_CHECK(TextureCooker::Load(sourceFilePath, image));
+		TEST_CHECK(image.GetMetadata().format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+		TEST_CHECK(image.GetMetadata().mipLevels == 4);
+	}
+
+	// 元ファイルが変われば変換済みのものは使わない
+	void TestSourceModified(const std::string& sourceFilePath)
+	{
+		TEST_CHECK(TextureCooker::IsUpToDate(sourceFilePath));
+		{
+			std::ofstream file(sourceFilePath, std::ios::binary | std::ios::app);
+			file.put('\0');
+		}
+		TEST_CHECK(!TextureCooker::IsUpToDate(sourceFilePath));
+		DirectX::ScratchImage image{};
+		TEST_CHECK(!TextureCooker::Load(sourceFilePath, image));
+	}
+
+	// 読めないファイルは書き出さない
+	void TestCookMissingFile(const std::string& workDirectory)
+	{
+		const std::string missingFilePath = workDirectory + "/missing.png";
+		TEST_CHECK(!TextureCooker::Cook(missingFilePath, true));
+		TEST_CHECK(!std::filesystem::exists(TextureCooker::GetCookedFilePath(missingFilePath)));
+	}
+}
+
+// 引数: 元の画像(不透明な8x8のpng) 作業ディレクトリ
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		std::fprintf(stderr, "usage: TextureCookerTest <source.png> <workDirectory>\n");
+		return 1;
+	}
+
+	// 元の画像の隣に書き出すので、作業ディレクトリに写してから変換する
+	const std::string workDirectory = argv[2];
+	std::filesystem::remove_all(workDirectory);
+	std::filesystem::create_directories(workDirectory);
+	const std::string sourceFilePath = workDirectory + "/opaque8x8.png";
+	std::filesystem::copy_file(argv[1], sourceFilePath);
+
+#ifdef _WIN32
+	// WICでの読み込みに使う
+	if (FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED)))
+	{
+		std::fprintf(stderr, "COMの初期化に失敗しました\n");
+		return 1;
+	}
+#endif
+
+	TestCookOpaqueImage(sourceFilePath);
+	TestCookUncompressed(sourceFilePath);
+	TestSourceModified(sourceFilePath);
+	TestCookMissingFile(workDirectory);
+
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+
+	return GetTestResult();
+}
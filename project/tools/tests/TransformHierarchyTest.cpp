@@ -0,0 +1,113 @@
+#include "TransformHierarchy.h"
+
+#include "Vector3.h"
+
+#include <cmath>
+
+#include "TestCheck.h"
+
+namespace
+{
+	// ワールド行列の平行移動の成分が一致するか
+	bool IsTranslation(const Matrix4x4& matrix, const Vector3& translate)
+	{
+		const float epsilon = 1.0e-5f;
+		return std::abs(matrix.m[3][0] - translate.x) < epsilon &&
+			std::abs(matrix.m[3][1] - translate.y) < epsilon &&
+			std::abs(matrix.m[3][2] - translate.z) < epsilon;
+	}
+
+	// 2本の木(0-1-2 と 3-4)を作って1回伝播しておく
+	void BuildForest(TransformHierarchy& hierarchy, uint32_t (&nodes)[5])
+	{
+		nodes[0] = hierarchy.AddNode(TransformHierarchy::kNoParent, Matrix4x4::TranslateMatrix({ 1.0f, 0.0f, 0.0f }));
+		nodes[1] = hierarchy.AddNode(static_cast<int32_t>(nodes[0]), Matrix4x4::TranslateMatrix({ 0.0f, 2.0f, 0.0f }));
+		nodes[2] = hierarchy.AddNode(static_cast<int32_t>(nodes[1]), Matrix4x4::TranslateMatrix({ 0.0f, 0.0f, 3.0f }));
+		nodes[3] = hierarchy.AddNode(TransformHierarchy::kNoParent, Matrix4x4::TranslateMatrix({ 10.0f, 0.0f, 0.0f }));
+		nodes[4] = hierarchy.AddNode(static_cast<int32_t>(nodes[3]), Matrix4x4::TranslateMatrix({ 0.0f, 10.0f, 0.0f }));
+		hierarchy.Propagate();
+	}
+
+	// 足したノードは最初の伝播ですべて作られる
+	void TestInitialPropagate()
+	{
+		TransformHierarchy hierarchy;
+		uint32_t nodes[5];
+		BuildForest(hierarchy, nodes);
+
+		TEST_CHECK(hierarchy.GetNodeCount() == 5);
+		for (uint32_t node : nodes)
+		{
+			TEST_CHECK(hierarchy.IsChanged(node));
+		}
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[0]), { 1.0f, 0.0f, 0.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[1]), { 1.0f, 2.0f, 0.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[2]), { 1.0f, 2.0f, 3.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[3]), { 10.0f, 0.0f, 0.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[4]), { 10.0f, 10.0f, 0.0f }));
+	}
+
+	// 途中のノードを動かすと、そのノードと子孫だけ作り直される
+	void TestPartialSubtree()
+	{
+		TransformHierarchy hierarchy;
+		uint32_t nodes[5];
+		BuildForest(hierarchy, nodes);
+
+		hierarchy.SetLocalMatrix(nodes[1], Matrix4x4::TranslateMatrix({ 0.0f, 5.0f, 0.0f }));
+		TEST_CHECK(hierarchy.Propagate());
+
+		TEST_CHECK(!hierarchy.IsChanged(nodes[0]));
+		TEST_CHECK(hierarchy.IsChanged(nodes[1]));
+		TEST_CHECK(hierarchy.IsChanged(nodes[2]));
+		TEST_CHECK(!hierarchy.IsChanged(nodes[3]));
+		TEST_CHECK(!hierarchy.IsChanged(nodes[4]));
+
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[0]), { 1.0f, 0.0f, 0.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[1]), { 1.0f, 5.0f, 0.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[2]), { 1.0f, 5.0f, 3.0f }));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[4]), { 10.0f, 10.0f, 0.0f }));
+	}
+
+	// 何も変わっていなければ作り直さず、前回の印も消える
+	void TestNoOpClearsChanged()
+	{
+		TransformHierarchy hierarchy;
+		uint32_t nodes[5];
+		BuildForest(hierarchy, nodes);
+
+		TEST_CHECK(!hierarchy.Propagate());
+		for (uint32_t node : nodes)
+		{
+			TEST_CHECK(!hierarchy.IsChanged(node));
+		}
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(nodes[2]), { 1.0f, 2.0f, 3.0f }));
+
+		// 続けて呼んでも変わらない
+		TEST_CHECK(!hierarchy.Propagate());
+		TEST_CHECK(!hierarchy.IsChanged(nodes[0]));
+	}
+
+	// 後から足した子は、親を動かさなくても親のワールド行列に付く
+	void TestAddAfterPropagate()
+	{
+		TransformHierarchy hierarchy;
+		uint32_t nodes[5];
+		BuildForest(hierarchy, nodes);
+
+		const uint32_t added = hierarchy.AddNode(static_cast<int32_t>(nodes[4]), Matrix4x4::TranslateMatrix({ 0.0f, 0.0f, 1.0f }));
+		TEST_CHECK(hierarchy.Propagate());
+		TEST_CHECK(hierarchy.IsChanged(added));
+		TEST_CHECK(!hierarchy.IsChanged(nodes[4]));
+		TEST_CHECK(IsTranslation(hierarchy.GetWorldMatrix(added), { 10.0f, 10.0f, 1.0f }));
+	}
+}
+
+int main()
+{
+	TestInitialPropagate();
+	TestPartialSubtree();
+	TestNoOpClearsChanged();
+	TestAddAfterPropagate();
+	return GetTestResult();
+}
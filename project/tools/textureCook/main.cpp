@@ -0,0 +1,161 @@
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+#include "json/json.hpp"
+
+#include "TextureCooker.h"
+
+namespace
+{
+	void PrintUsage()
+	{
+		std::printf(
+			"usage: TextureCook [options]\n"
+			"  --root <dir>     変換する画像のディレクトリ(既定: resources/images)\n"
+			"  --config <file>  圧縮しない画像の一覧(既定: resources/configs/textureCook.json)\n"
+			"  --force          変換済みでも書き出し直す\n");
+	}
+
+	// 変換する画像の拡張子か
+	bool IsSourceImage(const std::filesystem::path& filePath)
+	{
+		std::string extension = filePath.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return extension == ".png" or extension == ".jpg" or extension == ".jpeg" or extension == ".bmp";
+	}
+
+	// 圧縮しない画像のファイル名を読む(UIのように劣化が目立つもの)
+	std::unordered_set<std::string> LoadUncompressedFileNames(const std::string& configFilePath)
+	{
+		std::unordered_set<std::string> fileNames;
+		std::ifstream file(configFilePath);
+		if (file.fail())
+		{
+			std::fprintf(stderr, "設定がありません(全て圧縮します): %s\n", configFilePath.c_str());
+			return fileNames;
+		}
+
+		nlohmann::json json;
+		file >> json;
+		for (const std::string& fileName : json.value("uncompressed", std::vector<std::string>{}))
+		{
+			fileNames.insert(fileName);
+		}
+		return fileNames;
+	}
+}
+
+// 画像をミップマップ付きのDDSに変換し、元ファイルの隣に書き出す
+// ゲームは書き出したものだけを読み、無ければ元の画像を読む
+int main(int argc, char* argv[])
+{
+	std::string rootDirectory = "resources/images";
+	std::string configFilePath = "resources/configs/textureCook.json";
+	bool isForced = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--help" or option == "-h")
+		{
+			PrintUsage();
+			return 0;
+		}
+		if (option == "--force")
+		{
+			isForced = true;
+			continue;
+		}
+
+		// 以降のオプションは値を1つ取る
+		if (i + 1 >= argc)
+		{
+			std::fprintf(stderr, "%s に値がありません\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+		const std::string value = argv[++i];
+
+		if (option == "--root")
+		{
+			rootDirectory = value;
+		}
+		else if (option == "--config")
+		{
+			configFilePath = value;
+		}
+		else
+		{
+			std::fprintf(stderr, "不明なオプション: %s\n", option.c_str());
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	std::error_code ec;
+	if (!std::filesystem::is_directory(rootDirectory, ec))
+	{
+		std::fprintf(stderr, "ディレクトリがありません: %s\n", rootDirectory.c_str());
+		return 1;
+	}
+
+#ifdef _WIN32
+	// WICでの読み込みに使う
+	HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	if (FAILED(hr))
+	{
+		std::fprintf(stderr, "COMの初期化に失敗しました\n");
+		return 1;
+	}
+#endif
+
+	const std::unordered_set<std::string> uncompressedFileNames = LoadUncompressedFileNames(configFilePath);
+
+	uint32_t cookedCount = 0;
+	uint32_t skippedCount = 0;
+	uint32_t failedCount = 0;
+	for (const auto& entry : std::filesystem::recursive_directory_iterator(rootDirectory))
+	{
+		if (!entry.is_regular_file() or !IsSourceImage(entry.path()))
+		{
+			continue;
+		}
+
+		// ゲームはパスを'/'区切りで渡すので、書き出すファイル名もそれに合わせる
+		const std::string sourceFilePath = entry.path().generic_string();
+		if (!isForced and TextureCooker::IsUpToDate(sourceFilePath))
+		{
+			++skippedCount;
+			continue;
+		}
+
+		const bool useCompression = !uncompressedFileNames.contains(entry.path().filename().string());
+		if (TextureCooker::Cook(sourceFilePath, useCompression))
+		{
+			std::printf("%s%s\n", sourceFilePath.c_str(), useCompression ? "" : " (uncompressed)");
+			++cookedCount;
+		}
+		else
+		{
+			std::fprintf(stderr, "変換に失敗しました: %s\n", sourceFilePath.c_str());
+			++failedCount;
+		}
+	}
+
+#ifdef _WIN32
+	CoUninitialize();
+#endif
+
+	std::printf("cooked %u, up to date %u, failed %u\n", cookedCount, skippedCount, failedCount);
+	return failedCount > 0 ? 1 : 0;
+}